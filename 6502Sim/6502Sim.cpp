@@ -6,14 +6,21 @@
 #include <shobjidl.h> //needed for File Open Dialog Box, I think
 #include "6502Sim.h"
 #include "Processor.h" 
+#include "MemoryDump.h"
+#include "RunController.h"
+#include "SharedState.h"
 #include <string> // stl string class, needed for converting windows string to standard c string
 #include <locale>
 #include <codecvt>
+#include <vector>
 
 //Ideally, these would probably be in the Resources.h file, but that file is also tied to windows and stuff and I'd rather not mess with it
 #define MAX_LOADSTRING 100
 #define DEF_WIN_WIDTH  425
 #define DEF_WIN_HEIGHT 600
+#define REFRESH_TIMER_ID 1 //timer that refreshes the readouts while the processor is running
+#define REFRESH_TIMER_MS 50
+#define SHARED_STATE_NAME "6502Sim" //name monitors (tools/ShmMonitor) open the shared mapping by
 
 // Global Variables:
 HINSTANCE hInst;                                // current instance
@@ -22,9 +29,17 @@ WCHAR szWindowClass[MAX_LOADSTRING];            // the main window class name
 
 //I'm going to make this a global variable for now, as I'm going to be initialize it in the wWinMain so that it is available to the 
 Processor* emu_cpu = nullptr; //initialized to null ptr for safety
+RunController* run_controller = nullptr; //runs emu_cpu on a worker thread, so emu_cpu itself should only be touched while the controller is paused
+SharedState shared_state; //emu_cpu's memory and a register page, mapped so other processes can watch the emulator run
 
 const char* filepath;
 
+//the text shown in the RAM viewer, kept between steps so only the parts of memory that changed have to be converted again
+wchar_t* ram_text = nullptr;
+unsigned int ram_text_size = 0;
+unsigned long long ram_text_sequence = 0; //sequence of the last published state the RAM text was brought up to date with
+std::vector<MemoryRange> ram_changes; //reused every refresh to avoid allocating
+
 // Forward declarations of functions included in this code module:
 ATOM                MyRegisterClass(HINSTANCE hInstance);
 BOOL                InitInstance(HINSTANCE, int);
@@ -33,15 +48,8 @@ INT_PTR CALLBACK    About(HWND, UINT, WPARAM, LPARAM);
 INT_PTR CALLBACK    ResetDialog(HWND, UINT, WPARAM, LPARAM);
 INT_PTR CALLBACK    TestDialog(HWND, UINT, WPARAM, LPARAM);
 void                ConvertToBinString(unsigned char value, wchar_t* output);
-void                ReadMemoryContents(bool ramRom, unsigned int memSize, wchar_t* output);
-
-union addr_breaker {
-    struct {
-        unsigned char high : 8;
-        unsigned char low : 8;
-    };
-    short full;
-};
+void                UpdateRamText(const PublishedState& state);
+void                RefreshDisplay(HWND hWnd);
 
 /*
    Controls Declarations
@@ -77,6 +85,7 @@ HWND rom_viewer;
 
 //the button control for 
 HWND step_button;
+HWND run_button;
 
 //labels for everything
 HWND a_label;
@@ -104,7 +113,21 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     // TODO: Place code here.
 
     //Likely this is where the backend code will be initialized and stuff (IE, where our processor class and such will be instantiated and prepared
-    emu_cpu = new Processor(); //using default instatiation for now
+    //the same 2K RAM and ROM as the default instantiation, but living in the shared mapping, if the mapping can't be made (another instance has the name) just go without it
+    if (shared_state.create(SHARED_STATE_NAME, 2048, 2048))
+    {
+        emu_cpu = new Processor(2048, shared_state.ram_storage(), 2048, shared_state.rom_storage());
+    }
+    else
+    {
+        emu_cpu = new Processor(); //using default instatiation for now
+    }
+    run_controller = new RunController(emu_cpu);
+    if (shared_state.is_open())
+    {
+        run_controller->attach_shared(&shared_state);
+    }
+    run_controller->start(); //starts out paused, the STEP and RUN buttons drive it
 
     // Initialize global strings
     LoadStringW(hInstance, IDS_APP_TITLE, szTitle, MAX_LOADSTRING);
@@ -131,6 +154,11 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         }
     }
 
+    run_controller->stop();
+    delete run_controller;
+    delete emu_cpu;
+    shared_state.close();
+
     return (int) msg.wParam;
 }
 
@@ -248,6 +276,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
         step_button = CreateWindow(L"BUTTON", L"STEP", WS_TABSTOP | WS_CHILD | WS_VISIBLE | BS_DEFPUSHBUTTON | WS_DISABLED, 150, 210, 80, 40, hWnd, (HMENU)ID_STEPBUTTON, (HINSTANCE)GetWindowLongPtr(hWnd, GWLP_HINSTANCE), NULL); // not entirely sure what the longPtr does, but This should create a button that does things
 
+        run_button = CreateWindow(L"BUTTON", L"RUN", WS_TABSTOP | WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | WS_DISABLED, 240, 210, 80, 40, hWnd, (HMENU)ID_RUNBUTTON, (HINSTANCE)GetWindowLongPtr(hWnd, GWLP_HINSTANCE), NULL);
+
         //Initialize RAM/ROM Viewers
             
         } 
@@ -266,6 +296,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 break;
             case ID_FILE_OPENFILE:
             {
+                //the worker thread has to be stopped before the processor can be touched
+                KillTimer(hWnd, REFRESH_TIMER_ID);
+                SetWindowText(run_button, L"RUN");
+                run_controller->pause();
+
                 //do file opening stuff, which did take some time to actually find in the documentation, as there appears to be a ton of outdated/different information on opening files, this is the one I think I can use for my project https://docs.microsoft.com/en-us/windows/win32/learnwin32/example--the-open-dialog-box it is based on this example for the most part, and I'll be using the PWSTR for 
                 //Note, I'm actually going to use c++'s main file opening procedure, as I'm much more familiar with it (and my processor class deals with unsigned chars, rather than any Windows data types, so I should be fine using fstream or something similar to get 8 bit data and convert, the windows dialog is mainly to get the file path that I'll be using
 
@@ -291,9 +326,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
                             //attempt to load file
                             emu_cpu->load_program(filepath);
+                            run_controller->step(0); //republish so the readouts pick up the loaded program
 
-                            //finally, enable the step button
+                            //finally, enable the step and run buttons
                             EnableWindow(step_button, true);
+                            EnableWindow(run_button, true);
                             CoTaskMemFree(file_path);
                             pItem->Release();
                         }
@@ -302,12 +339,13 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 }
                 CoUninitialize();
 
-                //set the rom text
-                wchar_t* romstring = new wchar_t[(emu_cpu->get_rom_size() * 8) + emu_cpu->get_rom_size()];
-                for (int i = 0; i < (emu_cpu->get_rom_size() * 8) + emu_cpu->get_rom_size(); i++) {
-                    romstring[i] = L' ';
-                }
-                ReadMemoryContents(false, emu_cpu->get_rom_size(), romstring);
+                //set the rom text (the controller is paused at this point), the whole ROM is copied out in one block and rendered from the copy
+                unsigned int rom_size = emu_cpu->get_rom_size();
+                std::vector<unsigned char> rom_copy(rom_size);
+                emu_cpu->copy_rom(rom_copy.data(), 0, rom_size);
+                wchar_t* romstring = new wchar_t[(rom_size * MemoryDump<wchar_t>::cell_width(DUMP_BINARY)) + 1];
+                MemoryDump<wchar_t>::render_bytes(rom_copy.data(), rom_size, DUMP_BINARY, romstring);
+                romstring[rom_size * MemoryDump<wchar_t>::cell_width(DUMP_BINARY)] = L'\0';
                 SetWindowText(rom_viewer, romstring);
                 delete[] romstring; //clear memory
 
@@ -315,103 +353,46 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 break;
             case ID_FILE_RESETPROCESSOR:
                 //bring up dialog box for resetting the processor
+                KillTimer(hWnd, REFRESH_TIMER_ID);
+                SetWindowText(run_button, L"RUN");
+                run_controller->pause();
                 DialogBox(hInst, MAKEINTRESOURCE(IDD_RESETDIALOG), hWnd, ResetDialog);
+                run_controller->step(0);
+                RefreshDisplay(hWnd);
                 break;
-            case ID_STEPBUTTON: {
+            case ID_STEPBUTTON:
                 //do button stuff here
                 //DialogBox(hInst, MAKEINTRESOURCE(IDD_TESTDIALOG), hWnd, TestDialog); //button testing procedure, actual processing to follow
-                //perform STEP function on processor
-                emu_cpu->step();
-
-                //declare variables for new lables (wchar_t's to avoid problems)
-                wchar_t* accString = new wchar_t[8];
-                wchar_t* xString = new wchar_t[8];
-                wchar_t* yString = new wchar_t[8];
-                wchar_t* pchString = new wchar_t[8];
-                wchar_t* pclString = new wchar_t[8];
-                wchar_t* flgString = new wchar_t[8];
-                wchar_t* outString = new wchar_t[8];
-                wchar_t* spString = new wchar_t[8];
-                wchar_t* ramValues = new wchar_t[(emu_cpu->get_ram_size() * 8) + emu_cpu->get_ram_size()]; //uninitialized, as the function initializes it
-
-                //initialize variables with default values of 0x00 (in string form)
-                for (int i = 0; i < 8; i++) {
-                    accString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    xString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    yString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    pchString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    pclString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    flgString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    outString[i] = L'0';
-                }
-                for (int i = 0; i < 8; i++) {
-                    spString[i] = L'0';
+                //perform STEP function on processor, through the run controller (this pauses it first if it was running)
+                KillTimer(hWnd, REFRESH_TIMER_ID);
+                SetWindowText(run_button, L"RUN");
+                run_controller->step(1);
+                RefreshDisplay(hWnd);
+                break;
+            case ID_RUNBUTTON:
+                //toggle continuous running, the worker thread does the running and the timer picks up what it publishes
+                if (run_controller->is_running()) {
+                    run_controller->pause();
+                    KillTimer(hWnd, REFRESH_TIMER_ID);
+                    SetWindowText(run_button, L"RUN");
+                    RefreshDisplay(hWnd);
                 }
-                for (int i = 0; i < (emu_cpu->get_ram_size() * 8) + emu_cpu->get_ram_size(); i++) {
-                    ramValues[i] = L' ';
+                else {
+                    run_controller->resume();
+                    SetTimer(hWnd, REFRESH_TIMER_ID, REFRESH_TIMER_MS, NULL);
+                    SetWindowText(run_button, L"PAUSE");
                 }
-
-                //convert the values of the unsigned chars to our bitstrings
-                ConvertToBinString(emu_cpu->get_accumulator(), accString);
-                ConvertToBinString(emu_cpu->get_x(), xString);
-                ConvertToBinString(emu_cpu->get_y(), yString);
-                ConvertToBinString(emu_cpu->get_pc_high(), pchString);
-                ConvertToBinString(emu_cpu->get_pc_low(), pclString);
-                ConvertToBinString(emu_cpu->get_sp(), spString);
-                ConvertToBinString(emu_cpu->get_output(), outString);
-                ConvertToBinString(emu_cpu->get_sflags(), flgString);
-
-                //update controls 
-                SetWindowText(a_reg_readout, accString);
-                SetWindowText(x_reg_readout, xString);
-                SetWindowText(y_reg_readout, yString);
-                SetWindowText(sp_reg_readout, spString);
-                SetWindowText(pch_readout, pchString);
-                SetWindowText(pcl_readout, pclString);
-                SetWindowText(output_readout, outString);
-
-                //set flags
-                SetWindowText(f_n_readout, flgString[0] + L" ");
-                SetWindowText(f_v_readout, flgString[1] + L" ");
-                SetWindowText(f_b_readout, flgString[3] + L" ");
-                SetWindowText(f_d_readout, flgString[4] + L" ");
-                SetWindowText(f_i_readout, flgString[5] + L" ");
-                SetWindowText(f_z_readout, flgString[6] + L" ");
-                SetWindowText(f_c_readout, flgString[7] + L" ");
-                
-                //RAM viewing updating
-                ReadMemoryContents(true, emu_cpu->get_ram_size(), ramValues);
-                SetWindowText(ram_viewer, ramValues);
-                
-                //delete the variables used
-                delete[] accString;
-                delete[] xString;
-                delete[] yString;
-                delete[] pchString;
-                delete[] pclString;
-                delete[] spString;
-                delete[] outString;
-                delete[] flgString;
-                delete[] ramValues;
-            }
                 break;
             default:
                 return DefWindowProc(hWnd, message, wParam, lParam);
             }
         }
         break;
+    case WM_TIMER:
+        if (wParam == REFRESH_TIMER_ID) {
+            RefreshDisplay(hWnd);
+        }
+        break;
     case WM_PAINT:
         {
             PAINTSTRUCT ps;
@@ -500,43 +481,129 @@ INT_PTR CALLBACK TestDialog(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 
 /// <summary>
 /// Function for converting the unsigned char data from the Processor class to a string of 0's and 1's for output on the screen
-/// Some help from https://stackoverflow.com/questions/8584577/access-bits-in-a-char-in-c, with regards to iterating through bits in char
+/// the digits come out of MemoryDump's lookup table, so this is a single copy rather than a loop over the bits
 /// </summary>
 /// <param name="value">unsigned char value to be used </param>
 /// <returns></returns>
 void ConvertToBinString(unsigned char value, wchar_t* output) {
-    char binValue[8] = { '0','0','0','0','0','0','0','0'};
-    for (int i = 7; i > -1; i--) {
-        if (value >> i & 1) {
-            binValue[i] = '1';
-            output[7 - i] = L'1';
-        }
-        else {
-            output[7 - i] = L'0';
-        }
+    MemoryDump<wchar_t>::format_byte(value, DUMP_BINARY, output);
+}
+
+/// <summary>
+/// Updates the readouts from the latest state the run controller published, the published copy is read without locking, so this is safe to call while the processor is running
+/// once the processor stops (paused or jammed) the refresh timer is stopped as well
+/// </summary>
+void RefreshDisplay(HWND hWnd) {
+    const PublishedState& state = run_controller->read();
+    if (state.mode == RUN_PAUSED) {
+        KillTimer(hWnd, REFRESH_TIMER_ID);
+        SetWindowText(run_button, L"RUN");
+    }
+
+    //declare variables for new lables (wchar_t's to avoid problems)
+    wchar_t* accString = new wchar_t[8];
+    wchar_t* xString = new wchar_t[8];
+    wchar_t* yString = new wchar_t[8];
+    wchar_t* pchString = new wchar_t[8];
+    wchar_t* pclString = new wchar_t[8];
+    wchar_t* flgString = new wchar_t[8];
+    wchar_t* outString = new wchar_t[8];
+    wchar_t* spString = new wchar_t[8];
+
+    //initialize variables with default values of 0x00 (in string form)
+    for (int i = 0; i < 8; i++) {
+        accString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        xString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        yString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        pchString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        pclString[i] = L'0';
     }
+    for (int i = 0; i < 8; i++) {
+        flgString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        outString[i] = L'0';
+    }
+    for (int i = 0; i < 8; i++) {
+        spString[i] = L'0';
+    }
+
+    //convert the values of the unsigned chars to our bitstrings
+    ConvertToBinString(state.a, accString);
+    ConvertToBinString(state.x, xString);
+    ConvertToBinString(state.y, yString);
+    ConvertToBinString(state.pc_high, pchString);
+    ConvertToBinString(state.pc_low, pclString);
+    ConvertToBinString(state.sp, spString);
+    ConvertToBinString(state.output, outString);
+    ConvertToBinString(state.sflags, flgString);
+
+    //update controls 
+    SetWindowText(a_reg_readout, accString);
+    SetWindowText(x_reg_readout, xString);
+    SetWindowText(y_reg_readout, yString);
+    SetWindowText(sp_reg_readout, spString);
+    SetWindowText(pch_readout, pchString);
+    SetWindowText(pcl_readout, pclString);
+    SetWindowText(output_readout, outString);
+
+    //set flags
+    SetWindowText(f_n_readout, flgString[0] + L" ");
+    SetWindowText(f_v_readout, flgString[1] + L" ");
+    SetWindowText(f_b_readout, flgString[3] + L" ");
+    SetWindowText(f_d_readout, flgString[4] + L" ");
+    SetWindowText(f_i_readout, flgString[5] + L" ");
+    SetWindowText(f_z_readout, flgString[6] + L" ");
+    SetWindowText(f_c_readout, flgString[7] + L" ");
+    
+    //RAM viewing updating, only redone for the pages that were written to
+    UpdateRamText(state);
+    
+    //delete the variables used
+    delete[] accString;
+    delete[] xString;
+    delete[] yString;
+    delete[] pchString;
+    delete[] pclString;
+    delete[] spString;
+    delete[] outString;
+    delete[] flgString;
 }
 
-void ReadMemoryContents(bool ramRom, unsigned int memSize, wchar_t* output) {
-    //variables needed for either or
-    unsigned int totalChars = (memSize * 8) + memSize; //enough for 8 bits per address and one space
-    unsigned int wCharTracker = 0;
-    addr_breaker addr;
-    addr.full = 0x0000; //set the address to full
-    if (ramRom == true) {
-        //operate on the RAM
-        for (unsigned int i = 0; i < memSize; i++) {
-            ConvertToBinString(emu_cpu->get_ram_value(addr.high, addr.low), &output[wCharTracker]); //hopefully passing the address of + wcharTracker will work 
-            addr.full++; //increment the full value of addr
-            wCharTracker += 9;
+/// <summary>
+/// Brings the RAM viewer up to date from a published state, only the pages written to since the last update get converted again (a step usually touches one byte, or none)
+/// and the control is only updated if something changed at all
+/// </summary>
+void UpdateRamText(const PublishedState& state) {
+    unsigned int ram_size = (unsigned int)state.ram.size();
+    unsigned int size = ram_size * MemoryDump<wchar_t>::cell_width(DUMP_BINARY);
+    if (ram_text == nullptr || ram_text_size != size) {
+        delete[] ram_text;
+        ram_text = new wchar_t[size + 1]; //one extra for the terminator SetWindowText needs
+        ram_text_size = size;
+        for (unsigned int i = 0; i < size; i++) {
+            ram_text[i] = L' ';
         }
+        ram_text[size] = L'\0';
+        ram_text_sequence = 0; //new buffer, so everything needs converting
     }
-    else {
-        //operate on the ROM
-        for (unsigned int i = 0; i < memSize; i++) {
-            ConvertToBinString(emu_cpu->get_rom_value(addr.high, addr.low), &output[wCharTracker]); //hopefully passing the address of + wcharTracker will work
-            addr.full++; //increment the full value of addr
-            wCharTracker += 9;
-        }
+
+    state.get_changes(ram_text_sequence, ram_changes);
+    ram_text_sequence = state.sequence;
+    if (ram_changes.empty()) {
+        return;
+    }
+    for (size_t r = 0; r < ram_changes.size(); r++) {
+        unsigned int start = ram_changes[r].start;
+        MemoryDump<wchar_t>::render_bytes(&state.ram[start], ram_changes[r].length, DUMP_BINARY, &ram_text[start * MemoryDump<wchar_t>::cell_width(DUMP_BINARY)]);
     }
+    SetWindowText(ram_viewer, ram_text);
 }
\ No newline at end of file
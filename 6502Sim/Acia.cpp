@@ -0,0 +1,314 @@
+#include "Acia.h"
+#include <chrono>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <Windows.h>
+#define acia_read _read
+#define acia_write _write
+#define acia_close _close
+#define acia_open _open
+#else
+#include <poll.h>
+#include <unistd.h>
+#define acia_read ::read
+#define acia_write ::write
+#define acia_close ::close
+#define acia_open ::open
+#endif
+
+/// <summary>
+/// Default constructor, the ACIA comes up like the chip does after a hardware reset, nothing attached on the host side
+/// </summary>
+Acia::Acia() : _tx_dropped(0), _running(false), _input_eof(false) {
+	_command = 0x02; //receiver interrupts disabled at reset
+	_control = 0x00;
+	_last_rx = 0x00;
+	_in_fd = -1;
+	_out_fd = -1;
+	_owns_fds = false;
+}
+
+Acia::~Acia() {
+	detach();
+}
+
+/// <summary>
+/// Register reads from the CPU, none of these ever block, they only look at the ring buffers
+/// </summary>
+/// <param name="reg">register number, only the low two bits are decoded</param>
+/// <returns></returns>
+unsigned char Acia::read(unsigned char reg) {
+	switch (reg & 0x03) {
+	case ACIA_DATA:
+		_rx.pop(_last_rx); //if nothing is waiting, the old value stays in the latch
+		return _last_rx;
+	case ACIA_STATUS: {
+		//DCD and DSR read as 0, which is "connected" on the 6551, and the error bits never get set since the host thread stops reading when the receive buffer is full instead of overrunning it
+		unsigned char status = 0x00;
+		if (!_rx.empty()) {
+			status |= STATUS_RDRF;
+		}
+		if (!_tx.full()) {
+			status |= STATUS_TDRE;
+		}
+		if (irq_pending()) {
+			status |= STATUS_IRQ;
+		}
+		return status;
+	}
+	case ACIA_COMMAND:
+		return _command;
+	default:
+		return _control;
+	}
+}
+
+/// <summary>
+/// Register writes from the CPU, a transmit with a full buffer drops the byte (the guest is supposed to poll TDRE first, same as on the real part)
+/// </summary>
+/// <param name="reg">register number, only the low two bits are decoded</param>
+/// <param name="value"></param>
+void Acia::write(unsigned char reg, unsigned char value) {
+	switch (reg & 0x03) {
+	case ACIA_DATA:
+		if (!_tx.push(value)) {
+			_tx_dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		break;
+	case ACIA_STATUS:
+		//a write to the status register is a programmed reset, which clears the low 5 bits of the command register
+		_command &= 0xE0;
+		_command |= 0x02;
+		break;
+	case ACIA_COMMAND:
+		_command = value;
+		break;
+	default:
+		_control = value;
+		break;
+	}
+}
+
+/// <summary>
+/// Start the host thread on a pair of already open file descriptors (0 and 1 for stdin/stdout), the ACIA does not take ownership of these
+/// </summary>
+/// <param name="in_fd">descriptor received data comes from, -1 for none</param>
+/// <param name="out_fd">descriptor transmitted data goes to, -1 for none</param>
+/// <returns>false if a host thread is already running</returns>
+bool Acia::attach(int in_fd, int out_fd) {
+	if (_running.load()) {
+		return false;
+	}
+	_in_fd = in_fd;
+	_out_fd = out_fd;
+	_input_eof.store(in_fd < 0);
+	_running.store(true);
+	_host_thread = std::thread(&Acia::host_loop, this);
+	return true;
+}
+
+/// <summary>
+/// Open the given paths and attach to them, the output file is truncated, a pipe (named fifo) works here as well
+/// </summary>
+/// <param name="in_path">path to read received data from, or nullptr</param>
+/// <param name="out_path">path to write transmitted data to, or nullptr</param>
+/// <returns>false if either file couldn't be opened or a host thread is already running</returns>
+bool Acia::attach_files(const char* in_path, const char* out_path) {
+	if (_running.load()) {
+		return false;
+	}
+	int in_fd = -1;
+	int out_fd = -1;
+#ifdef _WIN32
+	const int binary = _O_BINARY;
+#else
+	const int binary = 0;
+#endif
+	if (in_path != nullptr) {
+		in_fd = acia_open(in_path, O_RDONLY | binary);
+		if (in_fd < 0) {
+			return false;
+		}
+	}
+	if (out_path != nullptr) {
+		out_fd = acia_open(out_path, O_WRONLY | O_CREAT | O_TRUNC | binary, 0644);
+		if (out_fd < 0) {
+			if (in_fd >= 0) {
+				acia_close(in_fd);
+			}
+			return false;
+		}
+	}
+	_owns_fds = true; //set before the host thread starts, so it never sees the descriptors as borrowed
+	attach(in_fd, out_fd);
+	return true;
+}
+
+/// <summary>
+/// Stop the host thread and wait for it, anything the guest already transmitted gets written out before this returns
+/// </summary>
+void Acia::detach() {
+	if (!_running.exchange(false)) {
+		return;
+	}
+	if (_host_thread.joinable()) {
+#ifdef _WIN32
+		//input_ready only lets the thread read when a read won't block, but a console can still hand it a partial line, so knock it out of any read it's stuck in
+		CancelSynchronousIo((HANDLE)_host_thread.native_handle());
+#endif
+		_host_thread.join();
+	}
+	flush_tx();
+	if (_owns_fds) {
+		if (_in_fd >= 0) {
+			acia_close(_in_fd);
+		}
+		if (_out_fd >= 0) {
+			acia_close(_out_fd);
+		}
+	}
+	_in_fd = -1;
+	_out_fd = -1;
+	_owns_fds = false;
+}
+
+/// <summary>
+/// Write everything currently in the transmit buffer to the output descriptor, in blocks
+/// </summary>
+void Acia::flush_tx() {
+	unsigned char block[BUFFER_SIZE];
+	unsigned int count;
+	while ((count = _tx.pop(block, BUFFER_SIZE)) > 0) {
+		if (_out_fd < 0) {
+			continue; //nothing attached, the data is just discarded
+		}
+		unsigned int written = 0;
+		while (written < count) {
+			int result = acia_write(_out_fd, block + written, count - written);
+			if (result <= 0) {
+				return; //output closed on us, nothing more we can do
+			}
+			written += result;
+		}
+	}
+}
+
+/// <summary>
+/// Wait up to a millisecond for the input descriptor to have something to read, so the host thread never sits in a read that detach can't interrupt
+/// On Windows the handles of consoles, pipes and files are always signaled, so waiting on them says nothing, each kind has to be asked in its own way instead
+/// </summary>
+/// <returns>true when a read won't block (which includes end of file and errors, the read then reports those)</returns>
+bool Acia::input_ready() {
+#ifdef _WIN32
+	HANDLE handle = (HANDLE)_get_osfhandle(_in_fd);
+	bool ready = true;
+	switch (GetFileType(handle)) {
+	case FILE_TYPE_PIPE: {
+		DWORD available = 0;
+		if (PeekNamedPipe(handle, nullptr, 0, nullptr, &available, nullptr)) {
+			ready = available > 0;
+		} //a failed peek means the writer went away, the read returns 0 for that
+		break;
+	}
+	case FILE_TYPE_CHAR: {
+		//the console queue also holds key releases, mouse and focus events that _read skips over, so only count a pressed key with a character
+		//and with line input on (the default) _read doesn't return until enter, so wait for that
+		DWORD mode = 0;
+		bool line_input = GetConsoleMode(handle, &mode) && (mode & ENABLE_LINE_INPUT) != 0;
+		INPUT_RECORD events[64];
+		DWORD count = 0;
+		ready = false;
+		if (PeekConsoleInput(handle, events, 64, &count)) {
+			for (DWORD i = 0; i < count && !ready; i++) {
+				const KEY_EVENT_RECORD& key = events[i].Event.KeyEvent;
+				if (events[i].EventType == KEY_EVENT && key.bKeyDown && key.uChar.AsciiChar != 0) {
+					ready = !line_input || key.uChar.AsciiChar == '\r';
+				}
+			}
+		}
+		break;
+	}
+	default:
+		break; //disk files never block
+	}
+	if (!ready) {
+		Sleep(1);
+	}
+	return ready;
+#else
+	pollfd pfd;
+	pfd.fd = _in_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 1) > 0;
+#endif
+}
+
+/// <summary>
+/// The host thread, it drains the transmit buffer and fills the receive buffer until detach is called
+/// it waits on the input descriptor with a short timeout rather than blocking on it, so it notices detach quickly and sits idle (not spinning) when nothing is happening
+/// </summary>
+void Acia::host_loop() {
+	unsigned char block[BUFFER_SIZE];
+	while (_running.load(std::memory_order_acquire)) {
+		flush_tx();
+
+		unsigned int space = BUFFER_SIZE - _rx.size();
+		if (_input_eof.load() || space == 0) {
+			//nothing to read right now, just wait a bit for the guest to transmit or catch up on what it has received
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		if (!input_ready()) {
+			continue;
+		}
+
+		int count = acia_read(_in_fd, block, space);
+		if (count <= 0) {
+			_input_eof.store(true);
+			continue;
+		}
+		_rx.push(block, (unsigned int)count);
+	}
+}
+
+/// <summary>
+/// Queue bytes for the guest to receive, the host thread is the receive buffer's only producer while it runs, so this refuses to add a second one
+/// </summary>
+/// <returns>number of bytes queued, 0 while a host thread is attached</returns>
+unsigned int Acia::send(const unsigned char* data, unsigned int count) {
+	if (_running.load()) {
+		return 0;
+	}
+	return _rx.push(data, count);
+}
+
+/// <summary>
+/// Take bytes the guest has transmitted, the host thread is the transmit buffer's only consumer while it runs, so this refuses to add a second one
+/// </summary>
+/// <returns>number of bytes taken, 0 while a host thread is attached</returns>
+unsigned int Acia::receive(unsigned char* data, unsigned int count) {
+	if (_running.load()) {
+		return 0;
+	}
+	return _tx.pop(data, count);
+}
+
+/// <summary>
+/// The receiver interrupt is enabled when bit 1 of the command register is clear (and DTR, bit 0, is set)
+/// </summary>
+/// <returns></returns>
+bool Acia::irq_pending() {
+	return (_command & 0x03) == 0x01 && !_rx.empty();
+}
+
+bool Acia::input_eof() {
+	return _input_eof.load();
+}
+
+unsigned long long Acia::get_tx_dropped() {
+	return _tx_dropped.load();
+}
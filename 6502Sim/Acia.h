@@ -0,0 +1,73 @@
+#pragma once
+#include "IoDevice.h"
+#include "RingBuffer.h"
+#include <atomic>
+#include <thread>
+
+/// <summary>
+/// Enum for the four registers of the 6551 ACIA, the low two address bits select the register (the rest of the page mirrors them)
+/// </summary>
+enum ACIA_REGISTERS {
+	ACIA_DATA = 0, ACIA_STATUS = 1, ACIA_COMMAND = 2, ACIA_CONTROL = 3
+};
+
+/// <summary>
+/// A 6551 style ACIA (serial port) for the emulated machine
+/// Reference: http://archive.6502.org/datasheets/mos_6551_acia.pdf for the register layout and status bits
+/// The transmit and receive registers are backed by lock free ring buffers, the CPU side only ever touches the buffers (so polling loops in the guest never wait on the host),
+/// and a host thread moves data between the buffers and a pair of file descriptors (stdin/stdout, a file or a pipe), a whole block per read/write call rather than one call per byte
+/// </summary>
+class Acia : public IoDevice
+{
+public:
+	static const unsigned int BUFFER_SIZE = 4096; //size of each ring buffer, also the largest block the host thread moves in a single call
+
+	//status register bits, as laid out on the real chip
+	static const unsigned char STATUS_PARITY = 0x01;
+	static const unsigned char STATUS_FRAMING = 0x02;
+	static const unsigned char STATUS_OVERRUN = 0x04;
+	static const unsigned char STATUS_RDRF = 0x08; //receive data register full
+	static const unsigned char STATUS_TDRE = 0x10; //transmit data register empty
+	static const unsigned char STATUS_IRQ = 0x80;
+
+private:
+	RingBuffer<BUFFER_SIZE> _tx; //guest -> host
+	RingBuffer<BUFFER_SIZE> _rx; //host -> guest
+
+	unsigned char _command;
+	unsigned char _control;
+	unsigned char _last_rx; //value returned when the data register is read with nothing received, the real chip just hands back the old latch
+	std::atomic<unsigned long long> _tx_dropped; //bytes written by the guest while the transmit buffer was full
+
+	//host side
+	int _in_fd;
+	int _out_fd;
+	bool _owns_fds; //true when the descriptors were opened by attach_files, so they get closed on detach
+	std::atomic<bool> _running;
+	std::atomic<bool> _input_eof;
+	std::thread _host_thread;
+
+	void host_loop();
+	bool input_ready();
+	void flush_tx();
+
+public:
+	Acia();
+	~Acia();
+
+	//IoDevice interface, called from the CPU thread
+	unsigned char read(unsigned char reg) override;
+	void write(unsigned char reg, unsigned char value) override;
+
+	bool attach(int in_fd, int out_fd); //start the host thread on existing descriptors, pass -1 for a direction that isn't used
+	bool attach_files(const char* in_path, const char* out_path); //open the given files (either may be nullptr) and attach to them
+	void detach(); //stop the host thread, everything still in the transmit buffer gets written out first
+
+	//host side access for embedding without a host thread (tests, scripted input and the like)
+	unsigned int send(const unsigned char* data, unsigned int count); //queue bytes for the guest to receive, only while no host thread is attached (the receive buffer has a single producer)
+	unsigned int receive(unsigned char* data, unsigned int count); //take bytes the guest has transmitted, also only while no host thread is attached (the transmit buffer has a single consumer)
+
+	bool irq_pending(); //true when the receiver interrupt is enabled and there's data waiting
+	bool input_eof(); //true once the host input has hit end of file
+	unsigned long long get_tx_dropped();
+};
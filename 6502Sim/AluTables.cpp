@@ -0,0 +1,93 @@
+#include "AluTables.h"
+
+unsigned short AluTables::_table[3 * 0x20000];
+
+/// <summary>
+/// Builds the tables the first time it is called, the function local static makes this thread safe without the processor having to check anything per instruction
+/// </summary>
+void AluTables::init() {
+	static bool built = (build(), true);
+	(void)built;
+}
+
+/// <summary>
+/// Fills every entry of the three tables, this is where all of the actual arithmetic lives now
+/// </summary>
+void AluTables::build() {
+	for (int carry = 0; carry < 2; carry++) {
+		for (int a = 0; a < 256; a++) {
+			for (int b = 0; b < 256; b++) {
+				unsigned int index = (carry << 16) | (a << 8) | b;
+
+				//binary ADC, overflow when both inputs have the same sign and the result's sign differs (http://www.righto.com/2012/12/the-6502-overflow-flag-explained.html)
+				int sum = a + b + carry;
+				unsigned char flags = 0x00;
+				if (sum > 0xFF) {
+					flags |= ALU_C;
+				}
+				if ((~(a ^ b) & (a ^ sum) & 0x80) != 0) {
+					flags |= ALU_V;
+				}
+				if ((sum & 0xFF) == 0) {
+					flags |= ALU_Z;
+				}
+				if ((sum & 0x80) != 0) {
+					flags |= ALU_N;
+				}
+				_table[(ADC_BINARY << 17) | index] = (unsigned short)((flags << 8) | (sum & 0xFF));
+
+				//decimal ADC, Z comes from the binary sum, N and V from the sum before the high digit is corrected, C from the corrected sum
+				int low = (a & 0x0F) + (b & 0x0F) + carry;
+				if (low >= 0x0A) {
+					low = ((low + 0x06) & 0x0F) + 0x10;
+				}
+				int dec = (a & 0xF0) + (b & 0xF0) + low;
+				signed char a_signed = (signed char)(a & 0xF0);
+				signed char b_signed = (signed char)(b & 0xF0);
+				int dec_signed = a_signed + b_signed + low;
+				flags = 0x00;
+				if ((dec & 0x80) != 0) {
+					flags |= ALU_N;
+				}
+				if (dec_signed < -128 || dec_signed > 127) {
+					flags |= ALU_V;
+				}
+				if ((sum & 0xFF) == 0) {
+					flags |= ALU_Z;
+				}
+				if (dec >= 0xA0) {
+					dec += 0x60;
+				}
+				if (dec >= 0x100) {
+					flags |= ALU_C;
+				}
+				_table[(ADC_DECIMAL << 17) | index] = (unsigned short)((flags << 8) | (dec & 0xFF));
+
+				//decimal SBC, all four flags are the same as binary SBC (which is ADC with the operand inverted), only the accumulator gets corrected
+				int diff = a + (b ^ 0xFF) + carry;
+				flags = 0x00;
+				if (diff > 0xFF) {
+					flags |= ALU_C;
+				}
+				if (((a ^ b) & (a ^ diff) & 0x80) != 0) {
+					flags |= ALU_V;
+				}
+				if ((diff & 0xFF) == 0) {
+					flags |= ALU_Z;
+				}
+				if ((diff & 0x80) != 0) {
+					flags |= ALU_N;
+				}
+				low = (a & 0x0F) - (b & 0x0F) + carry - 1;
+				if (low < 0) {
+					low = ((low - 0x06) & 0x0F) - 0x10;
+				}
+				dec = (a & 0xF0) - (b & 0xF0) + low;
+				if (dec < 0) {
+					dec -= 0x60;
+				}
+				_table[(SBC_DECIMAL << 17) | index] = (unsigned short)((flags << 8) | (dec & 0xFF));
+			}
+		}
+	}
+}
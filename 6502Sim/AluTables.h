@@ -0,0 +1,33 @@
+#pragma once
+
+/// <summary>
+/// Enum for the precomputed ADC/SBC tables, binary SBC doesn't need a table of its own since it is exactly ADC with the operand inverted
+/// </summary>
+enum ALU_TABLES {
+	ADC_BINARY = 0, ADC_DECIMAL = 1, SBC_DECIMAL = 2
+};
+
+/// <summary>
+/// Lookup tables for ADC and SBC, indexed by (table, carry, accumulator, operand)
+/// Each entry holds the 8-bit result in the low byte and the resulting N/V/Z/C flags in the high byte (using the bit positions from the real status register, see the ALU_ masks below),
+/// so the arithmetic in the processor becomes a single load instead of the carry/overflow branching (and the decimal mode correction steps)
+/// Decimal mode follows the NMOS 6502 behaviour described in http://www.6502.org/tutorials/decimal_mode.html (Appendix A), including the flags it sets for invalid BCD operands
+/// </summary>
+class AluTables
+{
+public:
+	static const unsigned char ALU_N = 0x80;
+	static const unsigned char ALU_V = 0x40;
+	static const unsigned char ALU_Z = 0x02;
+	static const unsigned char ALU_C = 0x01;
+
+	static void init(); //builds the tables, safe to call any number of times, the Processor constructors call it
+
+	static inline unsigned short lookup(ALU_TABLES table, unsigned char a, unsigned char operand, unsigned char carry) {
+		return _table[((unsigned int)table << 17) | ((unsigned int)(carry & 0x01) << 16) | ((unsigned int)a << 8) | operand];
+	}
+
+private:
+	static unsigned short _table[3 * 0x20000]; //3 tables of 2 (carry) * 256 (a) * 256 (operand) entries, 768KB altogether
+	static void build();
+};
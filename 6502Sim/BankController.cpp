@@ -0,0 +1,155 @@
+#include "BankController.h"
+#include <cstring>
+
+BankController::BankController() {
+	_window_count = 0;
+	_memory_count = 0;
+	_switches = 0;
+	for (unsigned int i = 0; i < MAX_MEMORIES; i++) {
+		_memories[i] = nullptr;
+	}
+}
+
+/// <summary>
+/// Throws 7 (the error code for a bad bank setup) for a window that hasn't been added
+/// </summary>
+void BankController::check_window(unsigned int window) {
+	if (window >= _window_count) {
+		throw 7;
+	}
+}
+
+/// <summary>
+/// Points the window's pages at its selected bank in every attached memory, one page table entry per page, nothing gets copied
+/// </summary>
+void BankController::map_window(unsigned int window) {
+	Window& w = _windows[window];
+	unsigned char* bank = w.storage.data() + (size_t)w.selected * w.pages * 256;
+	for (unsigned int m = 0; m < _memory_count; m++) {
+		_memories[m]->map_pages(w.first_page, w.pages, bank, w.writable);
+	}
+}
+
+/// <summary>
+/// Adds a window and allocates its banks (cleared to zero), bank 0 gets mapped into any memory already attached
+/// </summary>
+/// <param name="first_page">high byte of the window's first address, 2 or more, the zero page and stack can't be banked (the processor keeps direct pointers to them)</param>
+/// <param name="pages">size of the window, and so of each bank, in 256 byte pages (64 for a 16K bank), the window has to end by $FFFF</param>
+/// <param name="banks">number of banks, 1 to 256 (the bank register is a byte)</param>
+/// <param name="writable">true for banked RAM, false for ROM</param>
+/// <returns>the window number, which is also the register that selects its bank</returns>
+unsigned int BankController::add_window(unsigned char first_page, unsigned int pages, unsigned int banks, bool writable) {
+	if (_window_count >= MAX_WINDOWS || first_page < 0x02 || pages == 0 || first_page + pages > 256 || banks == 0 || banks > 256) {
+		throw 7;
+	}
+	Window& w = _windows[_window_count];
+	w.first_page = first_page;
+	w.pages = pages;
+	w.banks = banks;
+	w.writable = writable;
+	w.selected = 0;
+	w.storage.assign((size_t)banks * pages * 256, 0x00);
+	map_window(_window_count);
+	return _window_count++;
+}
+
+/// <summary>
+/// Attaches a memory, which shows the selected bank of every window from now on. For a processor use attach_banks, which attaches its RAM and ROM both
+/// </summary>
+void BankController::attach(Memory* memory) {
+	if (memory == nullptr || _memory_count >= MAX_MEMORIES) {
+		throw 7;
+	}
+	for (unsigned int m = 0; m < _memory_count; m++) {
+		if (_memories[m] == memory) {
+			return; //a unified memory gets attached as both RAM and ROM
+		}
+	}
+	_memories[_memory_count++] = memory;
+	for (unsigned int w = 0; w < _window_count; w++) {
+		map_window(w);
+	}
+}
+
+void BankController::detach() {
+	for (unsigned int m = 0; m < _memory_count; m++) {
+		for (unsigned int w = 0; w < _window_count; w++) {
+			for (unsigned int page = 0; page < _windows[w].pages; page++) {
+				_memories[m]->unmap_page((unsigned char)(_windows[w].first_page + page));
+			}
+		}
+		_memories[m] = nullptr;
+	}
+	_memory_count = 0;
+}
+
+/// <summary>
+/// Shows a bank in a window, this only swaps the window's page table entries, the bank being switched out keeps whatever was written to it
+/// </summary>
+/// <param name="bank">wraps around past the last bank</param>
+void BankController::select(unsigned int window, unsigned int bank) {
+	check_window(window);
+	_windows[window].selected = bank % _windows[window].banks;
+	map_window(window);
+	_switches++;
+}
+
+unsigned int BankController::get_selected(unsigned int window) {
+	check_window(window);
+	return _windows[window].selected;
+}
+
+unsigned int BankController::get_bank_count(unsigned int window) {
+	check_window(window);
+	return _windows[window].banks;
+}
+
+unsigned int BankController::get_bank_size(unsigned int window) {
+	check_window(window);
+	return _windows[window].pages * 256;
+}
+
+unsigned char* BankController::get_bank(unsigned int window, unsigned int bank) {
+	check_window(window);
+	if (bank >= _windows[window].banks) {
+		throw 7;
+	}
+	return _windows[window].storage.data() + (size_t)bank * _windows[window].pages * 256;
+}
+
+/// <summary>
+/// Copies an image into a window's banks, filling first_bank and then the ones after it, throws 7 if it doesn't fit
+/// </summary>
+void BankController::load(unsigned int window, const unsigned char* data, unsigned int size, unsigned int first_bank) {
+	check_window(window);
+	Window& w = _windows[window];
+	size_t start = (size_t)first_bank * w.pages * 256;
+	if (first_bank >= w.banks || size > w.storage.size() - start) {
+		throw 7;
+	}
+	memcpy(w.storage.data() + start, data, size);
+}
+
+unsigned long long BankController::get_switches() {
+	return _switches;
+}
+
+/// <summary>
+/// Reading a register gives the bank selected in that window, registers without a window read as 0xFF (an open bus)
+/// </summary>
+unsigned char BankController::read(unsigned char reg) {
+	if (reg >= _window_count) {
+		return 0xFF;
+	}
+	return (unsigned char)_windows[reg].selected;
+}
+
+/// <summary>
+/// Writing a register selects the bank for that window, writes to registers without a window are ignored
+/// </summary>
+void BankController::write(unsigned char reg, unsigned char value) {
+	if (reg >= _window_count) {
+		return;
+	}
+	select(reg, value);
+}
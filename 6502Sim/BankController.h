@@ -0,0 +1,58 @@
+#pragma once
+#include "IoDevice.h"
+#include "Memory.h"
+#include <vector>
+
+/// <summary>
+/// Bank switching, for machines with more memory than the 64K the 6502 can see at once (cartridges, banked RAM expansions of 512K and up).
+/// The controller owns the banks, and each window is a run of pages in the CPU's address space that shows one of its banks at a time.
+/// Selecting a bank just points the window's pages in the attached memories' page tables at the bank (see Memory::map_page), nothing is copied,
+/// so a switch costs the same whatever the bank size, and code running from a bank goes through the same single lookup as any other memory.
+/// It's also an IoDevice, mapped over a page of its own: writing register n selects the bank shown in window n and reading it gives the bank back,
+/// the way the bank latch on most cartridges and expansions works (bank numbers past the last bank wrap around, like a latch with unused bits).
+/// Like any device, the controller has to outlive the memories it's attached to, or be detached first.
+/// </summary>
+class BankController : public IoDevice
+{
+public:
+	static const unsigned int MAX_WINDOWS = 8;
+	static const unsigned int MAX_MEMORIES = 2; //the RAM and ROM of a processor that keeps them apart
+
+private:
+	struct Window {
+		unsigned char first_page;
+		unsigned int pages; //pages per bank, so the size of the window
+		unsigned int banks;
+		bool writable; //false for ROM banks, writes to them are dropped
+		unsigned int selected;
+		std::vector<unsigned char> storage; //all the banks back to back, banks * pages * 256 bytes
+	};
+
+	Window _windows[MAX_WINDOWS];
+	unsigned int _window_count;
+	Memory* _memories[MAX_MEMORIES];
+	unsigned int _memory_count;
+	unsigned long long _switches;
+
+	void map_window(unsigned int window);
+	void check_window(unsigned int window);
+
+public:
+	BankController();
+
+	unsigned int add_window(unsigned char first_page, unsigned int pages, unsigned int banks, bool writable); //returns the window number (its register), bank 0 is shown to start with
+	void attach(Memory* memory); //show the windows in this memory, the memory does not take ownership
+	void detach(); //unmap the windows from every attached memory, which goes back to showing its own block there
+
+	void select(unsigned int window, unsigned int bank);
+	unsigned int get_selected(unsigned int window);
+	unsigned int get_bank_count(unsigned int window);
+	unsigned int get_bank_size(unsigned int window);
+	unsigned char* get_bank(unsigned int window, unsigned int bank); //the bank's bytes, for inspecting it or filling it directly
+	void load(unsigned int window, const unsigned char* data, unsigned int size, unsigned int first_bank = 0); //copy an image (a cartridge dump) into consecutive banks
+	unsigned long long get_switches(); //bank selects since the controller was created
+
+	//IoDevice interface
+	unsigned char read(unsigned char reg) override;
+	void write(unsigned char reg, unsigned char value) override;
+};
@@ -0,0 +1,152 @@
+#include "CallGraph.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+CallGraphHooks::CallGraphHooks() {
+	reset();
+}
+
+void CallGraphHooks::reset() {
+	_stack.clear();
+	_routines.clear();
+	_edges.clear();
+	_started = false;
+	_root = 0;
+	_start_cycles = 0;
+	_last_cycles = 0;
+	_pending = 0;
+}
+
+const std::unordered_map<unsigned short, RoutineCost>& CallGraphHooks::routines() const {
+	return _routines;
+}
+
+unsigned short CallGraphHooks::current() const {
+	return _stack.frames().empty() ? _root : _stack.frames().back().entry;
+}
+
+/// <summary>
+/// Charges a finished call, called by the shadow stack before it drops the frame, so the caller is still the frame under it
+/// </summary>
+void CallGraphHooks::returned(const CallFrame& frame, unsigned long long cycles) {
+	const std::vector<CallFrame>& frames = _stack.frames();
+	unsigned short caller = frames.size() >= 2 ? frames[frames.size() - 2].entry : _root;
+	unsigned long long inclusive = cycles - frame.entry_cycles;
+
+	CallCost& edge = _edges[((unsigned int)caller << 16) | frame.entry];
+	edge.inclusive += inclusive;
+	RoutineCost& routine = _routines[frame.entry];
+	if (routine.active > 0) {
+		routine.active--;
+	}
+	if (routine.active == 0) {
+		routine.inclusive += inclusive;
+	}
+}
+
+/// <summary>
+/// Counts the call that was just pushed
+/// </summary>
+void CallGraphHooks::called() {
+	const std::vector<CallFrame>& frames = _stack.frames();
+	const CallFrame& frame = frames.back();
+	unsigned short caller = frames.size() >= 2 ? frames[frames.size() - 2].entry : _root;
+	_edges[((unsigned int)caller << 16) | frame.entry].calls++;
+	RoutineCost& routine = _routines[frame.entry];
+	routine.calls++;
+	routine.active++;
+}
+
+/// <summary>
+/// Copies of the costs with the routines still on the stack (and the root) closed off as if they returned now, which is what a report wants
+/// </summary>
+static void close_open_frames(const std::vector<CallFrame>& frames, unsigned short root, unsigned short current, unsigned long long pending,
+	unsigned long long start_cycles, unsigned long long now, std::unordered_map<unsigned short, RoutineCost>& routines, std::unordered_map<unsigned int, CallCost>& edges) {
+	routines[current].exclusive += pending;
+	for (size_t i = frames.size(); i-- > 0;) {
+		unsigned short caller = i > 0 ? frames[i - 1].entry : root;
+		unsigned long long inclusive = now - frames[i].entry_cycles;
+		edges[((unsigned int)caller << 16) | frames[i].entry].inclusive += inclusive;
+		RoutineCost& routine = routines[frames[i].entry];
+		if (routine.active > 0 && --routine.active == 0) {
+			routine.inclusive += inclusive;
+		}
+	}
+	RoutineCost& top = routines[root];
+	if (top.active > 0 && --top.active == 0) {
+		top.inclusive += now - start_cycles;
+	}
+}
+
+/// <summary>
+/// Writes one line per routine, most inclusive time first
+/// </summary>
+void CallGraphHooks::write_report(FILE* output, SymbolTable& symbols) {
+	std::unordered_map<unsigned short, RoutineCost> routines = _routines;
+	std::unordered_map<unsigned int, CallCost> edges = _edges;
+	close_open_frames(_stack.frames(), _root, current(), _pending, _start_cycles, _last_cycles, routines, edges);
+
+	std::vector<std::pair<unsigned short, RoutineCost> > order(routines.begin(), routines.end());
+	std::sort(order.begin(), order.end(), [](const std::pair<unsigned short, RoutineCost>& left, const std::pair<unsigned short, RoutineCost>& right) {
+		return left.second.inclusive != right.second.inclusive ? left.second.inclusive > right.second.inclusive : left.first < right.first;
+	});
+	unsigned long long total = _last_cycles - _start_cycles;
+	fprintf(output, "%10s %14s %7s %14s %7s  %s\n", "calls", "inclusive", "", "exclusive", "", "routine");
+	for (size_t i = 0; i < order.size(); i++) {
+		const RoutineCost& cost = order[i].second;
+		fprintf(output, "%10llu %14llu %6.2f%% %14llu %6.2f%%  %s\n", cost.calls, cost.inclusive, total > 0 ? 100.0 * (double)cost.inclusive / (double)total : 0.0,
+			cost.exclusive, total > 0 ? 100.0 * (double)cost.exclusive / (double)total : 0.0, symbols.describe(order[i].first).c_str());
+	}
+}
+
+/// <summary>
+/// Writes the call graph in callgrind's format, positions are instruction addresses, each routine's own cost is put on its entry address
+/// and the calls it makes on the same line (the graph is kept per pair of routines, not per call site)
+/// </summary>
+void CallGraphHooks::write_callgrind(FILE* output, SymbolTable& symbols, const char* command) {
+	std::unordered_map<unsigned short, RoutineCost> routines = _routines;
+	std::unordered_map<unsigned int, CallCost> edges = _edges;
+	close_open_frames(_stack.frames(), _root, current(), _pending, _start_cycles, _last_cycles, routines, edges);
+
+	fprintf(output, "# callgrind format\nversion: 1\ncreator: 6502Sim call graph profiler\n");
+	if (command != nullptr) {
+		fprintf(output, "cmd: %s\n", command);
+	}
+	fprintf(output, "positions: instr\nevents: Cycles\nsummary: %llu\n", _last_cycles - _start_cycles);
+
+	//names are written out in full the first time and by number after that, which the format calls name compression
+	std::map<unsigned short, unsigned int> ids;
+	std::string name_text;
+	auto name = [&ids, &symbols, &name_text](unsigned short entry) -> const char* {
+		char text[16];
+		std::map<unsigned short, unsigned int>::iterator found = ids.find(entry);
+		if (found != ids.end()) {
+			snprintf(text, sizeof(text), "(%u)", found->second);
+			name_text = text;
+		}
+		else {
+			unsigned int id = (unsigned int)ids.size() + 1;
+			ids[entry] = id;
+			snprintf(text, sizeof(text), "(%u) ", id);
+			name_text = text + symbols.describe(entry);
+		}
+		return name_text.c_str();
+	};
+
+	//sorted, so the output is the same from run to run
+	std::map<unsigned short, RoutineCost> sorted_routines(routines.begin(), routines.end());
+	std::map<unsigned int, CallCost> sorted_edges(edges.begin(), edges.end());
+	for (std::map<unsigned short, RoutineCost>::const_iterator routine = sorted_routines.begin(); routine != sorted_routines.end(); ++routine) {
+		fprintf(output, "\nfn=%s\n", name(routine->first));
+		fprintf(output, "0x%04X %llu\n", routine->first, routine->second.exclusive);
+		std::map<unsigned int, CallCost>::const_iterator edge = sorted_edges.lower_bound((unsigned int)routine->first << 16);
+		for (; edge != sorted_edges.end() && (edge->first >> 16) == routine->first; ++edge) {
+			unsigned short callee = (unsigned short)(edge->first & 0xFFFF);
+			fprintf(output, "cfn=%s\n", name(callee));
+			fprintf(output, "calls=%llu 0x%04X\n", edge->second.calls, callee);
+			fprintf(output, "0x%04X %llu\n", routine->first, edge->second.inclusive);
+		}
+	}
+}
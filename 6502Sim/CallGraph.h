@@ -0,0 +1,90 @@
+#pragma once
+#include "ProcessorHooks.h"
+#include "CallStack.h"
+#include "Symbols.h"
+#include <cstdio>
+#include <unordered_map>
+
+/// <summary>
+/// Cycle costs of one guest routine, keyed by its entry address
+/// </summary>
+struct RoutineCost {
+	unsigned long long calls;
+	unsigned long long exclusive; //cycles spent in the routine itself
+	unsigned long long inclusive; //cycles from entry to return, callees included, recursive activations are only counted once (the outermost)
+	unsigned int active; //activations on the shadow stack right now
+};
+
+/// <summary>
+/// Cost of the calls from one routine to another
+/// </summary>
+struct CallCost {
+	unsigned long long calls;
+	unsigned long long inclusive;
+};
+
+/// <summary>
+/// Hooks policy for a call graph profiler: follows the guest's JSRs with a ShadowStack (which resyncs on the stack pointer, so RTS tricks and stack resets
+/// don't throw it off), charges every instruction's cycles to the routine it ran in, and on each return charges the routine's whole time to it and to the call edge it came in on.
+/// The code running outside of any JSR counts as one more routine, entered where execution started.
+/// Exclusive cycles pile up in a single counter and only go into the hash map when the routine changes, so a straight run of instructions costs an add each.
+/// write_callgrind produces callgrind's format, which KCachegrind, QCachegrind and gprof2dot all read.
+/// </summary>
+class CallGraphHooks : public NullHooks
+{
+private:
+	ShadowStack _stack;
+	std::unordered_map<unsigned short, RoutineCost> _routines;
+	std::unordered_map<unsigned int, CallCost> _edges; //caller entry << 16 | callee entry
+	bool _started;
+	unsigned short _root; //where execution started, the routine for code outside any JSR
+	unsigned long long _start_cycles;
+	unsigned long long _last_cycles;
+	unsigned long long _pending; //exclusive cycles of the current routine not yet added to _routines
+
+	unsigned short current() const; //entry of the routine being run
+	void returned(const CallFrame& frame, unsigned long long cycles);
+	void called();
+
+public:
+	CallGraphHooks();
+
+	void reset(); //forget everything, the next instruction starts a new root
+	const std::unordered_map<unsigned short, RoutineCost>& routines() const; //costs so far, routines still on the stack don't have their inclusive time yet
+	void write_report(FILE* output, SymbolTable& symbols); //routines by inclusive time
+	void write_callgrind(FILE* output, SymbolTable& symbols, const char* command); //command goes on the cmd: line, may be nullptr
+
+	void on_fetch(unsigned short address, unsigned char opcode) {
+		_stack.fetch(address, opcode);
+	}
+
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		unsigned long long cycles = cpu.get_cycles();
+		if (!_started) {
+			//the processor's count from before the first instruction isn't known here, so that instruction goes uncounted
+			_started = true;
+			_root = _stack.current_address();
+			_start_cycles = cycles;
+			_last_cycles = cycles;
+			_routines[_root].calls = 1;
+			_routines[_root].active = 1;
+		}
+		_pending += cycles - _last_cycles;
+		_last_cycles = cycles;
+
+		unsigned short owner = current();
+		bool returns = false;
+		bool calls = _stack.retire((unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low()), cpu.get_sp(), cycles, [this, &returns](const CallFrame& frame, unsigned long long at) {
+			returns = true;
+			returned(frame, at);
+		});
+		if (returns || calls) {
+			_routines[owner].exclusive += _pending; //the instruction that made the call or the return belongs to the routine it ran in
+			_pending = 0;
+			if (calls) {
+				called();
+			}
+		}
+	}
+};
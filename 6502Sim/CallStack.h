@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+
+/// <summary>
+/// A routine the guest is inside of, pushed on a JSR
+/// </summary>
+struct CallFrame {
+	unsigned short entry; //where the JSR went
+	unsigned short call_site; //address of the JSR
+	unsigned char sp; //stack pointer from before the JSR, once it's back up here the routine is gone
+	unsigned long long entry_cycles;
+};
+
+/// <summary>
+/// Follows the guest's subroutine calls for profilers, fed from a hooks policy's on_fetch and on_instruction_retired.
+/// Returns aren't matched up with RTS instructions, a frame is dropped as soon as the stack pointer is back at (or above) where it was before the JSR,
+/// so routines that leave through a JMP after pulling their return address, stack resets with TXS, RTS used as a computed jump (push an address, RTS)
+/// and the like all keep the stack in step with the guest. The guest stack is taken not to wrap around, which holds for anything that uses it as a stack.
+/// </summary>
+class ShadowStack
+{
+private:
+	static const unsigned int MAX_DEPTH = 256; //more than the guest stack can hold, only reached if it wraps
+
+	std::vector<CallFrame> _frames;
+	unsigned short _address; //of the instruction being executed
+	bool _is_call;
+
+public:
+	ShadowStack() : _address(0), _is_call(false) {
+		_frames.reserve(MAX_DEPTH);
+	}
+
+	void fetch(unsigned short address, unsigned char opcode) {
+		_address = address;
+		_is_call = opcode == 0x20; //JSR
+	}
+
+	/// <summary>
+	/// Brings the stack up to date after an instruction, on_return is called for every frame that gets dropped, innermost first, with the cycle count at the time
+	/// </summary>
+	/// <param name="pc">program counter after the instruction, where a JSR went</param>
+	/// <param name="sp">stack pointer after the instruction</param>
+	/// <param name="cycles">cycle count after the instruction</param>
+	/// <returns>true if the instruction was a call and a frame was pushed for it</returns>
+	template <typename OnReturn>
+	bool retire(unsigned short pc, unsigned char sp, unsigned long long cycles, OnReturn on_return) {
+		while (!_frames.empty() && sp >= _frames.back().sp) {
+			on_return(_frames.back(), cycles);
+			_frames.pop_back();
+		}
+		if (_is_call) {
+			if (_frames.size() >= MAX_DEPTH) {
+				_frames.erase(_frames.begin());
+			}
+			CallFrame frame;
+			frame.entry = pc;
+			frame.call_site = _address;
+			frame.sp = (unsigned char)(sp + 2); //a JSR pushes two bytes
+			frame.entry_cycles = cycles;
+			_frames.push_back(frame);
+		}
+		return _is_call;
+	}
+
+	bool retire(unsigned short pc, unsigned char sp, unsigned long long cycles) {
+		return retire(pc, sp, cycles, [](const CallFrame&, unsigned long long) {});
+	}
+
+	const std::vector<CallFrame>& frames() const {
+		return _frames; //outermost first
+	}
+
+	unsigned short current_address() const {
+		return _address;
+	}
+
+	void clear() {
+		_frames.clear();
+	}
+};
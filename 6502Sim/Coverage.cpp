@@ -0,0 +1,162 @@
+#include "Coverage.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COVERAGE_SSE2
+#endif
+
+static const char COVERAGE_MAGIC[8] = { '6', '5', '0', '2', 'C', 'O', 'V', 1 };
+
+CoverageMap::CoverageMap() : _executed(WORDS, 0), _taken(WORDS, 0), _not_taken(WORDS, 0) {
+}
+
+/// <summary>
+/// ORs one bitmap into another, 128 bits at a time where SSE2 is there (every x64 build, and x86 builds with /arch:SSE2 or better), a word at a time otherwise
+/// </summary>
+static void or_bits(std::vector<unsigned long long>& into, const std::vector<unsigned long long>& from) {
+	size_t i = 0;
+#ifdef COVERAGE_SSE2
+	for (; i + 2 <= into.size(); i += 2) {
+		__m128i left = _mm_loadu_si128((const __m128i*)&into[i]);
+		__m128i right = _mm_loadu_si128((const __m128i*)&from[i]);
+		_mm_storeu_si128((__m128i*)&into[i], _mm_or_si128(left, right));
+	}
+#endif
+	for (; i < into.size(); i++) {
+		into[i] |= from[i];
+	}
+}
+
+void CoverageMap::merge(const CoverageMap& other) {
+	or_bits(_executed, other._executed);
+	or_bits(_taken, other._taken);
+	or_bits(_not_taken, other._not_taken);
+}
+
+void CoverageMap::clear() {
+	_executed.assign(WORDS, 0);
+	_taken.assign(WORDS, 0);
+	_not_taken.assign(WORDS, 0);
+}
+
+unsigned int CoverageMap::count_executed() const {
+	unsigned int count = 0;
+	for (size_t i = 0; i < _executed.size(); i++) {
+		for (unsigned long long word = _executed[i]; word != 0; word &= word - 1) {
+			count++;
+		}
+	}
+	return count;
+}
+
+bool CoverageMap::save(const char* path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	char header[16] = { 0 };
+	std::copy(COVERAGE_MAGIC, COVERAGE_MAGIC + sizeof(COVERAGE_MAGIC), header);
+	file.write(header, sizeof(header));
+	const std::vector<unsigned long long>* maps[3] = { &_executed, &_taken, &_not_taken };
+	for (int map = 0; map < 3; map++) {
+		char bytes[WORDS * 8];
+		for (unsigned int i = 0; i < WORDS; i++) {
+			for (unsigned int b = 0; b < 8; b++) {
+				bytes[i * 8 + b] = (char)(((*maps[map])[i] >> (b * 8)) & 0xFF);
+			}
+		}
+		file.write(bytes, sizeof(bytes));
+	}
+	return file.good();
+}
+
+bool CoverageMap::load(const char* path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	char header[16];
+	if (!file.read(header, sizeof(header)) || !std::equal(COVERAGE_MAGIC, COVERAGE_MAGIC + sizeof(COVERAGE_MAGIC), header)) {
+		return false;
+	}
+	std::vector<unsigned long long> loaded[3];
+	for (int map = 0; map < 3; map++) {
+		char bytes[WORDS * 8];
+		if (!file.read(bytes, sizeof(bytes))) {
+			return false;
+		}
+		loaded[map].resize(WORDS);
+		for (unsigned int i = 0; i < WORDS; i++) {
+			unsigned long long word = 0;
+			for (unsigned int b = 0; b < 8; b++) {
+				word |= (unsigned long long)(unsigned char)bytes[i * 8 + b] << (b * 8);
+			}
+			loaded[map][i] = word;
+		}
+	}
+	_executed.swap(loaded[0]);
+	_taken.swap(loaded[1]);
+	_not_taken.swap(loaded[2]);
+	return true;
+}
+
+/// <summary>
+/// What lcov wants per source line, several SourceLines (one per span) can go into the same line
+/// </summary>
+struct LcovLine {
+	bool hit;
+	std::vector<unsigned short> branches; //addresses of the branch instructions on the line
+};
+
+void CoverageMap::write_lcov(FILE* output, const LineTable& lines, const unsigned char* memory, const char* test_name) const {
+	//file index -> line number -> what happened on it, maps so the records come out in order
+	std::map<unsigned int, std::map<unsigned int, LcovLine> > files;
+	const std::vector<SourceLine>& source_lines = lines.lines();
+	for (size_t i = 0; i < source_lines.size(); i++) {
+		const SourceLine& source = source_lines[i];
+		LcovLine& line = files[source.file][source.line];
+		for (unsigned int offset = 0; offset < source.size; offset++) {
+			unsigned short address = (unsigned short)(source.address + offset);
+			if (executed(address)) {
+				line.hit = true;
+			}
+			//the line's first byte is an instruction, anything further in is only known to be one if it ran
+			bool branch = taken(address) || not_taken(address) || (offset == 0 && memory != nullptr && (memory[address] & 0x1F) == 0x10);
+			if (branch) {
+				line.branches.push_back(address);
+			}
+		}
+	}
+
+	for (std::map<unsigned int, std::map<unsigned int, LcovLine> >::const_iterator file = files.begin(); file != files.end(); ++file) {
+		fprintf(output, "TN:%s\nSF:%s\n", test_name != nullptr ? test_name : "", lines.files()[file->first].c_str());
+		unsigned int branches_found = 0;
+		unsigned int branches_hit = 0;
+		for (std::map<unsigned int, LcovLine>::const_iterator line = file->second.begin(); line != file->second.end(); ++line) {
+			for (size_t b = 0; b < line->second.branches.size(); b++) {
+				unsigned short address = line->second.branches[b];
+				//the block number is the branch's address, so the same branch keeps its number from run to run, "-" means the branch never ran at all
+				if (executed(address)) {
+					fprintf(output, "BRDA:%u,%u,0,%d\nBRDA:%u,%u,1,%d\n", line->first, address, taken(address) ? 1 : 0, line->first, address, not_taken(address) ? 1 : 0);
+					branches_hit += (taken(address) ? 1 : 0) + (not_taken(address) ? 1 : 0);
+				}
+				else {
+					fprintf(output, "BRDA:%u,%u,0,-\nBRDA:%u,%u,1,-\n", line->first, address, line->first, address);
+				}
+				branches_found += 2;
+			}
+		}
+		if (branches_found > 0) {
+			fprintf(output, "BRF:%u\nBRH:%u\n", branches_found, branches_hit);
+		}
+		unsigned int lines_hit = 0;
+		for (std::map<unsigned int, LcovLine>::const_iterator line = file->second.begin(); line != file->second.end(); ++line) {
+			fprintf(output, "DA:%u,%d\n", line->first, line->second.hit ? 1 : 0);
+			lines_hit += line->second.hit ? 1 : 0;
+		}
+		fprintf(output, "LF:%u\nLH:%u\nend_of_record\n", (unsigned int)file->second.size(), lines_hit);
+	}
+}
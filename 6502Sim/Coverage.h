@@ -0,0 +1,81 @@
+#pragma once
+#include "ProcessorHooks.h"
+#include "Symbols.h"
+#include <cstdio>
+#include <vector>
+
+/// <summary>
+/// Which guest instructions ever ran, one bit per address for instruction starts, plus a bit per branch for "was taken" and one for "fell through".
+/// Each map is 8K, so maps from runs done in parallel (or kept from earlier runs in files) merge with a few thousand vector ORs.
+/// The file format is a 16 byte header ("6502COV" and a version byte, then 8 bytes of zero) and the three bitmaps, executed, taken, not taken, as little endian 64 bit words.
+/// </summary>
+class CoverageMap
+{
+private:
+	static const unsigned int WORDS = 65536 / 64;
+
+	std::vector<unsigned long long> _executed;
+	std::vector<unsigned long long> _taken;
+	std::vector<unsigned long long> _not_taken;
+
+	static bool test(const std::vector<unsigned long long>& bits, unsigned short address) {
+		return (bits[address >> 6] >> (address & 63)) & 1;
+	}
+
+public:
+	CoverageMap();
+
+	void mark_executed(unsigned short address) {
+		_executed[address >> 6] |= 1ULL << (address & 63);
+	}
+	void mark_branch(unsigned short address, bool taken) {
+		(taken ? _taken : _not_taken)[address >> 6] |= 1ULL << (address & 63);
+	}
+
+	bool executed(unsigned short address) const { return test(_executed, address); }
+	bool taken(unsigned short address) const { return test(_taken, address); }
+	bool not_taken(unsigned short address) const { return test(_not_taken, address); }
+
+	void merge(const CoverageMap& other); //this |= other
+	void clear();
+	unsigned int count_executed() const; //instruction addresses that ran
+
+	bool save(const char* path) const; //false if the file couldn't be written
+	bool load(const char* path); //replaces what's in the map, false if the file couldn't be read or isn't a coverage file (the map is left alone then)
+
+	/// <summary>
+	/// Writes an lcov tracefile (what genhtml and most CI coverage viewers take): a line counts as hit if any of its bytes ran, and a line that holds a branch
+	/// gets its two outcomes as BRDA records. memory is the 64K image the program ran from, used to find the branches that never ran, may be nullptr,
+	/// then only the branches that ran show up. Counts are 1 or 0, the map only knows whether something happened.
+	/// </summary>
+	void write_lcov(FILE* output, const LineTable& lines, const unsigned char* memory, const char* test_name) const;
+};
+
+/// <summary>
+/// Hooks policy that fills a CoverageMap, one OR per fetched instruction plus a compare after each conditional branch, cheap enough to leave on for every test run.
+/// A branch counts as taken when the program counter after it isn't the next instruction.
+/// </summary>
+class CoverageHooks : public NullHooks
+{
+private:
+	CoverageMap _map;
+	unsigned short _address = 0; //of the instruction being executed
+	bool _is_branch = false;
+
+public:
+	CoverageMap& coverage() { return _map; }
+
+	void on_fetch(unsigned short address, unsigned char opcode) {
+		_map.mark_executed(address);
+		_address = address;
+		_is_branch = (opcode & 0x1F) == 0x10; //BPL, BMI, BVC, BVS, BCC, BCS, BNE, BEQ
+	}
+
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		if (_is_branch) {
+			unsigned short pc = (unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low());
+			_map.mark_branch(_address, pc != (unsigned short)(_address + 2));
+		}
+	}
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstring>
+#include <type_traits>
+
+/// <summary>
+/// Enum for processor state,
+/// </summary>
+enum PROCESSOR_STATE {
+	FETCH, DECODE, EXECUTE, JAMMED
+};
+
+/// <summary>
+/// breakdown of processor flag register into bitwise union/struct, so that I can address the bits of the status flag register individually
+/// I learned of this trick, as well as got some ideas regarding the "structure" of my simulator (more or less future structure, if I decide to connect the modules to a "bus" with timing), from this video: https://www.youtube.com/watch?v=F8kx56OZQhg
+/// note: I am not actually using any of the code from this video series (as far as I'm aware, although it may be similar as both involve 6502 emulation), I've actually only seen the first video, it's part of what gave me the idea of doing this project, and I did feel like sourcing where I learned the union/struct trick
+/// </summary>
+union StatusFlags {
+	struct {
+		//breakdown of flag register will go here
+		unsigned char n_flag : 1; //negative flag, common flag, it determines whether operation results in negative number (bit 7 of resultant operation's register is 1)
+		unsigned char o_flag : 1; //overflow flag, detects when a signed overflow has occured (so result is > 127 or < -127, I think is the range), has some interesting logic behind it
+		unsigned char rsvd : 1; //unused reserved bit, it will likely not be used here
+		unsigned char b_flag : 1; //break flag, it likely will not be that necessary for my purposes, as it is essentially used to determine software breaks, but I'll implement the instruction for it, so it does matter
+		unsigned char d_flag : 1; //decimal flag, used for determining whether the processor will operate in decimal mode, also called BCD mode, where operations are done with BCD numbers, not implemented specifically at the moment, but will likely be added after regular binary mode is complete
+		unsigned char id_flag : 1; //interrupt disable flag
+		unsigned char z_flag : 1; //zero flag, very useful flag, determines
+		unsigned char c_flag : 1; //carry flag, used when doing addition/subtraction to ensure that proper results are obtained
+	};
+	unsigned char val;
+};
+
+/// <summary>
+/// Everything architectural about the processor in one plain block the size of a cache line: the registers, the jam state and the cycle count.
+/// (It isn't alignas(64), processors get allocated with new, which only honours that from C++17 on, and most of the tools and the GUI build as C++14,
+/// only RomRunner and VectorRunner are C++17.)
+/// The program counter is a native 16-bit value, so stepping it is a single add, with its two bytes overlaid on it for the instructions that build
+/// addresses a byte at a time (this relies on a little endian host, which covers everything the emulator is built for).
+/// There's no padding the compiler fills in on its own (the spare bytes are named and kept at zero), so two states can be compared with one memcmp
+/// and copied with one memcpy, which is what get_cpu_state and set_cpu_state do.
+/// </summary>
+struct CpuState {
+	union {
+		unsigned short pc;
+		struct {
+			unsigned char pc_low;
+			unsigned char pc_high;
+		};
+	};
+	unsigned char a; //accumulator
+	unsigned char x; //index x
+	unsigned char y; //index y
+	unsigned char sp; //stack pointer
+	StatusFlags flags;
+	unsigned char state; //PROCESSOR_STATE, kept to a byte so the fields pack without gaps
+	unsigned long long cycles; //running total of base cycles, added at decode
+	unsigned char reserved[48]; //pads the struct out to the cache line, always zero
+};
+
+static_assert(sizeof(CpuState) == 64, "CpuState should be exactly one cache line");
+static_assert(std::is_trivially_copyable<CpuState>::value, "CpuState has to stay copyable with memcpy");
+
+/// <summary>
+/// Compares two states in one go, the spare bytes are always zero so they never make a difference
+/// </summary>
+inline bool same_cpu_state(const CpuState& left, const CpuState& right) {
+	return memcmp(&left, &right, sizeof(CpuState)) == 0;
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include "InstructionSet.h"
+#include <cstring>
+
+/// <summary>
+/// Turns instructions back into assembly text ("LDA ($12),Y"), for traces, monitors and reports. Portable and templated on the character type like MemoryDump,
+/// so the GUI can use wchar_t and command line tools char.
+/// Decoding goes through the processor's own instruction and address mode tables (InstructionSet.h), and everything per opcode (the mnemonic, the address
+/// mode and the length) and per byte (the two hex digits) is looked up in tables built from them at compile time, so an instruction is a few fixed size copies
+/// and one switch, with no formatting calls and no allocation, into a buffer the caller owns. Opcodes the core treats as JAM come out as "JAM", one byte long.
+/// Branch targets are worked out the way the hardware does it, from the address after the branch.
+/// </summary>
+template <typename CharT>
+class Disassembler
+{
+public:
+	static const unsigned int MAX_TEXT = 16; //room for the longest instruction text ("STA $1234,X") and the terminator
+	static const unsigned int MAX_LINE = 32; //room for the longest line ("1234  9D 34 12  STA $1234,X") and the terminator
+
+private:
+	static constexpr unsigned int operand_bytes(ADDRESS_MODES addr_mode) {
+		switch (addr_mode) {
+		case ABSOLUT:
+		case ABSOLUTE_X:
+		case ABSOLUTE_Y:
+		case INDIRECT:
+			return 2;
+		case IMMEDIATE:
+		case INDIRECT_X:
+		case INDIRECT_Y:
+		case RELATIV:
+		case ZEROPAGE:
+		case ZEROPAGE_X:
+		case ZEROPAGE_Y:
+			return 1;
+		default:
+			return 0;
+		}
+	}
+
+	struct Tables {
+		CharT mnemonic[256][4]; //padded to 4 so the entries stay aligned, only the first 3 are copied
+		CharT hex[256][2];
+		unsigned char mode[256]; //ADDRESS_MODES
+		unsigned char length[256];
+
+		constexpr Tables() : mnemonic(), hex(), mode(), length() {
+			//indexed by INSTRUCTIONS
+			const char* names =
+				"ADCANDASLBCCBCSBEQBITBMIBNEBPLBRKBVCBVSCLCCLDCLICLVCMPCPXCPYDECDEXDEYEORINCINXINYJMPJSRLDALDXLDYLSRNOPORAPHAPHPPLAPLPROLRORRTIRTSSBCSECSEDSEISTASTXSTYTAXTAYTSXTXATXSTYAJAM";
+			const char* digits = "0123456789ABCDEF";
+
+			for (int opcode = 0; opcode < 256; opcode++) {
+				int high = opcode >> 4;
+				int low = opcode & 0x0F;
+				INSTRUCTIONS inst = INSTRUCTION_TABLE[high][low];
+				ADDRESS_MODES addr_mode = ADDRESS_MODE_TABLE[high][low];
+				if (inst == JAM) {
+					addr_mode = IMPLIED; //whatever its column says
+				}
+				mode[opcode] = (unsigned char)addr_mode;
+				length[opcode] = (unsigned char)(operand_bytes(addr_mode) + 1);
+				for (int i = 0; i < 3; i++) {
+					mnemonic[opcode][i] = (CharT)names[inst * 3 + i];
+				}
+				mnemonic[opcode][3] = (CharT)' ';
+				hex[opcode][0] = (CharT)digits[high];
+				hex[opcode][1] = (CharT)digits[low];
+			}
+		}
+	};
+
+	static constexpr Tables TABLES = Tables(); //worked out at compile time from the shared decode tables (see InstructionSet.h)
+
+	static const Tables& tables() {
+		return TABLES;
+	}
+
+	static CharT* put(CharT* out, const char* text) {
+		while (*text != '\0') {
+			*out++ = (CharT)*text++;
+		}
+		return out;
+	}
+
+	static CharT* put_byte(CharT* out, const Tables& t, unsigned char value) {
+		out[0] = t.hex[value][0];
+		out[1] = t.hex[value][1];
+		return out + 2;
+	}
+
+	static CharT* put_word(CharT* out, const Tables& t, unsigned short value) {
+		out = put_byte(out, t, (unsigned char)(value >> 8));
+		return put_byte(out, t, (unsigned char)value);
+	}
+
+public:
+	/// <summary>
+	/// Number of bytes the instruction an opcode starts takes up, 1 to 3
+	/// </summary>
+	static unsigned int length(unsigned char opcode) {
+		return tables().length[opcode];
+	}
+
+	static ADDRESS_MODES get_address_mode(unsigned char opcode) {
+		return (ADDRESS_MODES)tables().mode[opcode];
+	}
+
+	/// <summary>
+	/// Writes the text of one instruction ("LDA ($12),Y") and a terminator, the output needs room for MAX_TEXT characters
+	/// </summary>
+	/// <param name="address">where the instruction is, for branch targets</param>
+	/// <param name="bytes">the instruction, length(bytes[0]) bytes of it are read</param>
+	/// <returns>the number of characters written, minus the terminator</returns>
+	static unsigned int disassemble(unsigned short address, const unsigned char* bytes, CharT* output) {
+		const Tables& t = tables();
+		unsigned char opcode = bytes[0];
+		CharT* out = output;
+		memcpy(out, t.mnemonic[opcode], 4 * sizeof(CharT)); //the space goes too, it's taken back below when there's no operand
+		out += 4;
+		//only the bytes the instruction has are read, so a one byte instruction at the very end of a buffer doesn't read past it
+		unsigned char operand = (t.length[opcode] >= 2) ? bytes[1] : 0x00;
+		unsigned short word = (unsigned short)(operand | (t.length[opcode] == 3 ? bytes[2] << 8 : 0));
+		switch ((ADDRESS_MODES)t.mode[opcode]) {
+		case ACCUMULATOR:
+			*out++ = (CharT)'A';
+			break;
+		case ABSOLUT:
+			*out++ = (CharT)'$';
+			out = put_word(out, t, word);
+			break;
+		case ABSOLUTE_X:
+			*out++ = (CharT)'$';
+			out = put(put_word(out, t, word), ",X");
+			break;
+		case ABSOLUTE_Y:
+			*out++ = (CharT)'$';
+			out = put(put_word(out, t, word), ",Y");
+			break;
+		case IMMEDIATE:
+			out = put_byte(put(out, "#$"), t, operand);
+			break;
+		case INDIRECT:
+			out = put(put_word(put(out, "($"), t, word), ")");
+			break;
+		case INDIRECT_X:
+			out = put(put_byte(put(out, "($"), t, operand), ",X)");
+			break;
+		case INDIRECT_Y:
+			out = put(put_byte(put(out, "($"), t, operand), "),Y");
+			break;
+		case RELATIV:
+			*out++ = (CharT)'$';
+			out = put_word(out, t, (unsigned short)(address + 2 + (signed char)operand));
+			break;
+		case ZEROPAGE:
+			*out++ = (CharT)'$';
+			out = put_byte(out, t, operand);
+			break;
+		case ZEROPAGE_X:
+			*out++ = (CharT)'$';
+			out = put(put_byte(out, t, operand), ",X");
+			break;
+		case ZEROPAGE_Y:
+			*out++ = (CharT)'$';
+			out = put(put_byte(out, t, operand), ",Y");
+			break;
+		default:
+			out--; //implied, no operand and no space
+			break;
+		}
+		*out = (CharT)'\0';
+		return (unsigned int)(out - output);
+	}
+
+	/// <summary>
+	/// Writes a listing line, the address, the instruction's bytes (padded to three) and its text, "0400  8D 00 20  STA $2000", and a terminator,
+	/// the output needs room for MAX_LINE characters
+	/// </summary>
+	/// <returns>the number of characters written, minus the terminator</returns>
+	static unsigned int disassemble_line(unsigned short address, const unsigned char* bytes, CharT* output) {
+		const Tables& t = tables();
+		unsigned int count = t.length[bytes[0]];
+		CharT* out = put_word(output, t, address);
+		*out++ = (CharT)' ';
+		for (unsigned int i = 0; i < 3; i++) {
+			*out++ = (CharT)' ';
+			if (i < count) {
+				out = put_byte(out, t, bytes[i]);
+			}
+			else {
+				out[0] = (CharT)' ';
+				out[1] = (CharT)' ';
+				out += 2;
+			}
+		}
+		*out++ = (CharT)' ';
+		*out++ = (CharT)' ';
+		return (unsigned int)(out - output) + disassemble(address, bytes, out);
+	}
+};
+
+template <typename CharT>
+constexpr typename Disassembler<CharT>::Tables Disassembler<CharT>::TABLES;
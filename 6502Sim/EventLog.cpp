@@ -0,0 +1,210 @@
+#include "EventLog.h"
+#include <algorithm>
+
+static const char EVENT_LOG_MAGIC[8] = { '6', '5', '0', '2', 'E', 'V', 'T', 1 };
+
+EventLog::EventLog() {
+	_last_cycles = 0;
+	_events = 0;
+	_has_next = false;
+}
+
+EventLog::~EventLog() {
+	close();
+}
+
+bool EventLog::create(const char* path) {
+	close();
+	_last_cycles = 0;
+	_events = 0;
+	_output.open(path, std::ios::binary | std::ios::trunc);
+	if (!_output.is_open()) {
+		return false;
+	}
+	char header[16] = { 0 };
+	std::copy(EVENT_LOG_MAGIC, EVENT_LOG_MAGIC + sizeof(EVENT_LOG_MAGIC), header);
+	_output.write(header, sizeof(header));
+	return _output.good();
+}
+
+bool EventLog::open(const char* path) {
+	close();
+	_last_cycles = 0;
+	_events = 0;
+	_input.open(path, std::ios::binary);
+	if (!_input.is_open()) {
+		return false;
+	}
+	char header[16];
+	if (!_input.read(header, sizeof(header)) || !std::equal(EVENT_LOG_MAGIC, EVENT_LOG_MAGIC + sizeof(EVENT_LOG_MAGIC), header)) {
+		_input.close();
+		return false;
+	}
+	_has_next = read_record();
+	return true;
+}
+
+void EventLog::close() {
+	if (_output.is_open()) {
+		_output.close();
+	}
+	if (_input.is_open()) {
+		_input.close();
+	}
+	_has_next = false;
+	_set_aside.clear();
+}
+
+void EventLog::write_varint(unsigned long long value) {
+	do {
+		unsigned char byte = (unsigned char)(value & 0x7F);
+		value >>= 7;
+		_output.put((char)(byte | (value != 0 ? 0x80 : 0x00)));
+	} while (value != 0);
+}
+
+bool EventLog::read_varint(unsigned long long& value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int byte = _input.get();
+		if (byte == std::char_traits<char>::eof()) {
+			return false;
+		}
+		value |= (unsigned long long)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false; //longer than any 64 bit number, the log is broken
+}
+
+void EventLog::record(const InputEvent& event) {
+	if (!_output.is_open()) {
+		return;
+	}
+	write_varint(event.cycles - _last_cycles);
+	_last_cycles = event.cycles;
+	_output.put((char)event.kind);
+	if (event.kind == EVENT_DEVICE_READ) {
+		_output.put((char)event.page);
+		_output.put((char)event.reg);
+		_output.put((char)event.value);
+	}
+	_events++;
+}
+
+/// <summary>
+/// Reads the next record into _next, with its cycle count worked out from the delta
+/// </summary>
+/// <returns>false at the end of the log, or where it's cut off or broken</returns>
+bool EventLog::read_record() {
+	unsigned long long delta;
+	if (!read_varint(delta)) {
+		return false;
+	}
+	int kind = _input.get();
+	if (kind == std::char_traits<char>::eof() || kind > EVENT_NMI) {
+		return false;
+	}
+	_next.kind = (INPUT_EVENT_KINDS)kind;
+	_next.page = 0;
+	_next.reg = 0;
+	_next.value = 0;
+	if (_next.kind == EVENT_DEVICE_READ) {
+		char payload[3];
+		if (!_input.read(payload, sizeof(payload))) {
+			return false;
+		}
+		_next.page = (unsigned char)payload[0];
+		_next.reg = (unsigned char)payload[1];
+		_next.value = (unsigned char)payload[2];
+	}
+	_last_cycles += delta;
+	_next.cycles = _last_cycles;
+	return true;
+}
+
+bool EventLog::peek(InputEvent& event) {
+	if (!_set_aside.empty()) {
+		event = _set_aside.front();
+		return true;
+	}
+	if (!_has_next) {
+		return false;
+	}
+	event = _next;
+	return true;
+}
+
+bool EventLog::next(InputEvent& event) {
+	if (!_set_aside.empty()) {
+		event = _set_aside.front();
+		_set_aside.pop_front();
+		_events++;
+		return true;
+	}
+	if (!_has_next) {
+		return false;
+	}
+	event = _next;
+	_events++;
+	_has_next = read_record();
+	return true;
+}
+
+/// <summary>
+/// Finds the next device read for a page, first among the events set aside earlier, then further on in the log, setting aside the other pages' events it reads past.
+/// It doesn't read past the given cycle count, so the set aside events are only ever the ones the other devices are about to take, as the guest gets to them
+/// </summary>
+/// <param name="page">page of the device asking</param>
+/// <param name="cycles">the processor's cycle count now, a read logged after that is left where it is</param>
+/// <param name="take">true to take the event out of the log, false to only look at it</param>
+/// <returns>false if there's no read for the page up to cycles</returns>
+bool EventLog::find_device(unsigned char page, unsigned long long cycles, bool take, InputEvent& event) {
+	for (std::deque<InputEvent>::iterator it = _set_aside.begin(); it != _set_aside.end(); ++it) {
+		if (it->kind == EVENT_DEVICE_READ && it->page == page) {
+			if (it->cycles > cycles) {
+				return false;
+			}
+			event = *it;
+			if (take) {
+				_set_aside.erase(it);
+				_events++;
+			}
+			return true;
+		}
+	}
+	while (_has_next && _next.cycles <= cycles) {
+		if (_next.kind == EVENT_DEVICE_READ && _next.page == page) {
+			event = _next;
+			if (take) {
+				_events++;
+				_has_next = read_record();
+			}
+			return true;
+		}
+		_set_aside.push_back(_next);
+		_has_next = read_record();
+	}
+	return false;
+}
+
+bool EventLog::peek_device(unsigned char page, unsigned long long cycles, InputEvent& event) {
+	return find_device(page, cycles, false, event);
+}
+
+bool EventLog::next_device(unsigned char page, unsigned long long cycles, InputEvent& event) {
+	return find_device(page, cycles, true, event);
+}
+
+unsigned long long EventLog::get_events() const {
+	return _events;
+}
+
+bool EventLog::is_recording() const {
+	return _output.is_open();
+}
+
+bool EventLog::is_replaying() const {
+	return _input.is_open();
+}
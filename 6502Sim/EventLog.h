@@ -0,0 +1,172 @@
+#pragma once
+#include "IoDevice.h"
+#include <deque>
+#include <fstream>
+
+/// <summary>
+/// Enum for the kinds of event that come into the emulated machine from outside, device register reads are what carries serial input (and any other host data)
+/// into the guest, IRQ and NMI are for drivers that assert the interrupt lines, the core doesn't have those inputs yet
+/// </summary>
+enum INPUT_EVENT_KINDS {
+	EVENT_DEVICE_READ, EVENT_IRQ, EVENT_NMI
+};
+
+/// <summary>
+/// One event, page, reg and value only mean something for device reads
+/// </summary>
+struct InputEvent {
+	unsigned long long cycles; //processor cycle count when it happened
+	INPUT_EVENT_KINDS kind;
+	unsigned char page;
+	unsigned char reg;
+	unsigned char value;
+};
+
+/// <summary>
+/// A log of input events, written while recording a run and read back in order to replay it.
+/// The emulation itself is deterministic, so the log only has to hold what came in from outside, and with it a run of hours replays bit for bit, as fast as the host goes.
+/// The devices only log a read when the register gives something different from the last time it was read (see RecordingDevice), so a guest polling
+/// a status register that doesn't change adds nothing to the log.
+/// File format: a 16 byte header ("6502EVT", a version byte, 8 bytes of zero), then one record per event: the cycles since the previous event as a LEB128 varint,
+/// a kind byte, and page, reg and value for device reads.
+/// </summary>
+class EventLog
+{
+private:
+	std::ofstream _output;
+	std::ifstream _input;
+	unsigned long long _last_cycles; //of the previous event, deltas are from here
+	unsigned long long _events; //recorded or replayed so far
+
+	//replaying, the next event is read ahead so it can be looked at before it's taken
+	bool _has_next;
+	InputEvent _next;
+	std::deque<InputEvent> _set_aside; //events read past while looking for one page's next read, kept in log order for the other pages (and for peek/next)
+
+	bool read_record();
+	bool find_device(unsigned char page, unsigned long long cycles, bool take, InputEvent& event);
+	bool read_varint(unsigned long long& value);
+	void write_varint(unsigned long long value);
+
+public:
+	EventLog();
+	~EventLog();
+
+	bool create(const char* path); //start a new log for recording, false if it couldn't be written
+	bool open(const char* path); //open a log for replay, false if it couldn't be read or isn't an event log
+	void close(); //logs are also closed when the EventLog goes away
+
+	void record(const InputEvent& event); //events have to come in cycle order, which they do when they're recorded as they happen
+	bool peek(InputEvent& event); //the next event without taking it, false at the end of the log
+	bool next(InputEvent& event); //take the next event, false at the end of the log
+	bool peek_device(unsigned char page, unsigned long long cycles, InputEvent& event); //the next device read for one page, if it happened by the given cycle count, without taking it
+	bool next_device(unsigned char page, unsigned long long cycles, InputEvent& event); //take it
+
+	unsigned long long get_events() const; //since the last create or open
+	bool is_recording() const;
+	bool is_replaying() const;
+};
+
+/// <summary>
+/// Sits between the processor and a device while recording: reads go to the device, and when a register gives a different value from the last time (or is read
+/// for the first time) the value is logged with the cycle count, writes go straight through.
+/// Map it over the device's page in place of the device. Templated on the processor so any hooks policy works, the processor is only asked for its cycle count.
+/// </summary>
+template <typename Cpu>
+class RecordingDevice : public IoDevice
+{
+private:
+	Cpu& _cpu;
+	EventLog& _log;
+	IoDevice* _device;
+	unsigned char _page;
+	short _last[256]; //value each register gave last, -1 before it's been read
+
+public:
+	RecordingDevice(Cpu& cpu, EventLog& log, unsigned char page, IoDevice* device) : _cpu(cpu), _log(log), _device(device), _page(page) {
+		for (int i = 0; i < 256; i++) {
+			_last[i] = -1;
+		}
+	}
+
+	unsigned char read(unsigned char reg) override {
+		unsigned char value = _device->read(reg);
+		if (_last[reg] != value) {
+			_last[reg] = value;
+			InputEvent event;
+			event.cycles = _cpu.get_cycles();
+			event.kind = EVENT_DEVICE_READ;
+			event.page = _page;
+			event.reg = reg;
+			event.value = value;
+			_log.record(event);
+		}
+		return value;
+	}
+
+	void write(unsigned char reg, unsigned char value) override {
+		_device->write(reg, value);
+	}
+};
+
+/// <summary>
+/// Stands in for a device while replaying: reads are answered from the log instead, a read with an event for it at this cycle takes the event's value,
+/// any other read gets what the register gave last time, as it did while recording. Writes go to the device if there is one (so output still shows up) or nowhere.
+/// Any number of these can share one log, each takes the events for its own page (see EventLog::next_device), events for a page with no device to take them
+/// pile up in memory, so every page that was recorded should have one.
+/// A replay that stops matching the recording shows up as an event for this page that the guest didn't read at its cycle, or a read of a register
+/// nothing was logged for, the cycle count of the first of those is kept in get_divergence.
+/// </summary>
+template <typename Cpu>
+class ReplayDevice : public IoDevice
+{
+private:
+	Cpu& _cpu;
+	EventLog& _log;
+	IoDevice* _device;
+	unsigned char _page;
+	short _last[256];
+	bool _diverged;
+	unsigned long long _divergence; //cycle count where the replay first didn't match
+
+	void diverge(unsigned long long cycles) {
+		if (!_diverged) {
+			_diverged = true;
+			_divergence = cycles;
+		}
+	}
+
+public:
+	ReplayDevice(Cpu& cpu, EventLog& log, unsigned char page, IoDevice* device) : _cpu(cpu), _log(log), _device(device), _page(page), _diverged(false), _divergence(0) {
+		for (int i = 0; i < 256; i++) {
+			_last[i] = -1;
+		}
+	}
+
+	unsigned char read(unsigned char reg) override {
+		unsigned long long cycles = _cpu.get_cycles();
+		InputEvent event;
+		while (_log.peek_device(_page, cycles, event) && event.cycles < cycles) {
+			diverge(event.cycles); //the guest didn't make this read, skip it so the rest of the log can still be used
+			_log.next_device(_page, cycles, event);
+		}
+		if (_log.peek_device(_page, cycles, event) && event.reg == reg) {
+			_log.next_device(_page, cycles, event);
+			_last[reg] = event.value;
+		}
+		else if (_last[reg] < 0) {
+			diverge(cycles);
+			return 0xFF;
+		}
+		return (unsigned char)_last[reg];
+	}
+
+	void write(unsigned char reg, unsigned char value) override {
+		if (_device != nullptr) {
+			_device->write(reg, value);
+		}
+	}
+
+	bool has_diverged() const { return _diverged; }
+	unsigned long long get_divergence() const { return _divergence; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+/// <summary>
+/// Enum for the instruction sequences the processor can run as one fused handler (see BasicProcessor::enable_fusion), in the order of FUSED_SEQUENCE_TABLE
+/// </summary>
+enum FUSED_SEQUENCES {
+	FUSE_NONE,
+	FUSE_LDA_STA_ABS, FUSE_LDA_IMM_STA_ABS,
+	FUSE_DEX_BNE, FUSE_DEY_BNE, FUSE_INX_BNE, FUSE_INY_BNE,
+	FUSE_INX_CPX_BNE, FUSE_INY_CPY_BNE,
+	FUSE_CLC_ADC_IMM, FUSE_SEC_SBC_IMM,
+	FUSE_COUNT
+};
+
+/// <summary>
+/// A sequence as it runs, the opcodes one after the other in the order they execute (which, for the instructions that move the program counter
+/// on their own terms, isn't always the order they sit in memory)
+/// </summary>
+struct FusedSequence {
+	const char* name; //as written in profile files
+	unsigned int length; //2 or 3
+	unsigned char opcodes[3];
+};
+
+static const FusedSequence FUSED_SEQUENCE_TABLE[FUSE_COUNT] = {
+	{ "NONE", 0, { 0x00, 0x00, 0x00 } },
+	{ "LDA_STA_ABS", 2, { 0xAD, 0x8D, 0x00 } }, //LDA abs / STA abs
+	{ "LDA_IMM_STA_ABS", 2, { 0xA9, 0x8D, 0x00 } }, //LDA # / STA abs
+	{ "DEX_BNE", 2, { 0xCA, 0xD0, 0x00 } },
+	{ "DEY_BNE", 2, { 0x88, 0xD0, 0x00 } },
+	{ "INX_BNE", 2, { 0xE8, 0xD0, 0x00 } },
+	{ "INY_BNE", 2, { 0xC8, 0xD0, 0x00 } },
+	{ "INX_CPX_BNE", 3, { 0xE8, 0xE0, 0xD0 } }, //INX / CPX # / BNE
+	{ "INY_CPY_BNE", 3, { 0xC8, 0xC0, 0xD0 } }, //INY / CPY # / BNE
+	{ "CLC_ADC_IMM", 2, { 0x18, 0x69, 0x00 } }, //CLC / ADC #
+	{ "SEC_SBC_IMM", 2, { 0x38, 0xE9, 0x00 } } //SEC / SBC #
+};
+
+/// <summary>
+/// What fusion did since it was enabled, seen is per sequence (indexed by FUSED_SEQUENCES), the handlers themselves only keep a total of the instructions they ran
+/// </summary>
+struct FusionStats {
+	unsigned long long seen[FUSE_COUNT]; //times the sequence ran during the warm up, 0 for a profile loaded from a file
+	unsigned long long warmup_instructions; //length of the warm up
+	unsigned long long instructions; //all instructions run with fusion on, fused or not, after the warm up
+	unsigned long long fused_instructions; //the ones of those run inside a fused handler, whether they're any faster there is for bench to measure
+};
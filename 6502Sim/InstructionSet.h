@@ -0,0 +1,80 @@
+#pragma once
+
+/// <summary>
+/// an enumeration for the different addressing modes, for my own convenience, I'll be using this to avoid re-defining redundant instructions
+/// </summary>
+enum ADDRESS_MODES {
+	ACCUMULATOR, ABSOLUT, ABSOLUTE_X, ABSOLUTE_Y, IMMEDIATE, IMPLIED, INDIRECT, INDIRECT_X, INDIRECT_Y, RELATIV, ZEROPAGE, ZEROPAGE_X, ZEROPAGE_Y, ERR //err is for error, for JAM operations mainly
+};
+
+/// <summary>
+/// an enumeration for the different instructions, to allow me to have instructions conveniently referred to by type rather than instructing each variant of instruction possible
+/// </summary>
+enum INSTRUCTIONS {
+	ADC, AND, ASL, BCC, BCS, BEQ, BIT, BMI, BNE, BPL, BRK, BVC, BVS, CLC, CLD, CLI, CLV, CMP, CPX, CPY, DEC, DEX, DEY, EOR, INC, INX, INY, JMP, JSR, LDA, LDX, LDY, LSR, NOP, ORA, PHA, PHP, PLA, PLP, ROL, ROR, RTI, RTS, SBC, SEC, SED, SEI, STA, STX, STY, TAX, TAY, TSX, TXA, TXS, TYA, JAM //JAM is being used with all illegal instructions at the moment, which are not implemented at this point, albeit it may be contemplated, at which point I'll need to make custom instructions for them (for things like LAX and SBX instructions)
+};
+
+/// <summary>
+/// The decode tables, indexed [high nibble][low nibble] of the opcode. The processor decodes with these and the disassembler builds its own tables from them,
+/// so there's the one copy to get right. They did take quite a bit of time to translate to my code (and check for correctness)
+/// </summary>
+static constexpr ADDRESS_MODES ADDRESS_MODE_TABLE[16][16] =
+{
+	{IMPLIED,	INDIRECT_X,	ERR,		INDIRECT_X,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,	 ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
+	{ABSOLUT,	INDIRECT_X, ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,	 ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
+	{IMPLIED,	INDIRECT_X, ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
+	{IMPLIED,	INDIRECT_X,	ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  ACCUMULATOR,	IMMEDIATE,  INDIRECT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
+	{IMMEDIATE,	INDIRECT_X,	IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_Y, ZEROPAGE_Y, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_Y, ABSOLUTE_Y},
+	{IMMEDIATE, INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_Y, ZEROPAGE_Y, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_Y, ABSOLUTE_Y},
+	{IMMEDIATE,	INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
+	{IMMEDIATE, INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,	ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
+	{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X}
+};
+
+static constexpr INSTRUCTIONS INSTRUCTION_TABLE[16][16] =
+{
+	{BRK, ORA, JAM, JAM, JAM, ORA, ASL, JAM, PHP, ORA, ASL, JAM, JAM, ORA, ASL, JAM},
+	{BPL, ORA, JAM, JAM, JAM, ORA, ASL, JAM, CLC, ORA, JAM, JAM, JAM, ORA, ASL, JAM},
+	{JSR, AND, JAM, JAM, BIT, AND, ROL, JAM, PLP, AND, ROL, JAM, BIT, AND, ROL, JAM},
+	{BMI, AND, JAM, JAM, JAM, AND, ROL, JAM, SEC, AND, JAM, JAM, JAM, AND, ROL, JAM},
+	{RTI, EOR, JAM, JAM, JAM, EOR, LSR, JAM, PHA, EOR, LSR, JAM, JMP, EOR, LSR, JAM},
+	{BVC, EOR, JAM, JAM, JAM, EOR, LSR, JAM, CLI, EOR, JAM, JAM, JAM, EOR, LSR, JAM},
+	{RTS, ADC, JAM, JAM, JAM, ADC, ROR, JAM, PLA, ADC, ROR, JAM, JMP, ADC, ROR, JAM},
+	{BVS, ADC, JAM, JAM, JAM, ADC, ROR, JAM, SEI, ADC, JAM, JAM, JAM, ADC, ROR, JAM},
+	{JAM, STA, JAM, JAM, STY, STA, STX, JAM, DEY, JAM, TXA, JAM, STY, STA, STX, JAM},
+	{BCC, STA, JAM, JAM, STY, STA, STX, JAM, TYA, STA, TXS, JAM, JAM, STA, JAM, JAM},
+	{LDY, LDA, LDX, JAM, LDY, LDA, LDX, JAM, TAY, LDA, TAX, JAM, LDY, LDA, LDX, JAM},
+	{BCS, LDA, JAM, JAM, LDY, LDA, LDX, JAM, CLV, LDA, TSX, JAM, LDY, LDA, LDX, JAM},
+	{CPY, CMP, JAM, JAM, CPY, CMP, DEC, JAM, INY, CMP, DEX, JAM, CPY, CMP, DEC, JAM},
+	{BNE, CMP, JAM, JAM, JAM, CMP, DEC, JAM, CLD, CMP, JAM, JAM, JAM, CMP, DEC, JAM},
+	{CPX, SBC, JAM, JAM, CPX, SBC, INC, JAM, INX, SBC, NOP, JAM, CPX, SBC, INC, JAM},
+	{BEQ, SBC, JAM, JAM, JAM, SBC, INC, JAM, SED, SBC, JAM, JAM, JAM, SBC, INC, JAM}
+};
+
+//base cycle count of each opcode, page crossing and branch taken penalties are not included, opcodes the core treats as JAM count 2
+static constexpr unsigned char CYCLE_TABLE[16][16] =
+{
+	{7, 6, 2, 2, 2, 3, 5, 2, 3, 2, 2, 2, 2, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2},
+	{6, 6, 2, 2, 3, 3, 5, 2, 4, 2, 2, 2, 4, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2},
+	{6, 6, 2, 2, 2, 3, 5, 2, 3, 2, 2, 2, 3, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2},
+	{6, 6, 2, 2, 2, 3, 5, 2, 4, 2, 2, 2, 5, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2},
+	{2, 6, 2, 2, 3, 3, 3, 2, 2, 2, 2, 2, 4, 4, 4, 2},
+	{2, 6, 2, 2, 4, 4, 4, 2, 2, 5, 2, 2, 2, 5, 2, 2},
+	{2, 6, 2, 2, 3, 3, 3, 2, 2, 2, 2, 2, 4, 4, 4, 2},
+	{2, 5, 2, 2, 4, 4, 4, 2, 2, 4, 2, 2, 4, 4, 4, 2},
+	{2, 6, 2, 2, 3, 3, 5, 2, 2, 2, 2, 2, 4, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2},
+	{2, 6, 2, 2, 3, 3, 5, 2, 2, 2, 2, 2, 4, 4, 6, 2},
+	{2, 5, 2, 2, 2, 4, 6, 2, 2, 4, 2, 2, 2, 4, 7, 2}
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+/// <summary>
+/// Interface for memory mapped peripherals. A device is mapped onto a page of the RAM through Memory::map_device, after which every
+/// read or write on that page is handed to the device instead of the memory block, with the low byte of the address as the register number
+/// (so a device with only a few registers is mirrored across its page, just like the partial address decoding on real 6502 boards)
+/// </summary>
+class IoDevice
+{
+public:
+	virtual ~IoDevice() {}
+	virtual unsigned char read(unsigned char reg) = 0; //read from a device register, devices are allowed to have side effects on read (clearing status bits and such)
+	virtual void write(unsigned char reg, unsigned char value) = 0; //write to a device register
+};
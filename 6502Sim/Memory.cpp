@@ -1,4 +1,5 @@
 #include "Memory.h"
+#include <cstring>
 /// <summary>
 /// Standard destructor class, clean up used memory to prevent memory leaks
 /// </summary>
@@ -21,12 +22,71 @@ Memory::Memory(unsigned int memSize) {
 	_memsize = memSize;
 
 	_memblock = new unsigned char[memSize]; //generate a 
+	_owns_block = true;
+
+	init_pages(); //no devices or banks mapped to start with
 
 	clearMemory(); //clear the memory if it has anything in it
 }
 
+/// <summary>
+/// Constructor for a memory block that lives somewhere else, like a shared memory mapping that other processes read, same size limits as above
+/// </summary>
+/// <param name="memSize">Size of the block</param>
+/// <param name="storage">at least memSize bytes, which have to outlive the Memory</param>
+Memory::Memory(unsigned int memSize, unsigned char* storage) {
+	if (memSize < 2048 || memSize > 65536 || storage == nullptr) {
+		throw 4;
+	}
+	_memsize = memSize;
+	_memblock = storage;
+	_owns_block = false;
+
+	init_pages();
+
+	clearMemory();
+}
+
+/// <summary>
+/// Sets up the page table for a Memory with nothing mapped over it, every page inside the block points straight at it
+/// </summary>
+void Memory::init_pages() {
+	for (int i = 0; i < 256; i++) {
+		_io_pages[i] = nullptr;
+		_mapped_pages[i] = nullptr;
+		update_page((unsigned char)i);
+	}
+	for (int i = 0; i < 4; i++) {
+		_read_only_pages[i] = 0;
+		_dirty_pages[i] = 0;
+	}
+}
+
+/// <summary>
+/// Works out where a page's reads and writes go from the device, mapping and block underneath it, in that order.
+/// A page only gets a pointer when an access can go straight to it, so read/write only ever need the one lookup
+/// </summary>
+void Memory::update_page(unsigned char page) {
+	unsigned char* target = nullptr;
+	bool writable = true;
+	if (_mapped_pages[page] != nullptr) {
+		target = _mapped_pages[page];
+		writable = !((_read_only_pages[page >> 6] >> (page & 63)) & 1);
+	}
+	else if ((page + 1u) * 256u <= _memsize) {
+		target = _memblock + page * 256; //only whole pages, a short last page keeps its bounds check in the slow path
+	}
+	if (_io_pages[page] != nullptr) {
+		target = nullptr; //devices see every access
+	}
+	_read_pages[page] = target;
+	_write_pages[page] = writable ? target : nullptr;
+}
+
 Memory::~Memory() {
-	delete[] _memblock; //de-allocate the memory used in the memory block
+	if (_owns_block) {
+		delete[] _memblock; //de-allocate the memory used in the memory block
+	}
 }
 
 /// <summary>
@@ -36,6 +96,7 @@ void Memory::clearMemory() {
 	for (int i = 0; i < _memsize; i++) {
 		_memblock[i] = 0x00; //set binary value of memblock to 00000000
 	}
+	mark_all_dirty(); //everything changed as far as anyone watching is concerned
 }
 
 /// <summary>
@@ -49,7 +110,7 @@ void Memory::clearMemory() {
 unsigned short Memory::bytesToArrayOffset(unsigned char offsetHigh, unsigned char offsetLow) {
 	unsigned short retValue = 0x0000; //ensure that the variable is a clean 
 	retValue = offsetHigh;
-	retValue << 8; //shift bits left 8 places (for high bits of address)
+	retValue = retValue << 8; //shift bits left 8 places (for high bits of address)
 	retValue = retValue | offsetLow; //bitwise or function to add in the low (and yes Visual Studio, bitwise OR was intended)
 
 	return retValue;
@@ -61,14 +122,20 @@ unsigned short Memory::bytesToArrayOffset(unsigned char offsetHigh, unsigned cha
 /// <param name="addr">the address being checked</param>
 /// <returns></returns>
 bool Memory::checkAddress(unsigned short addr) {
-	if (addr > _memsize) {
-		return false; //if addr is bigger than _memsize, return false
+	if (addr >= _memsize) {
+		return false; //if addr is past the end of the block, return false
 	}
 	return true; //otherwise return true
 }
 
 
-unsigned char Memory::read(unsigned char offsetHigh, unsigned char offsetLow) {
+/// <summary>
+/// Everything read() can't do with a straight page lookup: devices, and addresses the page table has nothing for (which might still be on a short last page)
+/// </summary>
+unsigned char Memory::read_slow(unsigned char offsetHigh, unsigned char offsetLow) {
+	if (_io_pages[offsetHigh] != nullptr) {
+		return _io_pages[offsetHigh]->read(offsetLow); //the page belongs to a device, so it gets the access instead of the memory block
+	}
 	unsigned short addr = bytesToArrayOffset(offsetHigh, offsetLow);
 	if (!checkAddress(addr)) {
 		throw 5; //error code for invalid memory address
@@ -77,15 +144,184 @@ unsigned char Memory::read(unsigned char offsetHigh, unsigned char offsetLow) {
 }
 
 
-void Memory::write(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value) {
+void Memory::write_slow(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value) {
+	if (_io_pages[offsetHigh] != nullptr) {
+		_io_pages[offsetHigh]->write(offsetLow, value);
+		return;
+	}
+	if (_mapped_pages[offsetHigh] != nullptr) {
+		return; //a read only bank, the write goes nowhere, like writing to a ROM chip
+	}
 	unsigned short addr = bytesToArrayOffset(offsetHigh, offsetLow);
 	if (!checkAddress(addr)) {
 		throw 5; //error code for invalid memory address
 	}
 
 	_memblock[addr] = value; //write the value to the address
+	_dirty_pages[offsetHigh >> 6] |= 1ULL << (offsetHigh & 63);
+}
+
+/// <summary>
+/// Hands out a page's own pointer from the page table, only when reads and writes both go straight to it. The pointer is good until the page's mapping changes
+/// (map_device, map_page and the unmaps), so whoever keeps it has to ask again after any of those
+/// </summary>
+unsigned char* Memory::get_direct_page(unsigned char page) {
+	if (_read_pages[page] != _write_pages[page]) {
+		return nullptr; //a read only bank
+	}
+	return _read_pages[page];
 }
 
 unsigned int Memory::get_size() {
 	return _memsize;
+}
+
+/// <summary>
+/// Copies a range of the memory block out in one go, this goes straight to the block, so any devices mapped over the range are not touched (reading a device can have side effects)
+/// and neither are banks mapped with map_page, they belong to whoever mapped them (see BankController)
+/// </summary>
+/// <param name="dest">buffer of at least count bytes</param>
+/// <param name="start">first address to copy</param>
+/// <param name="count">number of bytes</param>
+void Memory::copy_out(unsigned char* dest, unsigned int start, unsigned int count) {
+	if (start > _memsize || count > _memsize - start) {
+		throw 5; //same error code as an invalid address on a single read
+	}
+	memcpy(dest, _memblock + start, count);
+}
+
+void Memory::copy_in(const unsigned char* src, unsigned int start, unsigned int count) {
+	if (start > _memsize || count > _memsize - start) {
+		throw 5;
+	}
+	memcpy(_memblock + start, src, count);
+	mark_dirty(start, count);
+}
+
+/// <summary>
+/// Sets the dirty bit of every page that overlaps the given range
+/// </summary>
+void Memory::mark_dirty(unsigned int start, unsigned int count) {
+	if (count == 0) {
+		return;
+	}
+	unsigned int last = (start + count - 1) >> 8;
+	for (unsigned int page = start >> 8; page <= last; page++) {
+		_dirty_pages[page >> 6] |= 1ULL << (page & 63);
+	}
+}
+
+void Memory::mark_all_dirty() {
+	mark_dirty(0, _memsize);
+}
+
+bool Memory::is_page_dirty(unsigned char page) {
+	return (_dirty_pages[page >> 6] >> (page & 63)) & 1;
+}
+
+/// <summary>
+/// Hands out everything written since the last call as a list of address ranges, so a consumer (memory viewer, trace writer, snapshot delta) only has to look at what changed
+/// runs of dirty pages are merged into one range, and the bits are cleared as they are handed out, so there should only be one consumer per Memory
+/// writes that went to a mapped device don't count, the memory block underneath didn't change
+/// </summary>
+/// <param name="ranges">cleared, then filled with the changed ranges in address order</param>
+void Memory::get_changes(std::vector<MemoryRange>& ranges) {
+	ranges.clear();
+	for (unsigned int word = 0; word < 4; word++) {
+		unsigned long long bits = _dirty_pages[word];
+		_dirty_pages[word] = 0;
+		unsigned int page = word * 64;
+		while (bits != 0) {
+			if (bits & 1) {
+				unsigned int start = page << 8;
+				if (!ranges.empty() && ranges.back().start + ranges.back().length == start) {
+					ranges.back().length += 256; //carries on from the previous page
+				}
+				else {
+					MemoryRange range;
+					range.start = start;
+					range.length = 256;
+					ranges.push_back(range);
+				}
+			}
+			bits >>= 1;
+			page++;
+		}
+	}
+	//banks mapped past the end of the block get written to as well, but they aren't part of the block, so they're left out
+	while (!ranges.empty() && ranges.back().start >= _memsize) {
+		ranges.pop_back();
+	}
+	//the last page can be short when the memory size isn't a multiple of 256
+	if (!ranges.empty() && ranges.back().start + ranges.back().length > _memsize) {
+		ranges.back().length = _memsize - ranges.back().start;
+	}
+}
+
+/// <summary>
+/// Maps a memory mapped device over a page, every read/write to that page goes to the device from now on
+/// </summary>
+/// <param name="page">high byte of the addresses the device should answer to</param>
+/// <param name="device">the device, which has to outlive the mapping</param>
+void Memory::map_device(unsigned char page, IoDevice* device) {
+	_io_pages[page] = device;
+	update_page(page);
+}
+
+void Memory::unmap_device(unsigned char page) {
+	_io_pages[page] = nullptr;
+	update_page(page);
+}
+
+/// <summary>
+/// Maps 256 bytes of host memory over a page, from now on the page reads (and writes, if writable) those bytes instead of the block, which is left as it was underneath.
+/// The page can be anywhere in the 64K, including past the end of the block, and a device mapped over the same page still comes first.
+/// </summary>
+/// <param name="page">high byte of the addresses</param>
+/// <param name="host">256 bytes, which have to stay put until the page is unmapped or mapped to something else</param>
+/// <param name="writable">false to drop writes to the page (ROM banks)</param>
+void Memory::map_page(unsigned char page, unsigned char* host, bool writable) {
+	map_pages(page, 1, host, writable);
+}
+
+/// <summary>
+/// Maps count pages of consecutive host memory from first_page up, this is what a bank switch comes down to, so it's kept to a pass over
+/// the page table entries with the bitmaps done a word at a time, instead of going through map_page and update_page for every page
+/// </summary>
+void Memory::map_pages(unsigned char first_page, unsigned int count, unsigned char* host, bool writable) {
+	if (host == nullptr || first_page + count > 256) {
+		throw 5;
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned int page = first_page + i;
+		unsigned char* target = host + i * 256;
+		_mapped_pages[page] = target;
+		if (_io_pages[page] != nullptr) {
+			target = nullptr;
+		}
+		_read_pages[page] = target;
+		_write_pages[page] = writable ? target : nullptr;
+	}
+	//what the pages show has changed, even though nothing was written, and the read only bits follow the new mapping
+	unsigned int page = first_page;
+	unsigned int last = first_page + count;
+	while (page < last) {
+		unsigned int bits = (last - page < 64 - (page & 63)) ? last - page : 64 - (page & 63);
+		unsigned long long mask = (bits == 64 ? ~0ULL : ((1ULL << bits) - 1)) << (page & 63);
+		_dirty_pages[page >> 6] |= mask;
+		if (writable) {
+			_read_only_pages[page >> 6] &= ~mask;
+		}
+		else {
+			_read_only_pages[page >> 6] |= mask;
+		}
+		page += bits;
+	}
+}
+
+void Memory::unmap_page(unsigned char page) {
+	_mapped_pages[page] = nullptr;
+	_read_only_pages[page >> 6] &= ~(1ULL << (page & 63));
+	update_page(page);
+	_dirty_pages[page >> 6] |= 1ULL << (page & 63);
 }
\ No newline at end of file
@@ -1,4 +1,14 @@
 #pragma once
+#include "IoDevice.h"
+#include <vector>
+
+/// <summary>
+/// A range of addresses that were written to, as handed out by Memory::get_changes, page granular so start is always a multiple of 256
+/// </summary>
+struct MemoryRange {
+	unsigned int start;
+	unsigned int length;
+};
 
 /// <summary>
 /// This is the Memory Class, it will contain our memory, it really only needs a few functions, as it's job is to intialize a block of memory, then access or store memory based on an input binary address, and clear it when necessary
@@ -10,15 +20,59 @@ class Memory
 private:
 	unsigned char* _memblock; //I'm using a char as it is a 8-bit variable, which we're going to use, since we're using 8 bit memory slots 
 	unsigned int _memsize; //a variable for storing the size of the memory
+	bool _owns_block; //false when the block belongs to someone else (a shared memory mapping), so the destructor leaves it alone
 	unsigned short bytesToArrayOffset(unsigned char offsetHigh, unsigned char offsetLow); //a function that will take care of address translation based on two 8-bit inputs, will be needed for addressing, since I can't just char/8 as
 	bool checkAddress(unsigned short addr); //to ensure the address provided is valid given the size of the Memory
+	IoDevice* _io_pages[256]; //memory mapped devices, one slot per 256 byte page, nullptr for plain memory
+	unsigned char* _mapped_pages[256]; //host pages mapped over the block (banks, see map_page), nullptr where the page is the block's own
+	unsigned long long _read_only_pages[4]; //one bit per mapped page that ignores writes (cartridge ROM and such)
+	//the page table every access goes through, a pointer to the 256 bytes a page reads from and writes to, nullptr sends the access down the slow path
+	//(a device, a read only page, the last page when the size isn't a multiple of 256, or a page past the end), worked out again by update_page whenever a mapping changes
+	unsigned char* _read_pages[256];
+	unsigned char* _write_pages[256];
+	unsigned long long _dirty_pages[4]; //one bit per 256 byte page, set on every write to the page and cleared when get_changes hands the page out
+	void mark_dirty(unsigned int start, unsigned int count);
+	void init_pages();
+	void update_page(unsigned char page);
+	unsigned char read_slow(unsigned char offsetHigh, unsigned char offsetLow);
+	void write_slow(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value);
 
 public:
 	Memory(); //default constructor which I will not be using in my case, but there for good practice
 	Memory(unsigned int memSize); //the actual constructor which we will use, 
+	Memory(unsigned int memSize, unsigned char* storage); //same, but on a block the caller provides and keeps ownership of (shared memory), the block gets cleared
 	~Memory(); //our decstructor, to deal with our memory block on destruction
 	void clearMemory(); // a function for clearing the memory (aka: setting everything to 0x00) 
-	unsigned char read(unsigned char offsetHigh, unsigned char offsetLow);
-	void write(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value);
+	//reads and writes are here in the header so the processor gets the page table lookup inlined, anything that isn't a plain page goes to read_slow/write_slow
+	unsigned char read(unsigned char offsetHigh, unsigned char offsetLow) {
+		unsigned char* page = _read_pages[offsetHigh];
+		if (page != nullptr) {
+			return page[offsetLow];
+		}
+		return read_slow(offsetHigh, offsetLow);
+	}
+	void write(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value) {
+		unsigned char* page = _write_pages[offsetHigh];
+		if (page != nullptr) {
+			page[offsetLow] = value;
+			_dirty_pages[offsetHigh >> 6] |= 1ULL << (offsetHigh & 63); //flag the page as changed, cheap enough to do on every write
+			return;
+		}
+		write_slow(offsetHigh, offsetLow, value);
+	}
+	unsigned char* get_direct_page(unsigned char page); //the page's bytes, for a caller that wants to skip the page table (the processor's zero page and stack), nullptr unless the page is plain memory for both reads and writes
+	void mark_page_written(unsigned char page) { //for writes made through get_direct_page, so they still show up in get_changes
+		_dirty_pages[page >> 6] |= 1ULL << (page & 63);
+	}
 	unsigned int get_size();
+	void copy_out(unsigned char* dest, unsigned int start, unsigned int count); //bulk copy of the memory block (devices are not read), for snapshots and bulk peeks
+	void copy_in(const unsigned char* src, unsigned int start, unsigned int count); //bulk copy into the memory block, the reverse of copy_out
+	void get_changes(std::vector<MemoryRange>& ranges); //fills ranges with the pages written since the last call (adjacent pages merged into one range) and clears the dirty bits
+	bool is_page_dirty(unsigned char page);
+	void mark_all_dirty(); //forces the whole memory to show up in the next get_changes, for a consumer that has lost track (a viewer being recreated and such)
+	void map_device(unsigned char page, IoDevice* device); //map a device over a page of this memory, the Memory does not take ownership of the device
+	void unmap_device(unsigned char page);
+	void map_page(unsigned char page, unsigned char* host, bool writable); //show 256 bytes of host memory at a page instead of the block (bank switching), nothing is copied, the Memory does not take ownership
+	void map_pages(unsigned char first_page, unsigned int count, unsigned char* host, bool writable); //same for a run of pages over consecutive host memory, a whole bank in one call
+	void unmap_page(unsigned char page); //back to the block (or to nothing, for a page past the end of it)
 };
\ No newline at end of file
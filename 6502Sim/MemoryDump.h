@@ -0,0 +1,152 @@
+#pragma once
+#include <cstring>
+
+/// <summary>
+/// Enum for the formats a memory dump can be rendered in
+/// </summary>
+enum DUMP_FORMATS {
+	DUMP_HEX, DUMP_BINARY
+};
+
+/// <summary>
+/// How a dump is laid out, bytes_per_row bytes per line, optionally led by the address of the first byte ("0400: ")
+/// </summary>
+struct DumpLayout {
+	DUMP_FORMATS format;
+	unsigned int bytes_per_row;
+	bool show_address;
+	bool crlf; //\r\n line endings, which is what a multiline Win32 edit control wants
+};
+
+/// <summary>
+/// Renders memory to text, portable (no Win32 in here) and templated on the character type so the GUI can use wchar_t and command line tools char.
+/// Every byte goes through a 256 entry table of ready made cells ("FF " or "11111111 "), so rendering a byte is a single fixed size memcpy, which the compiler
+/// turns into one or two vector moves, instead of building the digits a bit at a time. It works straight off a block of bytes (see Processor::copy_ram)
+/// rather than going through the processor one byte at a time, and the row functions only render the window of rows being asked for.
+/// </summary>
+template <typename CharT>
+class MemoryDump
+{
+private:
+	static const unsigned int HEX_CELL = 3; //two digits and a space
+	static const unsigned int BINARY_CELL = 9; //eight digits and a space
+
+	struct Tables {
+		CharT hex[256][4]; //padded to 4 so the entries stay aligned, only the first HEX_CELL are copied
+		CharT binary[256][BINARY_CELL];
+		CharT hex_digits[16];
+
+		Tables() {
+			const char* digits = "0123456789ABCDEF";
+			for (int i = 0; i < 16; i++) {
+				hex_digits[i] = (CharT)digits[i];
+			}
+			for (int value = 0; value < 256; value++) {
+				hex[value][0] = hex_digits[value >> 4];
+				hex[value][1] = hex_digits[value & 0x0F];
+				hex[value][2] = (CharT)' ';
+				hex[value][3] = (CharT)' ';
+				for (int bit = 0; bit < 8; bit++) {
+					binary[value][bit] = (value >> (7 - bit)) & 1 ? (CharT)'1' : (CharT)'0'; //most significant bit first, the way it reads
+				}
+				binary[value][8] = (CharT)' ';
+			}
+		}
+	};
+
+	static const Tables& tables() {
+		static const Tables built; //built on first use, thread safe since C++11
+		return built;
+	}
+
+public:
+	/// <summary>
+	/// Number of characters one byte takes up, including the space after it
+	/// </summary>
+	static unsigned int cell_width(DUMP_FORMATS format) {
+		return format == DUMP_HEX ? HEX_CELL : BINARY_CELL;
+	}
+
+	/// <summary>
+	/// Writes just the digits of a single byte (2 or 8 characters, no space and no terminator), for register readouts
+	/// </summary>
+	static void format_byte(unsigned char value, DUMP_FORMATS format, CharT* output) {
+		if (format == DUMP_HEX) {
+			memcpy(output, tables().hex[value], 2 * sizeof(CharT));
+		}
+		else {
+			memcpy(output, tables().binary[value], 8 * sizeof(CharT));
+		}
+	}
+
+	/// <summary>
+	/// Renders count bytes as one run of cells, writing exactly count * cell_width(format) characters and no terminator,
+	/// so it can be used to patch part of a bigger buffer in place (the RAM viewer redraws only the pages that changed this way)
+	/// </summary>
+	static void render_bytes(const unsigned char* bytes, unsigned int count, DUMP_FORMATS format, CharT* output) {
+		const Tables& t = tables();
+		if (format == DUMP_HEX) {
+			for (unsigned int i = 0; i < count; i++) {
+				memcpy(output + i * HEX_CELL, t.hex[bytes[i]], HEX_CELL * sizeof(CharT));
+			}
+		}
+		else {
+			for (unsigned int i = 0; i < count; i++) {
+				memcpy(output + i * BINARY_CELL, t.binary[bytes[i]], BINARY_CELL * sizeof(CharT));
+			}
+		}
+	}
+
+	/// <summary>
+	/// Number of characters a full row takes up, line ending included
+	/// </summary>
+	static unsigned int row_length(const DumpLayout& layout) {
+		return (layout.show_address ? 6 : 0) + layout.bytes_per_row * cell_width(layout.format) + (layout.crlf ? 2 : 1);
+	}
+
+	/// <summary>
+	/// Number of rows it takes to show memory_size bytes, none for a layout with no bytes per row (so render_rows renders nothing for it)
+	/// </summary>
+	static unsigned int row_count(const DumpLayout& layout, unsigned int memory_size) {
+		if (layout.bytes_per_row == 0) {
+			return 0;
+		}
+		return (memory_size + layout.bytes_per_row - 1) / layout.bytes_per_row;
+	}
+
+	/// <summary>
+	/// Renders a window of rows out of a block of memory, rows past the end of the memory are left out and the last row may be short
+	/// the output needs room for rows * row_length(layout) + 1 characters, it gets null terminated, and the number of characters written (minus the terminator) is returned
+	/// </summary>
+	/// <param name="memory">the memory being shown, from address 0</param>
+	/// <param name="memory_size">size of memory</param>
+	/// <param name="first_row">first row of the window</param>
+	/// <param name="rows">number of rows in the window</param>
+	static unsigned int render_rows(const unsigned char* memory, unsigned int memory_size, const DumpLayout& layout, unsigned int first_row, unsigned int rows, CharT* output) {
+		const Tables& t = tables();
+		CharT* out = output;
+		unsigned int total_rows = row_count(layout, memory_size);
+		unsigned int last_row = first_row + rows < total_rows ? first_row + rows : total_rows;
+		for (unsigned int row = first_row; row < last_row; row++) {
+			unsigned int start = row * layout.bytes_per_row;
+			unsigned int count = memory_size - start < layout.bytes_per_row ? memory_size - start : layout.bytes_per_row;
+			if (layout.show_address) {
+				out[0] = t.hex_digits[(start >> 12) & 0x0F];
+				out[1] = t.hex_digits[(start >> 8) & 0x0F];
+				out[2] = t.hex_digits[(start >> 4) & 0x0F];
+				out[3] = t.hex_digits[start & 0x0F];
+				out[4] = (CharT)':';
+				out[5] = (CharT)' ';
+				out += 6;
+			}
+			render_bytes(memory + start, count, layout.format, out);
+			out += count * cell_width(layout.format);
+			if (layout.crlf) {
+				*out++ = (CharT)'\r';
+			}
+			*out++ = (CharT)'\n';
+		}
+		*out = (CharT)'\0';
+		return (unsigned int)(out - output);
+	}
+};
@@ -0,0 +1,120 @@
+#include "MemoryHeatmap.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+HeatmapHooks::HeatmapHooks() : _reads(65536, 0), _writes(65536, 0) {
+	reset();
+}
+
+void HeatmapHooks::reset() {
+	_reads.assign(65536, 0);
+	_writes.assign(65536, 0);
+	_started = false;
+	_start_sp = 0xFF;
+	_lowest_sp = 0xFF;
+}
+
+unsigned int HeatmapHooks::stack_bytes_used() const {
+	return _started ? (unsigned int)(_start_sp - _lowest_sp) : 0;
+}
+
+void HeatmapHooks::write_csv(FILE* output, SymbolTable& symbols) const {
+	fprintf(output, "address,symbol,reads,writes\n");
+	for (unsigned int address = 0; address < 65536; address++) {
+		if (_reads[address] != 0 || _writes[address] != 0) {
+			const Symbol* symbol = symbols.lookup((unsigned short)address);
+			fprintf(output, "$%04X,%s,%u,%u\n", address, symbol != nullptr ? symbols.describe((unsigned short)address).c_str() : "", _reads[address], _writes[address]);
+		}
+	}
+}
+
+/// <summary>
+/// Writes the heatmap as an uncompressed 24 bit BMP, which every image viewer opens, page $00 is the top row.
+/// Intensity is log(1 + count) over log(1 + the highest count), so addresses touched a handful of times still show up next to ones touched millions of times
+/// </summary>
+bool HeatmapHooks::write_bmp(const char* path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	const unsigned int side = 256;
+	const unsigned int pixels_size = side * side * 3; //rows of 768 bytes, already a multiple of 4 so no padding
+	const unsigned int file_size = 54 + pixels_size;
+	unsigned char header[54] = { 0 };
+	header[0] = 'B';
+	header[1] = 'M';
+	for (int i = 0; i < 4; i++) {
+		header[2 + i] = (unsigned char)(file_size >> (i * 8));
+		header[18 + i] = (unsigned char)(side >> (i * 8)); //width
+		header[22 + i] = (unsigned char)(side >> (i * 8)); //height, positive so rows go bottom up
+		header[34 + i] = (unsigned char)(pixels_size >> (i * 8));
+	}
+	header[10] = 54; //pixel data offset
+	header[14] = 40; //info header size
+	header[26] = 1; //planes
+	header[28] = 24; //bits per pixel
+
+	unsigned int most = 1;
+	for (unsigned int address = 0; address < 65536; address++) {
+		most = std::max(most, std::max(_reads[address], _writes[address]));
+	}
+	double scale = 255.0 / std::log(1.0 + (double)most);
+
+	std::vector<unsigned char> pixels(pixels_size);
+	for (unsigned int page = 0; page < side; page++) {
+		unsigned char* row = &pixels[(side - 1 - page) * side * 3];
+		for (unsigned int offset = 0; offset < side; offset++) {
+			unsigned int address = (page << 8) | offset;
+			row[offset * 3 + 0] = 0; //blue
+			row[offset * 3 + 1] = (unsigned char)(std::log(1.0 + (double)_reads[address]) * scale);
+			row[offset * 3 + 2] = (unsigned char)(std::log(1.0 + (double)_writes[address]) * scale);
+		}
+	}
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)pixels.data(), pixels.size());
+	return file.good();
+}
+
+/// <summary>
+/// Lists the top zero page locations by accesses, then the top written ones above the stack page,
+/// which are the variables that would save a cycle and a byte per access in the zero page, and the stack's high water mark
+/// </summary>
+void HeatmapHooks::write_zero_page_summary(FILE* output, SymbolTable& symbols, unsigned int top) const {
+	std::vector<std::pair<unsigned long long, unsigned short> > zero_page;
+	std::vector<std::pair<unsigned long long, unsigned short> > elsewhere;
+	unsigned int zero_page_used = 0;
+	for (unsigned int address = 0; address < 65536; address++) {
+		unsigned long long accesses = (unsigned long long)_reads[address] + _writes[address];
+		if (accesses == 0) {
+			continue;
+		}
+		if (address < 0x100) {
+			zero_page.push_back(std::make_pair(accesses, (unsigned short)address));
+			zero_page_used++;
+		}
+		else if (address >= 0x200 && _writes[address] != 0) {
+			elsewhere.push_back(std::make_pair(accesses, (unsigned short)address)); //only written addresses, which takes out code and tables in ROM
+		}
+	}
+	auto busiest_first = [](const std::pair<unsigned long long, unsigned short>& left, const std::pair<unsigned long long, unsigned short>& right) {
+		return left.first != right.first ? left.first > right.first : left.second < right.second;
+	};
+	std::sort(zero_page.begin(), zero_page.end(), busiest_first);
+	std::sort(elsewhere.begin(), elsewhere.end(), busiest_first);
+
+	fprintf(output, "stack: started at $%02X, lowest $%02X, %u bytes used\n", _start_sp, _lowest_sp, stack_bytes_used());
+	fprintf(output, "zero page: %u of 256 locations used\n\n", zero_page_used);
+	fprintf(output, "%-7s %12s %12s  %s\n", "zp", "reads", "writes", "symbol");
+	for (size_t i = 0; i < zero_page.size() && i < top; i++) {
+		unsigned short address = zero_page[i].second;
+		fprintf(output, "$%02X     %12u %12u  %s\n", address, _reads[address], _writes[address], symbols.lookup(address) != nullptr ? symbols.describe(address).c_str() : "");
+	}
+	if (!elsewhere.empty()) {
+		fprintf(output, "\n%-7s %12s %12s  %s\n", "above", "reads", "writes", "symbol");
+		for (size_t i = 0; i < elsewhere.size() && i < top; i++) {
+			unsigned short address = elsewhere[i].second;
+			fprintf(output, "$%04X   %12u %12u  %s\n", address, _reads[address], _writes[address], symbols.lookup(address) != nullptr ? symbols.describe(address).c_str() : "");
+		}
+	}
+}
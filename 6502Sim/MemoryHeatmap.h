@@ -0,0 +1,60 @@
+#pragma once
+#include "ProcessorHooks.h"
+#include "Symbols.h"
+#include <cstdio>
+#include <vector>
+
+/// <summary>
+/// Hooks policy that counts the guest's reads and writes of every address and keeps the stack's high water mark, for sizing RAM and the stack of a target
+/// from a run, and for finding the variables that would gain most from being moved to the zero page.
+/// Counters are 32 bits and stop at their maximum instead of wrapping, so a long run can't make a hot address look cold.
+/// The high water mark is the lowest stack pointer seen after any instruction, which covers pushes, JSRs, BRK and stack pointer moves with TXS alike.
+/// </summary>
+class HeatmapHooks : public NullHooks
+{
+private:
+	std::vector<unsigned int> _reads;
+	std::vector<unsigned int> _writes;
+	bool _started;
+	unsigned char _start_sp;
+	unsigned char _lowest_sp;
+
+	static void count(unsigned int& counter) {
+		counter += counter != 0xFFFFFFFF;
+	}
+
+public:
+	HeatmapHooks();
+
+	void reset();
+
+	unsigned int reads(unsigned short address) const { return _reads[address]; }
+	unsigned int writes(unsigned short address) const { return _writes[address]; }
+	unsigned char get_start_sp() const { return _start_sp; } //stack pointer when the first instruction ran
+	unsigned char get_lowest_sp() const { return _lowest_sp; }
+	unsigned int stack_bytes_used() const; //from the starting stack pointer down to the lowest one, 0 before anything ran
+
+	void write_csv(FILE* output, SymbolTable& symbols) const; //address,symbol,reads,writes for every address that was touched
+	bool write_bmp(const char* path) const; //256x256 picture, one pixel per address, row per page, reads in green and writes in red on a log scale, false if it couldn't be written
+	void write_zero_page_summary(FILE* output, SymbolTable& symbols, unsigned int top) const; //the busiest zero page locations, and the busiest ones outside it that could move there
+
+	void on_read(unsigned short address, unsigned char /*value*/) {
+		count(_reads[address]);
+	}
+	void on_write(unsigned short address, unsigned char /*value*/) {
+		count(_writes[address]);
+	}
+
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		unsigned char sp = cpu.get_sp();
+		if (!_started) {
+			_started = true;
+			_start_sp = sp; //as it is after the first instruction, close enough unless that one pushes
+			_lowest_sp = sp;
+		}
+		if (sp < _lowest_sp) {
+			_lowest_sp = sp;
+		}
+	}
+};
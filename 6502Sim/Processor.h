@@ -1,7 +1,20 @@
 #pragma once
 #include "Memory.h"
+#include "InstructionSet.h"
+#include "CpuState.h"
+#include "ProcessorHooks.h"
+#include "Fusion.h"
 #include <fstream> //file input/output for c++, I'm going to use this for 
+#include <vector>
 
+class BankController;
+
+//for the few functions that have to be inlined even though they're big (execute_as, see ProcessorImpl.h)
+#if defined(_MSC_VER)
+#define PROCESSOR_FORCE_INLINE __forceinline
+#else
+#define PROCESSOR_FORCE_INLINE inline __attribute__((always_inline))
+#endif
 
 /// <summary>
 /// Processor info references that I'm using: 
@@ -11,97 +24,39 @@
 /// http://6502.org/tutorials/ //for a whole bunch of primers on all of the details of operations and components of the 6502
 /// </summary>
 
-/// <summary>
-/// an enumeration for the different addressing modes, for my own convenience, I'll be using this to avoid re-defining redundant instructions
-/// </summary>
-enum ADDRESS_MODES {
-	ACCUMULATOR, ABSOLUT, ABSOLUTE_X, ABSOLUTE_Y, IMMEDIATE, IMPLIED, INDIRECT, INDIRECT_X, INDIRECT_Y, RELATIV, ZEROPAGE, ZEROPAGE_X, ZEROPAGE_Y, ERR //err is for error, for JAM operations mainly
-};
 
 /// <summary>
-/// an enumeration for the different instructions, to allow me to have instructions conveniently referred to by type rather than instructing each variant of instruction possible
+/// A full copy of the processor, registers plus memory, used to save a point in a run and go back to it later (lockstep comparison, bisecting)
+/// the status is stored in the real 6502 bit order (see Processor::get_status)
 /// </summary>
-enum INSTRUCTIONS {
-	ADC, AND, ASL, BCC, BCS, BEQ, BIT, BMI, BNE, BPL, BRK, BVC, BVS, CLC, CLD, CLI, CLV, CMP, CPX, CPY, DEC, DEX, DEY, EOR, INC, INX, INY, JMP, JSR, LDA, LDX, LDY, LSR, NOP, ORA, PHA, PHP, PLA, PLP, ROL, ROR, RTI, RTS, SBC, SEC, SED, SEI, STA, STX, STY, TAX, TAY, TSX, TXA, TXS, TYA, JAM //JAM is being used with all illegal instructions at the moment, which are not implemented at this point, albeit it may be contemplated, at which point I'll need to make custom instructions for them (for things like LAX and SBX instructions)
+struct ProcessorSnapshot {
+	unsigned char pc_high;
+	unsigned char pc_low;
+	unsigned char a;
+	unsigned char x;
+	unsigned char y;
+	unsigned char sp;
+	unsigned char status;
+	bool jammed;
+	std::vector<unsigned char> ram;
+	std::vector<unsigned char> rom; //left empty when the RAM and ROM are the same memory
 };
 
 /// <summary>
-/// Enum for processor state, 
+/// The processor, templated on a hooks policy (see ProcessorHooks.h) that gets told about fetches, data reads and writes, retired instructions and interrupts.
+/// The definitions are in ProcessorImpl.h, Processor.cpp instantiates the stock policies, a tool with a policy of its own includes ProcessorImpl.h and instantiates it there
+/// (template class BasicProcessor<MyHooks>;).
 /// </summary>
-enum PROCESSOR_STATE {
-	FETCH, DECODE, EXECUTE, JAMMED
-};
-
-
-class Processor
+template <typename Hooks>
+class BasicProcessor
 {
 private:
-	//the tables for instructions and address modes (to be completed, these will be 2d arrays), and yes, they did take quite a bit of time to translate to my code (and check for correctness)
-	const ADDRESS_MODES address_table[16][16] =
-	{
-		{IMPLIED,	INDIRECT_X,	ERR,		INDIRECT_X,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,	 ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
-		{ABSOLUT,	INDIRECT_X, ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,	 ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
-		{IMPLIED,	INDIRECT_X, ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  ACCUMULATOR,	IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
-		{IMPLIED,	INDIRECT_X,	ERR,		INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  ACCUMULATOR,	IMMEDIATE,  INDIRECT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
-		{IMMEDIATE,	INDIRECT_X,	IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_Y, ZEROPAGE_Y, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_Y, ABSOLUTE_Y},
-		{IMMEDIATE, INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_Y, ZEROPAGE_Y, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_Y, ABSOLUTE_Y},
-		{IMMEDIATE,	INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,  ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X},
-		{IMMEDIATE, INDIRECT_X, IMMEDIATE,	INDIRECT_X, ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	ZEROPAGE,	IMPLIED, IMMEDIATE,  IMPLIED,		IMMEDIATE,	ABSOLUT,	ABSOLUT,	ABSOLUT,	ABSOLUT},
-		{RELATIV,	INDIRECT_Y, ERR,		INDIRECT_Y, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, ZEROPAGE_X, IMPLIED, ABSOLUTE_Y, IMPLIED,		ABSOLUTE_Y, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X, ABSOLUTE_X}
-	};
-	
-	const INSTRUCTIONS instruction_table[16][16] = 
-	{
-		{BRK, ORA, JAM, JAM, JAM, ORA, ASL, JAM, PHP, ORA, ASL, JAM, JAM, ORA, ASL, JAM},
-		{BPL, ORA, JAM, JAM, JAM, ORA, ASL, JAM, CLC, ORA, JAM, JAM, JAM, ORA, ASL, JAM},
-		{JSR, AND, JAM, JAM, BIT, AND, ROL, JAM, PLP, AND, ROL, JAM, BIT, AND, ROL, JAM},
-		{BMI, AND, JAM, JAM, JAM, AND, ROL, JAM, SEC, AND, JAM, JAM, JAM, AND, ROL, JAM},
-		{RTI, EOR, JAM, JAM, JAM, EOR, LSR, JAM, PHA, EOR, LSR, JAM, JMP, EOR, LSR, JAM},
-		{BVC, EOR, JAM, JAM, JAM, EOR, LSR, JAM, CLI, EOR, JAM, JAM, JAM, EOR, LSR, JAM},
-		{RTS, ADC, JAM, JAM, JAM, ADC, ROR, JAM, PLA, ADC, ROR, JAM, JMP, ADC, ROR, JAM},
-		{BVS, ADC, JAM, JAM, JAM, ADC, ROR, JAM, SEI, ADC, JAM, JAM, JAM, ADC, ROR, JAM},
-		{JAM, STA, JAM, JAM, STY, STA, STX, JAM, DEY, JAM, TXA, JAM, STY, STA, STX, JAM},
-		{BCC, STA, JAM, JAM, STY, STA, STX, JAM, TYA, STA, TXS, JAM, JAM, STA, JAM, JAM},
-		{LDY, LDA, LDX, JAM, LDY, LDA, LDX, JAM, TAY, LDA, TAX, JAM, LDY, LDA, LDX, JAM},
-		{BCS, LDA, JAM, JAM, LDY, LDA, LDX, JAM, CLV, LDA, TSX, JAM, LDY, LDA, LDX, JAM},
-		{CPY, CMP, JAM, JAM, CPY, CMP, DEC, JAM, INY, CMP, DEX, JAM, CPY, CMP, DEC, JAM},
-		{BNE, CMP, JAM, JAM, JAM, CMP, DEC, JAM, CLD, CMP, JAM, JAM, JAM, CMP, DEC, JAM},
-		{CPX, SBC, JAM, JAM, CPX, SBC, INC, JAM, INX, SBC, NOP, JAM, CPX, SBC, INC, JAM},
-		{BEQ, SBC, JAM, JAM, JAM, SBC, INC, JAM, SED, SBC, JAM, JAM, JAM, SBC, INC, JAM}
-	};
-	//both are const so that the values cannot be changed
+	//the instruction, address mode and cycle tables decode() looks opcodes up in are in InstructionSet.h, shared with the disassembler
 	
 	//instantiations of the enums above to be used for executing instructions in my model 
 	ADDRESS_MODES addr_mode;
 	INSTRUCTIONS inst;
 	
-	/// <summary>
-	/// breakdown of processor flag register into bitwise union/struct, so that I can address the bits of the status flag register individually
-	/// I learned of this trick, as well as got some ideas regarding the "structure" of my simulator (more or less future structure, if I decide to connect the modules to a "bus" with timing), from this video: https://www.youtube.com/watch?v=F8kx56OZQhg
-	/// note: I am not actually using any of the code from this video series (as far as I'm aware, although it may be similar as both involve 6502 emulation), I've actually only seen the first video, it's part of what gave me the idea of doing this project, and I did feel like sourcing where I learned the union/struct trick
-	/// </summary>
-	union sflag_reg {
-		struct {
-			//breakdown of flag register will go here
-			unsigned char n_flag : 1; //negative flag, common flag, it determines whether operation results in negative number (bit 7 of resultant operation's register is 1)
-			unsigned char o_flag : 1; //overflow flag, detects when a signed overflow has occured (so result is > 127 or < -127, I think is the range), has some interesting logic behind it
-			unsigned char rsvd : 1; //unused reserved bit, it will likely not be used here
-			unsigned char b_flag : 1; //break flag, it likely will not be that necessary for my purposes, as it is essentially used to determine software breaks, but I'll implement the instruction for it, so it does matter
-			unsigned char d_flag : 1; //decimal flag, used for determining whether the processor will operate in decimal mode, also called BCD mode, where operations are done with BCD numbers, not implemented specifically at the moment, but will likely be added after regular binary mode is complete
-			unsigned char id_flag : 1; //interrupt disable flag
-			unsigned char z_flag : 1; //zero flag, very useful flag, determines
-			unsigned char c_flag : 1; //carry flag, used when doing addition/subtraction to ensure that proper results are obtained 
-		};
-		unsigned char val;
-	};
-
 	/// <summary>
 	/// this union will be useful if I need to check individual bits of an operand
 	/// </summary>
@@ -119,16 +74,8 @@ private:
 		unsigned char val;
 	};
 
-	//stack pointer registers (6502 uses 16-bit stack pointer, just like it's addressing capabilities)
-	unsigned char pc_high;
-	unsigned char pc_low;
-	
-	// other registers: 
-	unsigned char a_reg; //accumulator
-	unsigned char x_reg; //index x
-	unsigned char y_reg; //index y
-	unsigned char sp_reg; //stack pointer
-	sflag_reg flags;
+	//the registers, the program counter (16-bit, just like it's addressing capabilities), the jam state and the cycle count, all in one block (see CpuState.h)
+	CpuState regs;
 	
 	
 						  
@@ -152,26 +99,111 @@ private:
 	Memory* ram;
 	Memory* rom;
 
-	//instantion of our processor state
-
-	PROCESSOR_STATE state;
-
 	//the output lines, which is the result of an operation
 	unsigned char output;
 
+	Hooks hooks; //instrumentation, all empty for a plain Processor
+
+	/// <summary>
+	/// An entry in the predecode cache, what decode() makes of the opcode last fetched from an address, and the fused sequence (if any) that starts there
+	/// </summary>
+	struct predecoded {
+		unsigned char opcode; //what the entry was decoded from, checked on every fetch, so code that has changed since gets decoded again
+		unsigned char sequence; //FUSED_SEQUENCES
+		unsigned char inst; //INSTRUCTIONS
+		unsigned char mode; //ADDRESS_MODES
+	};
+
+	//superinstruction fusion (see enable_fusion), all of it is skipped while predecode_cache is empty
+	std::vector<predecoded> predecode_cache; //one entry per address
+	unsigned long long fusion_warmup = 0; //instructions left to watch before the sequences are picked, 0 once they have been
+	FusionStats fusion_stats = FusionStats();
+	unsigned short fusion_history_pc[2] = { 0, 0 }; //the last two instructions run during the warm up, oldest first
+	unsigned char fusion_history_opcode[2] = { 0, 0 };
+	unsigned long long run_fused(unsigned long long count, unsigned long long cycle_target);
+	template <unsigned char Op1, INSTRUCTIONS Inst1, ADDRESS_MODES Mode1, unsigned char Op2, INSTRUCTIONS Inst2, ADDRESS_MODES Mode2,
+		unsigned char Op3 = 0x00, INSTRUCTIONS Inst3 = JAM, ADDRESS_MODES Mode3 = ERR>
+	PROCESSOR_FORCE_INLINE unsigned long long run_sequence(unsigned long long count, unsigned long long cycle_target, unsigned long long& fused, bool& stopped);
+	template <unsigned char Opcode, INSTRUCTIONS Inst, ADDRESS_MODES Mode>
+	PROCESSOR_FORCE_INLINE void execute_fused();
+	PROCESSOR_FORCE_INLINE unsigned char fetch_fused();
+	void predecode(predecoded& entry, unsigned char opcode);
+	void watch_warmup(unsigned short pc, unsigned char opcode);
+	void finish_warmup();
+
 	//internal functions for fetch, decode, and execute 
 	void fetch();
 	void decode();
 	void execute();
+	template <bool Stepped = true>
+	PROCESSOR_FORCE_INLINE void execute_as(INSTRUCTIONS op, ADDRESS_MODES mode); //the body of execute, see there
 	void increment_pc();
+	void set_alu_flags(unsigned char alu_flags); //applies the flags from an AluTables entry
+	void set_nz_flags(unsigned char value);
 	unsigned char little_to_big_endian(unsigned char input);
 
+	//data accesses made by instructions, which go through the hooks, with NullHooks they are the plain memory calls
+	unsigned char read_data(unsigned char address_high, unsigned char address_low) {
+		unsigned char value = ram->read(address_high, address_low);
+		hooks.on_read((unsigned short)((address_high << 8) | address_low), value);
+		return value;
+	}
+	void write_data(unsigned char address_high, unsigned char address_low, unsigned char value) {
+		ram->write(address_high, address_low, value);
+		hooks.on_write((unsigned short)((address_high << 8) | address_low), value);
+	}
+
+	//the zero page and the stack, the same as read_data/write_data with the page fixed, but straight through the pointers from refresh_fast_pages when there are some,
+	//so the most common accesses skip the memory's page table (the hooks and the dirty bits still see every one of them)
+	unsigned char* zero_page; //page 0 of the RAM, nullptr while a device is mapped over it
+	unsigned char* stack_page; //page 1, same
+	void refresh_fast_pages();
+	unsigned char read_zero_page(unsigned char address) {
+		if (zero_page == nullptr) {
+			return read_data(0x00, address);
+		}
+		unsigned char value = zero_page[address];
+		hooks.on_read(address, value);
+		return value;
+	}
+	void write_zero_page(unsigned char address, unsigned char value) {
+		if (zero_page == nullptr) {
+			write_data(0x00, address, value);
+			return;
+		}
+		zero_page[address] = value;
+		ram->mark_page_written(0x00);
+		hooks.on_write(address, value);
+	}
+	unsigned char read_stack(unsigned char sp) {
+		if (stack_page == nullptr) {
+			return read_data(0x01, sp);
+		}
+		unsigned char value = stack_page[sp];
+		hooks.on_read((unsigned short)(0x0100 | sp), value);
+		return value;
+	}
+	void write_stack(unsigned char sp, unsigned char value) {
+		if (stack_page == nullptr) {
+			write_data(0x01, sp, value);
+			return;
+		}
+		stack_page[sp] = value;
+		ram->mark_page_written(0x01);
+		hooks.on_write((unsigned short)(0x0100 | sp), value);
+	}
+
 public:
-	Processor(); //default constructor, defaults to 2KB RAM/ROM
-	Processor(unsigned int ram_size, unsigned int rom_size); //specific constructor for instantiating a different size of RAM/ROM
-	~Processor(); // our destructor, which will be used to clear up RAM/ROM pointers
+	BasicProcessor(); //default constructor, defaults to 2KB RAM/ROM
+	BasicProcessor(unsigned int ram_size, unsigned int rom_size); //specific constructor for instantiating a different size of RAM/ROM
+	explicit BasicProcessor(unsigned int memory_size); //constructor for a single memory shared by code and data (RAM and ROM are the same block)
+	BasicProcessor(unsigned int ram_size, unsigned char* ram_storage, unsigned int rom_size, unsigned char* rom_storage); //memory on blocks the caller owns (shared memory), passing the same block twice gives a unified memory
+	~BasicProcessor(); // our destructor, which will be used to clear up RAM/ROM pointers
 	//finally, the functions that I'll be able to use from outside the class itself, that the interface and controlling apparatus will use
 	void step(); // this function will be used to initiate the fetch-decode-execute cycle by the processor
+	unsigned long long run(unsigned long long count); //steps up to count instructions in one call (stopping early if the processor jams), returns how many were actually executed
+	unsigned long long run_cycles(unsigned long long budget); //runs whole instructions until at least budget cycles have gone by (or the processor jams), returns the number of instructions like run
+	unsigned long long get_cycles(); //base cycles executed since the processor was created
 	unsigned char get_output(); //this function will be used to get the resulting output from processor (aka, what would be on the data pins)
 	unsigned char get_pc_high(); //this function will be used to get the address pins (high bits)
 	unsigned char get_pc_low(); // same for low bits
@@ -180,17 +212,52 @@ public:
 	unsigned char get_x(); //for getting x register contents
 	unsigned char get_y(); //same for y
 	unsigned char get_sp(); //get stack pointer register
+	unsigned char get_status(); //status register in the real 6502 bit order (N V - B D I Z C from bit 7 down), unlike get_sflags which returns the bitfield as stored
+	void set_status(unsigned char status); //same bit order as get_status
+	void set_registers(unsigned char a, unsigned char x, unsigned char y, unsigned char sp); //set the accumulator, index and stack pointer registers directly (test vectors, snapshots)
 	bool get_readwrite(); //currently unused, but will be used to get the status of reading/writing pin, can be used if design is changed to implement timing and simulate actual processor hardware function
 	void reset(); //for resetting the CPU to initial status (should be pretty straightforward)
 	const char* get_state(); //will convert the processor state to a string (of some sort, c-style for now, likely will be changed to some Win32 string or something), and return it for the interface
 	void load_program(const char* filepath);
+	void load_program(const unsigned char* data, unsigned int size, unsigned short load_address = 0x0000); //same as above, but from a buffer already in memory (generated test programs and such)
+	void set_pc(unsigned char address_high, unsigned char address_low); //jump the program counter somewhere, this also un-jams the processor and puts it back into FETCH
+	bool is_jammed();
+	INSTRUCTIONS get_instruction(unsigned char opcode); //decode an opcode with the same tables the processor uses
+	ADDRESS_MODES get_address_mode(unsigned char opcode);
 	unsigned char get_rom_value(unsigned char address_high, unsigned char address_low);
 	unsigned char get_ram_value(unsigned char address_high, unsigned char address_low);
+	void set_ram_value(unsigned char address_high, unsigned char address_low, unsigned char value);
+	void copy_ram(unsigned char* dest, unsigned int start, unsigned int count); //bulk read of the RAM, for viewers and dumps, mapped devices are not read
+	void copy_rom(unsigned char* dest, unsigned int start, unsigned int count);
+	void load_ram(const unsigned char* src, unsigned int start, unsigned int count); //bulk write into the RAM, the reverse of copy_ram
+	void load_rom(const unsigned char* src, unsigned int start, unsigned int count);
+	void get_ram_changes(std::vector<MemoryRange>& ranges); //the RAM ranges written since the last call, see Memory::get_changes
+	void save_snapshot(ProcessorSnapshot& snapshot); //copy the registers and memory out
+	void load_snapshot(const ProcessorSnapshot& snapshot); //put the processor back to a saved snapshot, the memory sizes have to match the ones it was saved with
 	unsigned int get_rom_size();
 	unsigned int get_ram_size();
+	void map_device(unsigned char page, IoDevice* device); //map a peripheral (ACIA and such) over a page of the RAM, the device has to outlive the processor or be unmapped first
+	void unmap_device(unsigned char page);
+	void attach_banks(BankController& banks); //show a bank controller's windows to the processor (in the ROM as well, when it's separate), the controller has to outlive the processor or be detached first
+	const CpuState& get_cpu_state(); //all the registers in one block, for comparing and copying whole states
+	void set_cpu_state(const CpuState& state);
+	Hooks& get_hooks(); //the policy instance, to set up breakpoints, read counters and such
+	void enable_fusion(unsigned long long warmup_instructions = 1000000); //run common instruction sequences as one fused handler in run and run_cycles, the sequences are picked after watching warmup_instructions of the program
+	bool load_fusion_profile(const char* path); //enable fusion with the sequences and addresses in a profile file (from save_fusion_profile) instead of a warm up, false if the file can't be read
+	bool save_fusion_profile(const char* path); //write out the sequences picked, false if there's nothing to write (fusion off or still warming up) or the file can't be written
+	void disable_fusion();
+	const FusionStats& get_fusion_stats();
 
 	//functions I'm not sure how to implement yet, but will need
 	//void load_rom(//some sort of file input or something); //I will definitely need some sort of function for loading instructions into the ROM
 	
 };
 
+typedef BasicProcessor<NullHooks> Processor; //the processor everything uses unless it needs instrumentation
+
+//instantiated in Processor.cpp
+extern template class BasicProcessor<NullHooks>;
+extern template class BasicProcessor<CountingHooks>;
+extern template class BasicProcessor<TraceHooks>;
+extern template class BasicProcessor<BreakpointHooks>;
+
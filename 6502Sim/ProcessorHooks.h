@@ -0,0 +1,165 @@
+#pragma once
+#include "Disassembler.h"
+#include <cstdio>
+#include <vector>
+
+/// <summary>
+/// Enum for the kinds of interrupt the processor reports through on_interrupt, the core only has BRK and reset so far, IRQ and NMI are here for when it gets them
+/// </summary>
+enum INTERRUPT_KINDS {
+	INTERRUPT_RESET, INTERRUPT_BRK, INTERRUPT_IRQ, INTERRUPT_NMI
+};
+
+/// <summary>
+/// The hooks policy BasicProcessor is built on, and the one Processor uses: every hook is an empty inline function, so after inlining there is nothing left of them
+/// and a Processor runs exactly the code it did before there were hooks.
+/// A policy is any class with these members (it doesn't have to derive from this one, but deriving and hiding only the hooks it needs is the easy way to write one):
+///   on_fetch(address, opcode)          opcode fetched, before it's decoded
+///   on_read(address, value)            data read by an instruction (RAM, mapped devices included), operand bytes fetched from the ROM are not reported
+///   on_write(address, value)           data written by an instruction
+///   on_instruction_retired(cpu)        an instruction finished, cpu is the processor, already pointing at the next instruction
+///   on_interrupt(kind, address)        BRK executed or the processor reset, address is where the program counter was
+///   should_stop()                      checked after every instruction by run and run_cycles, true ends the run early
+/// The processor owns one instance of the policy (see BasicProcessor::get_hooks), so a policy can keep state.
+/// Processor.cpp only instantiates BasicProcessor on the stock policies in this file, a tool with a policy of its own includes ProcessorImpl.h and instantiates it itself.
+/// Host side accesses (get_ram_value, copy_ram, loading programs and snapshots) don't go through the hooks, only what the emulated program does.
+/// </summary>
+struct NullHooks {
+	void on_fetch(unsigned short /*address*/, unsigned char /*opcode*/) {}
+	void on_read(unsigned short /*address*/, unsigned char /*value*/) {}
+	void on_write(unsigned short /*address*/, unsigned char /*value*/) {}
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& /*cpu*/) {}
+	void on_interrupt(INTERRUPT_KINDS /*kind*/, unsigned short /*address*/) {}
+	bool should_stop() { return false; }
+};
+
+/// <summary>
+/// Counts everything that goes through the hooks, the cheapest useful policy, and a measure of what a hook costs at all
+/// </summary>
+struct CountingHooks : NullHooks {
+	unsigned long long fetches = 0;
+	unsigned long long reads = 0;
+	unsigned long long writes = 0;
+	unsigned long long instructions = 0;
+	unsigned long long interrupts = 0;
+
+	void on_fetch(unsigned short /*address*/, unsigned char /*opcode*/) { fetches++; }
+	void on_read(unsigned short /*address*/, unsigned char /*value*/) { reads++; }
+	void on_write(unsigned short /*address*/, unsigned char /*value*/) { writes++; }
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& /*cpu*/) { instructions++; }
+	void on_interrupt(INTERRUPT_KINDS /*kind*/, unsigned short /*address*/) { interrupts++; }
+};
+
+/// <summary>
+/// Writes a line per instruction (address, the instruction disassembled and the registers after it) to a file, plus a line for every data write, nothing is written until set_output is called.
+/// The operand bytes are read back from memory when the instruction retires, so an instruction that overwrites its own operand shows the new value.
+/// </summary>
+class TraceHooks : public NullHooks {
+private:
+	FILE* _output = nullptr;
+	unsigned short _address = 0; //of the instruction being traced
+	unsigned char _opcode = 0;
+
+public:
+	void set_output(FILE* output) { _output = output; } //nullptr turns tracing off again, the file isn't closed
+
+	void on_fetch(unsigned short address, unsigned char opcode) {
+		_address = address;
+		_opcode = opcode;
+	}
+	void on_write(unsigned short address, unsigned char value) {
+		if (_output != nullptr) {
+			fprintf(_output, "        $%04X <- $%02X\n", address, value);
+		}
+	}
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		if (_output != nullptr) {
+			unsigned char bytes[3] = { _opcode, 0, 0 };
+			for (unsigned int i = 1; i < Disassembler<char>::length(_opcode); i++) {
+				unsigned short address = (unsigned short)(_address + i);
+				bytes[i] = cpu.get_rom_value((unsigned char)(address >> 8), (unsigned char)address);
+			}
+			char text[Disassembler<char>::MAX_TEXT];
+			Disassembler<char>::disassemble(_address, bytes, text);
+			fprintf(_output, "$%04X %02X  %-12s a $%02X x $%02X y $%02X sp $%02X p $%02X%s\n", _address, _opcode, text, cpu.get_accumulator(), cpu.get_x(), cpu.get_y(), cpu.get_sp(),
+				cpu.get_status(), cpu.is_jammed() ? "  JAMMED" : "");
+		}
+	}
+	void on_interrupt(INTERRUPT_KINDS kind, unsigned short address) {
+		if (_output != nullptr) {
+			fprintf(_output, "        %s at $%04X\n", kind == INTERRUPT_BRK ? "BRK" : kind == INTERRUPT_RESET ? "RESET" : kind == INTERRUPT_IRQ ? "IRQ" : "NMI", address);
+		}
+	}
+};
+
+/// <summary>
+/// Stops run and run_cycles when the program counter lands on a breakpoint, so the instruction there hasn't run yet, running again carries on through it
+/// </summary>
+class BreakpointHooks : public NullHooks {
+private:
+	std::vector<unsigned char> _breakpoints = std::vector<unsigned char>(65536 / 8, 0); //one bit per address
+	bool _hit = false;
+
+public:
+	void set_breakpoint(unsigned short address, bool enabled) {
+		if (enabled) {
+			_breakpoints[address >> 3] |= (unsigned char)(1 << (address & 7));
+		}
+		else {
+			_breakpoints[address >> 3] &= (unsigned char)~(1 << (address & 7));
+		}
+	}
+	void clear_breakpoints() {
+		_breakpoints.assign(_breakpoints.size(), 0);
+	}
+
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		unsigned short pc = (unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low());
+		_hit = (_breakpoints[pc >> 3] >> (pc & 7)) & 1;
+	}
+	bool should_stop() {
+		bool hit = _hit;
+		_hit = false; //only stop once, the next run starts with the instruction on the breakpoint
+		return hit;
+	}
+};
+
+/// <summary>
+/// Runs two policies side by side, every hook goes to both and either one can stop a run, pairs nest for more than two
+/// </summary>
+template <typename First, typename Second>
+struct HookPair {
+	First first;
+	Second second;
+
+	void on_fetch(unsigned short address, unsigned char opcode) {
+		first.on_fetch(address, opcode);
+		second.on_fetch(address, opcode);
+	}
+	void on_read(unsigned short address, unsigned char value) {
+		first.on_read(address, value);
+		second.on_read(address, value);
+	}
+	void on_write(unsigned short address, unsigned char value) {
+		first.on_write(address, value);
+		second.on_write(address, value);
+	}
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		first.on_instruction_retired(cpu);
+		second.on_instruction_retired(cpu);
+	}
+	void on_interrupt(INTERRUPT_KINDS kind, unsigned short address) {
+		first.on_interrupt(kind, address);
+		second.on_interrupt(kind, address);
+	}
+	bool should_stop() {
+		bool stop_first = first.should_stop(); //both get asked, since a policy may reset itself when asked (BreakpointHooks does)
+		bool stop_second = second.should_stop();
+		return stop_first || stop_second;
+	}
+};
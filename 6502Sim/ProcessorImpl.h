@@ -0,0 +1,3492 @@
+#pragma once
+// ProcessorImpl.h : the definitions of BasicProcessor, kept out of Processor.h so only the files that instantiate a hooks policy have to compile them
+#include "Processor.h"
+#include "AluTables.h"
+#include "BankController.h"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+/// <summary>
+/// Default Constructor, initializes variables and creates RAM/ROM
+/// </summary>
+template <typename Hooks>
+BasicProcessor<Hooks>::BasicProcessor() {
+	//choose the first options for each, as they will not matter (they'll be updated at fetch anyway)
+	addr_mode = IMPLIED;
+	inst = BRK;
+	//start program counter and all other registers at 0 (the cycle count and the spare bytes of the state block too, so states compare cleanly)
+	memset(&regs, 0, sizeof(regs));
+	regs.sp = 0xFF; //set to FF as per Stack Pointer operation (page 2 FF to 00) https://www.cs.jhu.edu/~phi/csf/slides/lecture-6502-stack.pdf
+
+	read_write = 0; //set to read, although right now this function is unusued
+
+	//initialize RAM/ROM, casting our values as unsigned ints, just in case
+
+	ram = new Memory((unsigned int) 2048);
+	rom = new Memory((unsigned int) 2048);
+	refresh_fast_pages(); //direct pointers to the zero page and stack
+
+	//initialize the processor state to FETCH, allowing FETCH State
+	regs.state = FETCH;
+
+	AluTables::init(); //make sure the ADC/SBC tables are ready before the first instruction
+}
+
+/// <summary>
+/// the optional constructor
+/// </summary>
+/// <param name="ram_size">Size of the RAM, ensure to check that it is between accepted values (2048 and 65536)</param>
+/// <param name="rom_size">Size of the ROM, ensure to check that it is between accepted values (2048 and 65536)</param>
+template <typename Hooks>
+BasicProcessor<Hooks>::BasicProcessor(unsigned int ram_size, unsigned int rom_size) {
+	//choose the first options for each, as they will not matter (they'll be updated at fetch anyway)
+	addr_mode = IMPLIED;
+	inst = BRK;
+	//start program counter and all other registers at 0 (the cycle count and the spare bytes of the state block too, so states compare cleanly)
+	memset(&regs, 0, sizeof(regs));
+	regs.sp = 0xFF; //set to FF as per Stack Pointer operation (page 2 FF to 00) https://www.cs.jhu.edu/~phi/csf/slides/lecture-6502-stack.pdf
+
+	read_write = 0; //set to read, although right now this function is unusued
+
+	//initialize RAM/ROM, using user specified values
+	ram = new Memory(ram_size);
+	rom = new Memory(rom_size);
+	refresh_fast_pages(); //direct pointers to the zero page and stack
+
+	//initialize the processor state to FETCH, allowing FETCH State
+	regs.state = FETCH;
+
+	AluTables::init(); //make sure the ADC/SBC tables are ready before the first instruction
+}
+
+/// <summary>
+/// Constructor for a unified address space, the RAM and ROM are the same block of memory, which is how a real 6502 system sees it (code and data share the 64K)
+/// test ROMs like Klaus Dormann's functional test need this, since they keep their data right next to their code and modify it
+/// </summary>
+/// <param name="memory_size">Size of the shared memory, same limits as the RAM/ROM sizes (2048 to 65536)</param>
+template <typename Hooks>
+BasicProcessor<Hooks>::BasicProcessor(unsigned int memory_size) {
+	addr_mode = IMPLIED;
+	inst = BRK;
+	memset(&regs, 0, sizeof(regs));
+	regs.sp = 0xFF;
+
+	read_write = 0;
+
+	ram = new Memory(memory_size);
+	rom = ram; //both pointers refer to the same block, the destructor knows not to delete it twice
+	refresh_fast_pages();
+
+	regs.state = FETCH;
+
+	AluTables::init();
+}
+
+/// <summary>
+/// Constructor for memory that lives outside the processor, such as a shared memory mapping that monitors in other processes look at
+/// if both blocks are the same pointer the processor gets one unified memory, like the constructor above
+/// </summary>
+/// <param name="ram_size">size of the RAM block</param>
+/// <param name="ram_storage">the RAM block, which has to outlive the processor</param>
+/// <param name="rom_size">size of the ROM block</param>
+/// <param name="rom_storage">the ROM block, which has to outlive the processor</param>
+template <typename Hooks>
+BasicProcessor<Hooks>::BasicProcessor(unsigned int ram_size, unsigned char* ram_storage, unsigned int rom_size, unsigned char* rom_storage) {
+	addr_mode = IMPLIED;
+	inst = BRK;
+	memset(&regs, 0, sizeof(regs));
+	regs.sp = 0xFF;
+
+	read_write = 0;
+
+	ram = new Memory(ram_size, ram_storage);
+	if (rom_storage == ram_storage) {
+		rom = ram;
+	}
+	else {
+		try {
+			rom = new Memory(rom_size, rom_storage);
+		}
+		catch (...) {
+			delete ram;
+			throw;
+		}
+	}
+	refresh_fast_pages();
+
+	regs.state = FETCH;
+
+	AluTables::init();
+}
+
+/// <summary>
+/// Standard destructor, will delete any pointers and things for proper memory cleanup
+/// </summary>
+template <typename Hooks>
+BasicProcessor<Hooks>::~BasicProcessor() {
+	if (rom != ram) {
+		delete rom;
+	}
+	delete ram;
+}
+
+/// <summary>
+/// Standard Get Function for Accumulator
+/// </summary>
+/// <returns></returns>
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_accumulator() {
+	return regs.a;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_x() {
+	return regs.x;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_y() {
+	return regs.y;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_pc_high() {
+	return regs.pc_high;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_pc_low() {
+	return regs.pc_low;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_output() {
+	return output;
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_sflags() {
+	return regs.flags.val;
+}
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_sp() {
+	return regs.sp;
+}
+
+/// <summary>
+/// Builds the status register in the order the real processor pushes it, the bitfield in sflag_reg is declared N first, so its raw value has the bits the other way around
+/// </summary>
+/// <returns></returns>
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_status() {
+	return (unsigned char)((regs.flags.n_flag << 7) | (regs.flags.o_flag << 6) | (regs.flags.rsvd << 5) | (regs.flags.b_flag << 4) | (regs.flags.d_flag << 3) | (regs.flags.id_flag << 2) | (regs.flags.z_flag << 1) | regs.flags.c_flag);
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_status(unsigned char status) {
+	regs.flags.n_flag = (status >> 7) & 0x01;
+	regs.flags.o_flag = (status >> 6) & 0x01;
+	regs.flags.rsvd = (status >> 5) & 0x01;
+	regs.flags.b_flag = (status >> 4) & 0x01;
+	regs.flags.d_flag = (status >> 3) & 0x01;
+	regs.flags.id_flag = (status >> 2) & 0x01;
+	regs.flags.z_flag = (status >> 1) & 0x01;
+	regs.flags.c_flag = status & 0x01;
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_registers(unsigned char a, unsigned char x, unsigned char y, unsigned char sp) {
+	regs.a = a;
+	regs.x = x;
+	regs.y = y;
+	regs.sp = sp;
+}
+
+/// <summary>
+/// Internal Fetch command, a bit crude for now as there is no try-catch for failure of address resolution, however that can be resolved fairly easily once this is operational
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::fetch() {
+	if (regs.state == FETCH) {
+		curr_instruction.val = rom->read(regs.pc_high, regs.pc_low);
+		hooks.on_fetch(regs.pc, curr_instruction.val);
+
+		regs.state = DECODE;
+	}
+	else {
+		//I need to come up with some crashing logic or some sort of error handling here ideally
+	}
+}
+
+/// <summary>
+/// Internal Decode function, this uses the INSTRUCTIONS and ADDRESS_MODES table to parse the binary to an instruction and addressing mode to be used in the execution
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::decode() {
+	if (regs.state == DECODE) {
+		//parse the function
+		inst = INSTRUCTION_TABLE[curr_instruction.nib_low][curr_instruction.nib_high];
+		addr_mode = ADDRESS_MODE_TABLE[curr_instruction.nib_low][curr_instruction.nib_high];
+		regs.cycles += CYCLE_TABLE[curr_instruction.nib_low][curr_instruction.nib_high];
+
+		regs.state = EXECUTE;
+	}
+	else {
+		//need to put some error handling for JAM state or wrong state here.
+	}
+}
+
+/// <summary>
+/// The major function of the Processor object, this is where instructions are executed and work is actually done (in execute_as, for the instruction decode() picked)
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::execute() {
+	execute_as(inst, addr_mode);
+}
+
+/// <summary>
+/// The body of execute, with the instruction and addressing mode passed in rather than read from what decode() left, and always inlined.
+/// When the fused handlers (execute_fused) call it with constants the compiler cuts the switches down to the one case, so a fused sequence is the exact same
+/// code as the instructions run one at a time, just without the decode and the dispatch between them.
+/// Stepped is false for those, they don't go through the DECODE and EXECUTE states at all, so the instruction runs in FETCH and leaves it alone (apart from jamming).
+/// (It being a template also keeps the explicit instantiations in Processor.cpp from each putting out a copy of the whole thing that nothing calls.)
+/// </summary>
+template <typename Hooks>
+template <bool Stepped>
+void BasicProcessor<Hooks>::execute_as(INSTRUCTIONS op, ADDRESS_MODES mode) {
+	if (!Stepped || regs.state == EXECUTE) {
+		
+		
+		/*
+		Quick Explanation of the logic for the switch,
+		each operation will do it's respective work, however, depending on addressing mode, the way the rom is read may be changed
+		Thus, I'll have to break up each operation that uses multiple addressing modes and set any operands according to the instruction
+		I'll try to reduce redundancy here by separating memory interactions from the actual work
+		*/
+		switch (op) {
+		case ADC: {
+			unsigned char operand = 0x00; //this will be the number that will be used in the addtion
+
+			switch (mode) {
+			case ABSOLUT:
+			{
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+				break;
+			case INDIRECT_Y: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+				break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+				break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+				break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+
+			//the result and all four flags come straight out of the precomputed tables (see AluTables.cpp for the actual arithmetic, including the signed overflow logic and the BCD correction)
+			unsigned short alu = AluTables::lookup(regs.flags.d_flag == 0 ? ADC_BINARY : ADC_DECIMAL, regs.a, operand, regs.flags.c_flag);
+			regs.a = alu & 0xFF;
+			set_alu_flags(alu >> 8);
+
+			//finally, increment the pc
+			increment_pc();
+
+		}
+				break;
+		case AND:
+		{
+			unsigned char operand = 0x00;
+			switch (mode) {
+			case ABSOLUT:
+			{
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+			break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case INDIRECT_Y: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+						 break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+						   break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			regs.a = regs.a & operand; //bitwise and the operand and the accumulator
+
+			//calculate whether flags are set: Negative and Zero flags specifically
+			if (regs.a = 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			if ((regs.a & 0x80) > 0x00) {
+				regs.flags.n_flag = 0b1;
+			}
+			increment_pc(); //finally, increment program counter for next instruction
+
+		}
+		break;
+		case ASL: {
+			switch (mode) {
+			case ACCUMULATOR:
+			{
+
+
+				//perform bit-shift
+				regs.a = regs.a << 1;
+
+				//check result for zero and negative results
+				if (regs.a == 0x00) {
+					regs.flags.z_flag = 0b1;
+				}
+				if ((regs.a & 0x80) > 0) {
+					regs.flags.n_flag = 0b1;
+				}
+			}
+			break;
+			case ABSOLUT:
+			{
+				unsigned char op_high = 0x00;
+				unsigned char op_low = 0x00;
+				unsigned char result = 0x00;
+				increment_pc();
+				op_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				op_high = rom->read(regs.pc_high, regs.pc_low);
+				result = read_data(op_high, op_low);
+				if ((result & 0x80) > 0x00) {
+					regs.flags.c_flag = 0b1;
+				}
+				else {
+					regs.flags.c_flag = 0b0;
+				}
+
+				result = result << 1;
+
+				if (result == 0x00) {
+					regs.flags.z_flag = 0b1;
+				}
+				if (result & 0x80 > 0) {
+					regs.flags.n_flag = 0b1;
+				}
+
+				//finally, apply the operation to the RAM
+
+				write_data(op_high, op_low, result);
+			}
+			break;
+			case ABSOLUTE_X:
+			{
+				unsigned char op_high;
+				unsigned char op_low;
+				increment_pc();
+				op_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				op_high = rom->read(regs.pc_high, regs.pc_low);
+
+				if (op_low + regs.x > 0xFF) {
+					if (op_high + 0x01 > 0xFF) {
+						op_high = 0x00;
+					}
+					else {
+						op_high += 0x01;
+					}
+					op_low == 0x00;
+					regs.flags.c_flag = 0b1;
+				}
+				else {
+					regs.flags.c_flag = 0b0;
+				}
+				op_low += regs.x;
+
+				unsigned char result = read_data(op_high, op_low);
+				if ((result & 0x80) > 0) {
+					regs.flags.c_flag = 0b1;
+				}
+				else {
+					regs.flags.c_flag = 0b0;
+				}
+
+				result = result << 1;
+
+				if (result == 0x00) {
+					regs.flags.z_flag = 0b1;
+				}
+				if (result & 0x80 > 0) {
+					regs.flags.n_flag = 0b1;
+				}
+
+				write_data(op_high, op_high, result);
+			}
+			break;
+			case ZEROPAGE: {
+				increment_pc();
+				unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+				unsigned char result = read_zero_page(operand);
+				if ((result & 0x80) > 0) {
+					regs.flags.c_flag = 0b1;
+				}
+				result = result << 1;
+
+				if (result == 0x00) {
+					regs.flags.z_flag = 0b1;
+				}
+				if (result & 0x80 > 0) {
+					regs.flags.n_flag = 0b1;
+				}
+
+				write_zero_page(operand, result);
+			}
+						 break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+				operand += regs.x;
+				unsigned char result = read_zero_page(operand);
+				if ((result & 0x80) > 0) {
+					regs.flags.c_flag = 0b1;
+				}
+				result = result << 1;
+
+				if (result == 0x00) {
+					regs.flags.z_flag = 0b1;
+				}
+				if ((result & 0x80) > 0) {
+					regs.flags.n_flag = 0b1;
+				}
+
+				write_zero_page(operand, result);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc(); //increment the PC
+		}
+				break;
+		case BCC:
+
+			increment_pc();
+
+			//branch on carry flag clear
+			if (regs.flags.c_flag == 0b0) {
+				unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+			break;
+		case BCS:
+			increment_pc();
+
+			//branch on carry flag clear
+			if (regs.flags.c_flag == 0b1) {
+				unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+			break;
+		case BEQ:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+
+			if (regs.flags.z_flag == 0b1) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc(); //no need to branch, it just needs to continue on
+			}
+		}
+		break;
+		case BIT:
+		{
+			increment_pc();
+			unsigned char operand;
+			switch (mode) {
+			case ABSOLUT:
+			{
+				unsigned char offset_l = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char offset_h = rom->read(regs.pc_high, regs.pc_low);
+				operand = rom->read(offset_h, offset_l);
+			}
+			break;
+			case ZEROPAGE:
+				operand = rom->read(0x00, rom->read(regs.pc_high, regs.pc_low));
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+
+			//regardless of addressing mode, do the operation
+			if (operand & 0x80 > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag = 0b0;
+			}
+			if (operand & 0x40 > 0) {
+				regs.flags.o_flag = 0b1;
+			}
+			else {
+				regs.flags.o_flag = 0b0;
+			}
+			if (regs.a & operand > 0) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+
+			}
+			increment_pc(); //increment the pc
+		}
+		break;
+		case BMI:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+			if (regs.flags.n_flag == 0b1) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+		}
+		break;
+		case BNE:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+
+			if (regs.flags.z_flag == 0b0) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc(); //no need to branch, it just needs to continue on
+			}
+		}
+		break;
+		case BPL:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+			if (regs.flags.n_flag == 0b0) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+		}
+		break;
+		case BRK:
+			hooks.on_interrupt(INTERRUPT_BRK, regs.pc);
+			//two bytes long (the second is padding), the address after both goes on the stack, then the status with B set, and it goes through the vector at $FFFE
+			increment_pc();
+			increment_pc();
+			write_stack(regs.sp, regs.pc_high);
+			regs.sp--;
+			write_stack(regs.sp, regs.pc_low);
+			regs.sp--;
+			write_stack(regs.sp, get_status() | 0x30);
+			regs.sp--;
+			regs.flags.id_flag = 0b1;
+			if (rom->get_size() < 0x10000) {
+				regs.state = JAMMED; //the code memory doesn't reach the vector, so there's nowhere to go
+			}
+			else {
+				regs.pc = (unsigned short)(rom->read(0xFF, 0xFE) | (rom->read(0xFF, 0xFF) << 8));
+			}
+			break;
+		case BVC:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+			if (regs.flags.o_flag == 0b0) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+		}
+		break;
+		case BVS:
+		{
+			increment_pc();
+			unsigned char operand = rom->read(regs.pc_high, regs.pc_low);
+			if (regs.flags.o_flag == 0b1) {
+				//branch on flag being set, do a relative address mode 
+				increment_pc(); //off the operand, the offset counts from the next instruction
+				regs.pc = (unsigned short)(regs.pc + (signed char)operand); //the offset is signed, one 16-bit add carries into the high byte on its own
+			}
+			else {
+				increment_pc();
+			}
+		}
+		break;
+		case CLC:
+			regs.flags.c_flag = 0b0;
+			increment_pc();
+			break;
+		case CLD:
+			increment_pc();
+			regs.flags.d_flag == 0b0;
+			break;
+		case CLI:
+			increment_pc();
+			regs.flags.id_flag == 0b0;
+			break;
+		case CLV:
+			increment_pc();
+			regs.flags.o_flag = 0b0;
+			break;
+		case CMP: {
+			increment_pc(); //on to the operand, each mode reads from there
+			unsigned char operand;
+			switch (mode) {
+			case ABSOLUT:
+			{
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+			break;
+			case ABSOLUTE_X: {
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case ABSOLUTE_Y: {
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case IMMEDIATE:
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X: {
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case INDIRECT_Y: {
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case ZEROPAGE: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+						 break;
+			case ZEROPAGE_X: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+						   break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			unsigned char result = regs.a - operand;
+			if ((result & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag = 0b0;
+			}
+			if (result == 0) {
+				regs.flags.z_flag = 0b1;
+				regs.flags.c_flag = 0b1;
+			}
+			if (operand > regs.a) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b0;
+			}
+			if (regs.a > operand) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b1;
+			}
+		}
+				increment_pc();
+				break;
+		case CPX: {
+			increment_pc(); //on to the operand, each mode reads from there
+			unsigned char operand;
+			switch (mode) {
+			case ABSOLUT: {
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case IMMEDIATE:
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case ZEROPAGE:
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			unsigned char result = regs.x - operand;
+			if ((result & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag = 0b0;
+			}
+			if (result == 0) {
+				regs.flags.z_flag = 0b1;
+				regs.flags.c_flag = 0b1;
+			}
+			if (operand > regs.x) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b0;
+			}
+			if (regs.x > operand) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b1;
+			}
+		}
+				increment_pc();
+				break;
+		case CPY:{
+			increment_pc(); //on to the operand, each mode reads from there
+			unsigned char operand;
+			switch (mode) {
+			case ABSOLUT: {
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case IMMEDIATE:
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case ZEROPAGE:
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			unsigned char result = regs.y - operand;
+			if ((result & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag = 0b0;
+			}
+			if (result == 0) {
+				regs.flags.z_flag = 0b1;
+				regs.flags.c_flag = 0b1;
+			}
+			if (operand > regs.y) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b0;
+			}
+			if (regs.y > operand) {
+				regs.flags.z_flag = 0b0;
+				regs.flags.c_flag = 0b1;
+			}
+			increment_pc();
+		}
+			break;
+		case DEC: {
+			unsigned char addr_high = 0x00;
+			unsigned char addr_low = 0x00;
+			switch (mode) {
+			case ABSOLUT: {
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+			}
+				break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+			}
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			write_data(addr_high, addr_low, read_data(addr_high, addr_low) - 1);
+
+			increment_pc();
+		}
+			break;
+		case DEX:
+			regs.x--;
+			set_nz_flags(regs.x);
+			increment_pc();
+			break;
+		case DEY:
+			regs.y--;
+			set_nz_flags(regs.y);
+			increment_pc();
+			break;
+		case EOR: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+					break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low); //the operand is the single byte after the opcode
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low + regs.x);
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low + regs.y);
+				operand = read_zero_page(addr_low);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			regs.a ^= operand; //exclusive-or the operand into the accumulator
+			set_nz_flags(regs.a);
+			increment_pc(); //finally, step past the last operand byte to the next instruction
+		}
+			break;
+		case INC: {
+			unsigned char operand = 0x00;
+			unsigned char addr_high = 0x00;
+			unsigned char addr_low = 0x00;
+			switch (mode) {
+			case ABSOLUT: {
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+			}
+						break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+			}
+						   break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			operand--;
+			write_data(addr_high, addr_low, operand);
+			if (operand == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			if ((operand & 0x80) > 1) {
+				regs.flags.n_flag = 0b1;
+			}
+		}
+			increment_pc();
+			break;
+		case INX:
+			regs.x++;
+			set_nz_flags(regs.x);
+			increment_pc();
+			break;
+		case INY:
+			regs.y++;
+			set_nz_flags(regs.y);
+			increment_pc();
+			break;
+		case JMP: {
+			increment_pc();
+			unsigned char tmpAdd = rom->read(regs.pc_high, regs.pc_low);
+			increment_pc();
+			unsigned char tmpHigh = rom->read(regs.pc_high, regs.pc_low);
+			if (mode == INDIRECT) {
+				//the operand points at the target instead of being it. The pointer's high byte comes from the same page as its low byte,
+				//so a pointer at $xxFF reads its high byte from $xx00, as the real chip does
+				unsigned char pointer_low = tmpAdd;
+				tmpAdd = read_data(tmpHigh, pointer_low);
+				tmpHigh = read_data(tmpHigh, (unsigned char)(pointer_low + 1));
+			}
+			regs.pc = (unsigned short)(tmpAdd | (tmpHigh << 8)); //set as a whole, so the next fetch isn't reading a value stored a byte at a time
+			//no increment needed here, because it's manually setting the address
+		}
+				break;
+		case JSR: {
+			//the address of the JSR's last byte goes on the stack (RTS adds the one), then it jumps like JMP
+			increment_pc();
+			unsigned char target_low = rom->read(regs.pc_high, regs.pc_low);
+			increment_pc();
+			write_stack(regs.sp, regs.pc_high);
+			regs.sp--;
+			write_stack(regs.sp, regs.pc_low);
+			regs.sp--;
+			regs.pc = (unsigned short)(target_low | (rom->read(regs.pc_high, regs.pc_low) << 8));
+		}
+				break;
+		case LDA:
+		{
+			unsigned char operand;
+			switch (mode) {
+			case ACCUMULATOR:
+				operand = regs.a;
+				break;
+			case ABSOLUT: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT: {
+				//basically the same as absolute
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						 break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case INDIRECT_Y:
+			{
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+			break;
+			case RELATIV: {
+				unsigned char addr_high = regs.pc_high;
+				unsigned char addr_low = regs.pc_low;
+				increment_pc();
+				unsigned char addr_mod = rom->read(regs.pc_high, regs.pc_low);
+				if (addr_mod >= 0x80) {
+					if (((int)addr_low - ((addr_mod & 0x7F) + 1)) < 0) {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+						addr_high--;
+					}
+					else {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+					}
+				}
+				else {
+					if (((int)addr_low + addr_mod) > 0xFF) {
+						addr_low += addr_mod;
+						addr_high++;
+					}
+					else {
+						addr_low += addr_mod;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+						 break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+						   break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+
+			regs.a = operand; //load the accumulator with the value
+			increment_pc();
+		}
+		break;
+		case LDX: {
+			unsigned char operand;
+			switch (mode) {
+			case ACCUMULATOR:
+				operand = regs.a;
+				break;
+			case ABSOLUT: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT: {
+				//basically the same as absolute
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						 break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case INDIRECT_Y:
+			{
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+			break;
+			case RELATIV: {
+				unsigned char addr_high = regs.pc_high;
+				unsigned char addr_low = regs.pc_low;
+				increment_pc();
+				unsigned char addr_mod = rom->read(regs.pc_high, regs.pc_low);
+				if (addr_mod >= 0x80) {
+					if (((int)addr_low - ((addr_mod & 0x7F) + 1)) < 0) {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+						addr_high--;
+					}
+					else {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+					}
+				}
+				else {
+					if (((int)addr_low + addr_mod) > 0xFF) {
+						addr_low += addr_mod;
+						addr_high++;
+					}
+					else {
+						addr_low += addr_mod;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+						 break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+						   break;
+			case ZEROPAGE_Y: {
+				increment_pc(); //onto the zero page address
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			regs.x = operand;
+		}
+			increment_pc();
+			break;
+		case LDY: {
+			unsigned char operand;
+			switch (mode) {
+			case ACCUMULATOR:
+				operand = regs.a;
+				break;
+			case ABSOLUT: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						   break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT: {
+				//basically the same as absolute
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+						 break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+						   break;
+			case INDIRECT_Y:
+			{
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+			break;
+			case RELATIV: {
+				unsigned char addr_high = regs.pc_high;
+				unsigned char addr_low = regs.pc_low;
+				increment_pc();
+				unsigned char addr_mod = rom->read(regs.pc_high, regs.pc_low);
+				if (addr_mod >= 0x80) {
+					if (((int)addr_low - ((addr_mod & 0x7F) + 1)) < 0) {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+						addr_high--;
+					}
+					else {
+						addr_low = addr_low - ((addr_mod & 0x7F) + 1);
+					}
+				}
+				else {
+					if (((int)addr_low + addr_mod) > 0xFF) {
+						addr_low += addr_mod;
+						addr_high++;
+					}
+					else {
+						addr_low += addr_mod;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+						break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+						 break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+						   break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+						   break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			regs.y = operand;
+		}
+			increment_pc();
+			break;
+		case LSR: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				operand = regs.a;
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if ((int)addr_low + regs.x > 0xFF) {
+					addr_high++; //carry into the high byte when the index crosses a page
+				}
+				addr_low = addr_low + regs.x;
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low) + regs.x; //the zero page index wraps within the page
+				operand = read_zero_page(addr_low);
+				break;
+			default:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+
+			//the low bit shifts out into carry, and a zero shifts in at the top, so the result is never negative
+			regs.flags.c_flag = operand & 0x01;
+			operand = operand >> 1;
+			set_nz_flags(operand);
+
+			switch (mode) {
+			case ACCUMULATOR:
+				regs.a = operand;
+				break;
+			case ABSOLUT:
+			case ABSOLUTE_X:
+				write_data(addr_high, addr_low, operand);
+				break;
+			case ZEROPAGE:
+			case ZEROPAGE_X:
+				write_zero_page(addr_low, operand);
+				break;
+			default:
+				break;
+			}
+			increment_pc();
+		}
+			break;
+		case NOP:
+			increment_pc();
+			break;
+		case ORA: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+					break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low); //the operand is the single byte after the opcode
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low + regs.x);
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low + regs.y);
+				operand = read_zero_page(addr_low);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			regs.a |= operand; //or the operand into the accumulator
+			set_nz_flags(regs.a);
+			increment_pc(); //finally, step past the last operand byte to the next instruction
+		}
+			break;
+		case PHA:
+			write_stack(regs.sp, regs.a);
+			regs.sp--;
+			increment_pc();
+			break;
+		case PHP:
+			write_stack(regs.sp, get_status() | 0x30); //in the real bit order, with B and the unused bit set, they only mean anything on the stack
+			regs.sp--;
+			increment_pc();
+			break;
+		case PLA:
+			//the stack pointer is at the next free slot, so it goes up before the read
+			regs.sp++;
+			regs.a = read_stack(regs.sp);
+			set_nz_flags(regs.a);
+			increment_pc();
+			break;
+		case PLP:
+			regs.sp++;
+			set_status((read_stack(regs.sp) & 0xCF) | (get_status() & 0x30)); //B and the unused bit stay as they were
+			increment_pc();
+			break;
+		case ROL:{
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low + regs.x);
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low + regs.y);
+				operand = read_zero_page(addr_low);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc();
+		}
+			break;
+		case ROR: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low + regs.x);
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low + regs.y);
+				operand = read_zero_page(addr_low);
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc();
+		}
+			break;
+		case RTI:
+			regs.sp++;
+			set_status((read_stack(regs.sp) & 0xCF) | (get_status() & 0x30));
+			regs.sp++;
+			{
+				unsigned char return_low = read_stack(regs.sp);
+				regs.sp++;
+				regs.pc = (unsigned short)(return_low | (read_stack(regs.sp) << 8));
+			}
+			break;
+		case RTS:
+			regs.sp++;
+			{
+				unsigned char return_low = read_stack(regs.sp);
+				regs.sp++;
+				regs.pc = (unsigned short)((return_low | (read_stack(regs.sp) << 8)) + 1); //JSR pushed the address of its own last byte
+			}
+			break;
+		case SBC: {
+			unsigned char operand = 0x00; //the number being subtracted, same addressing modes as ADC
+			switch (mode) {
+			case ABSOLUT:
+			{
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case ABSOLUTE_X: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case ABSOLUTE_Y: {
+				increment_pc();
+				unsigned char addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				unsigned char addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+			}
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				operand = rom->read(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr += regs.x;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+				break;
+			case INDIRECT_Y: {
+				increment_pc();
+				unsigned char addr = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr += regs.y;
+				}
+				operand = read_zero_page(addr); //this could be wrong, according to source ,but the source is a bit confusing, I'll leave it as this for now, as it's 
+			}
+				break;
+			case ZEROPAGE: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low));
+			}
+				break;
+			case ZEROPAGE_X: {
+				increment_pc();
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.x);
+			}
+				break;
+			case ZEROPAGE_Y: {
+				operand = read_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y);
+			}
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+
+			//binary SBC is ADC with the operand inverted (the carry acts as "not borrow"), decimal mode has its own table since the BCD correction is different
+			unsigned short alu;
+			if (regs.flags.d_flag == 0) {
+				alu = AluTables::lookup(ADC_BINARY, regs.a, ~operand, regs.flags.c_flag);
+			}
+			else {
+				alu = AluTables::lookup(SBC_DECIMAL, regs.a, operand, regs.flags.c_flag);
+			}
+			regs.a = alu & 0xFF;
+			set_alu_flags(alu >> 8);
+
+			increment_pc();
+		}
+			break;
+		case SEC:
+			regs.flags.c_flag = 0b1;
+			increment_pc();
+			break;
+		case SED:
+			regs.flags.d_flag = 0b1;
+			increment_pc();
+			break;
+		case SEI:
+			regs.flags.id_flag = 0b1;
+			increment_pc();
+			break;
+		case STA: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand;
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand + regs.x;
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand + regs.y;
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc();
+			write_data(addr_high, addr_low, regs.a);
+		}
+			break;
+		case STX: {
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				write_data(addr_high, addr_low, regs.x);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				write_zero_page(rom->read(regs.pc_high, regs.pc_low), regs.x);
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				write_zero_page(rom->read(regs.pc_high, regs.pc_low) + regs.y, regs.x); //the zero page index wraps within the page
+				break;
+			default:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc();
+		}
+			break;
+		case STY: {
+			unsigned char operand = 0x00;
+			unsigned char addr_low = 0x00;
+			unsigned char addr_high = 0x00;
+			switch (mode) {
+			case ACCUMULATOR:
+				break;
+			case ABSOLUT:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.x & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.x & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.x > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.x;
+					}
+					else {
+						addr_low = addr_low + regs.x;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case ABSOLUTE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					if ((int)(addr_low - ((regs.y & 0x7F) + 0x01)) < 0) {
+						addr_high--;
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+					else {
+						addr_low = addr_low - ((regs.y & 0x7F) + 1);
+					}
+				}
+				else {
+					if ((int)addr_low + regs.y > 0xFF) {
+						addr_high++;
+						addr_low = addr_low + regs.y;
+					}
+					else {
+						addr_low = addr_low + regs.y;
+					}
+				}
+				operand = read_data(addr_high, addr_low);
+				break;
+			case IMMEDIATE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				increment_pc();
+				addr_high = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_data(regs.pc_high, regs.pc_low);
+				break;
+			case INDIRECT_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.x >= 0x80) {
+					addr_low -= ((regs.x & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.x;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case INDIRECT_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				if (regs.y >= 0x80) {
+					addr_low -= ((regs.y & 0x7F) + 1);
+				}
+				else {
+					addr_low += regs.y;
+				}
+				operand = read_zero_page(addr_low);
+				break;
+			case ZEROPAGE:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand;
+				break;
+			case ZEROPAGE_X:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand + regs.x;
+				break;
+			case ZEROPAGE_Y:
+				increment_pc();
+				addr_low = rom->read(regs.pc_high, regs.pc_low);
+				operand = read_zero_page(addr_low);
+				addr_low = operand + regs.y;
+				break;
+			case ERR:
+				regs.state = JAMMED; //jam the processor
+				break;
+			}
+			increment_pc();
+			write_data(addr_high, addr_low, regs.y);
+		}
+			break;
+		case TAX:
+			regs.x = regs.a;
+			if (regs.x == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+				regs.flags.z_flag = 0b0;
+			}
+			if ((regs.x & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag - 0b0;
+			}
+			increment_pc();
+			break;
+		case TAY:
+			regs.y = regs.a;
+			if (regs.y == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+				regs.flags.z_flag = 0b0;
+			}
+			if ((regs.y & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag - 0b0;
+			}
+			increment_pc();
+			break;
+		case TSX:
+			regs.x = regs.sp;
+			if (regs.x == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+				regs.flags.z_flag = 0b0;
+			}
+			if ((regs.x & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag - 0b0;
+			}
+			increment_pc();
+			break;
+		case TXA:
+			regs.a = regs.x;
+			if (regs.a == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+				regs.flags.z_flag = 0b0;
+			}
+			if ((regs.a & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag - 0b0;
+			}
+			increment_pc();
+			break;
+		case TXS:
+			regs.sp = regs.x;
+			increment_pc();
+			break;
+		case TYA:
+			regs.a = regs.y;
+			if (regs.a == 0x00) {
+				regs.flags.z_flag = 0b1;
+			}
+			else {
+				regs.flags.z_flag = 0b0;
+			}
+			if ((regs.a & 0x80) > 0) {
+				regs.flags.n_flag = 0b1;
+			}
+			else {
+				regs.flags.n_flag - 0b0;
+			}
+			increment_pc();
+			break;
+		case JAM:
+			regs.state = JAMMED; //jam the processor state
+			break;
+		}
+		if (Stepped && regs.state != JAMMED) {
+			regs.state = FETCH;
+		}
+		//increment_pc(); //increase the pc for the next instruction //not sure if needed at the moment, as I'm currently accounting for this manually in instructions, it's inefficient, but it allows me to avoid decrementing pc on jumps and branches
+	} else {
+		//state error correcting here, 
+	}
+}
+
+/// <summary>
+/// Copies the N/V/Z/C flags out of an ADC/SBC table entry into the status register, the rest of the flags are left alone
+/// </summary>
+/// <param name="alu_flags">high byte of the AluTables entry</param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_alu_flags(unsigned char alu_flags) {
+	regs.flags.n_flag = (alu_flags & AluTables::ALU_N) ? 0b1 : 0b0;
+	regs.flags.o_flag = (alu_flags & AluTables::ALU_V) ? 0b1 : 0b0;
+	regs.flags.z_flag = (alu_flags & AluTables::ALU_Z) ? 0b1 : 0b0;
+	regs.flags.c_flag = (alu_flags & AluTables::ALU_C) ? 0b1 : 0b0;
+}
+
+/// <summary>
+/// Sets N and Z from a value just loaded or counted, for the register increments and decrements and the pulls
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_nz_flags(unsigned char value) {
+	regs.flags.n_flag = (value & 0x80) ? 0b1 : 0b0;
+	regs.flags.z_flag = (value == 0x00) ? 0b1 : 0b0;
+}
+
+/// <summary>
+/// This function is used to increment the Program Counter, the counter is a native 16-bit value now, so this is one add and it wraps from FFFF to 0000 on its own
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::increment_pc() {
+	regs.pc++;
+}
+
+/// <summary>
+/// reset function, clears the memory and resets the processor to initial status
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::reset() {
+	hooks.on_interrupt(INTERRUPT_RESET, regs.pc);
+	ram->clearMemory();
+	rom->clearMemory();
+	regs.flags.val = 0x00;
+	regs.a = 0x00;
+	regs.x = 0x00;
+	regs.y = 0x00;
+	regs.sp = 0x00;
+	regs.pc_high = 0x00;
+	regs.pc_low = 0x00;
+}
+
+/// <summary>
+/// The load_progam function loads a program into the rom, it is a critical part of the entire application, as this is the part where 
+/// </summary>
+/// <param name="filepath"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::load_program(const char* filepath) {
+	union rom_iterator {
+		struct {
+			unsigned char high : 8;
+			unsigned char low : 8;
+		};
+		unsigned short full;
+	};
+
+	rom_iterator itr;
+	itr.full = 0x0000;
+
+	//initialize an input stream
+	unsigned char byte_read = 0x00;
+	std::ifstream input_file_stream;
+	input_file_stream.open(filepath); //open the file from the resulting filepalth, I'll likely put this in a try-catch block at some point
+	//byte_read = input_file_stream.get();
+
+	//read each byte and input it into 
+	while (!input_file_stream.eof()) {
+	//while (byte_read != 0x11){
+		byte_read = input_file_stream.get();
+		rom->write(itr.high, itr.low, byte_read);
+		//byte_read = input_file_stream.get();
+		itr.full++;
+	}
+}
+
+/// <summary>
+/// Loads a program from a buffer into the rom, starting at address 0x0000 unless told otherwise, anything past the end of the rom is ignored
+/// </summary>
+/// <param name="data">program bytes</param>
+/// <param name="size">number of bytes in data</param>
+/// <param name="load_address">address the first byte goes to</param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::load_program(const unsigned char* data, unsigned int size, unsigned short load_address) {
+	if (load_address >= rom->get_size()) {
+		return;
+	}
+	if (size > rom->get_size() - load_address) {
+		size = rom->get_size() - load_address;
+	}
+	for (unsigned int i = 0; i < size; i++) {
+		unsigned int addr = load_address + i;
+		rom->write((addr >> 8) & 0xFF, addr & 0xFF, data[i]);
+	}
+}
+
+/// <summary>
+/// This function is necessary since binary files for the 6502 are in little endian format
+/// this function is probaby very inefficient, but it's a quick and dirty fix that will work, I can always replace this algorithm with a more efficient one later
+/// </summary>
+/// <param name="input"></param>
+/// <returns></returns>
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::little_to_big_endian(unsigned char input) {
+	union byte {
+		struct {
+			unsigned char b7 : 1;
+			unsigned char b6 : 1;
+			unsigned char b5 : 1;
+			unsigned char b4 : 1;
+			unsigned char b3 : 1;
+			unsigned char b2 : 1;
+			unsigned char b1 : 1;
+			unsigned char b0 : 1;
+		};
+		unsigned char val;
+	};
+
+	byte inputbyte;
+	inputbyte.val = input;
+	byte outputbyte;
+
+	//flip the bytes
+	outputbyte.b0 = inputbyte.b7;
+	outputbyte.b1 = inputbyte.b6;
+	outputbyte.b2 = inputbyte.b5;
+	outputbyte.b3 = inputbyte.b4;
+	outputbyte.b4 = inputbyte.b3;
+	outputbyte.b5 = inputbyte.b2;
+	outputbyte.b6 = inputbyte.b1;
+	outputbyte.b7 = inputbyte.b0;
+	return outputbyte.val; //returns the now flipped byte
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::step() {
+	if (regs.state == FETCH) {
+		fetch();
+		decode();
+		execute();
+		hooks.on_instruction_retired(*this);
+	}
+	else {
+		regs.state = JAMMED;
+	}
+}
+
+/// <summary>
+/// Runs a batch of instructions, this saves callers that want to run a lot of instructions (benchmarks, test runners) from paying for a call and a jam check on their side per instruction
+/// </summary>
+/// <param name="count">maximum number of instructions to execute</param>
+/// <returns>number of instructions executed, less than count only if the processor jammed or the hooks asked to stop</returns>
+template <typename Hooks>
+unsigned long long BasicProcessor<Hooks>::run(unsigned long long count) {
+	if (!predecode_cache.empty()) {
+		return run_fused(count, ~0ULL); //fusion is on (see enable_fusion), which has a loop of its own so this one doesn't pay for it when it's off
+	}
+	unsigned long long executed = 0;
+	while (executed < count && regs.state == FETCH) {
+		fetch();
+		decode();
+		execute();
+		hooks.on_instruction_retired(*this);
+		executed++;
+		if (hooks.should_stop()) {
+			break;
+		}
+	}
+	return executed;
+}
+
+/// <summary>
+/// Runs whole instructions until the cycle budget is used up, for running against a clock (the run controller's throttled mode), the last instruction can go over the budget by a few cycles
+/// the cycles actually used can be had from get_cycles, they come up short of the budget only if the processor jammed or the hooks asked to stop
+/// </summary>
+/// <param name="budget">cycles to run for</param>
+/// <returns>number of instructions executed, like run</returns>
+template <typename Hooks>
+unsigned long long BasicProcessor<Hooks>::run_cycles(unsigned long long budget) {
+	unsigned long long executed = 0;
+	unsigned long long target = regs.cycles + budget;
+	if (!predecode_cache.empty()) {
+		return run_fused(~0ULL, target);
+	}
+	while (regs.cycles < target && regs.state == FETCH) {
+		fetch();
+		decode();
+		execute();
+		hooks.on_instruction_retired(*this);
+		executed++;
+		if (hooks.should_stop()) {
+			break;
+		}
+	}
+	return executed;
+}
+
+template <typename Hooks>
+unsigned long long BasicProcessor<Hooks>::get_cycles() {
+	return regs.cycles;
+}
+
+
+/// <summary>
+/// Sets the program counter, since this is used to start a program somewhere specific, it also clears a JAMMED state so that execution can continue from the new address
+/// </summary>
+/// <param name="address_high"></param>
+/// <param name="address_low"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_pc(unsigned char address_high, unsigned char address_low) {
+	regs.pc_high = address_high;
+	regs.pc_low = address_low;
+	regs.state = FETCH;
+}
+
+template <typename Hooks>
+bool BasicProcessor<Hooks>::is_jammed() {
+	return regs.state == JAMMED;
+}
+
+/// <summary>
+/// Looks an opcode up in the instruction table, using the same nibble breakdown as decode()
+/// </summary>
+/// <param name="opcode"></param>
+/// <returns></returns>
+template <typename Hooks>
+INSTRUCTIONS BasicProcessor<Hooks>::get_instruction(unsigned char opcode) {
+	instruction op;
+	op.val = opcode;
+	return INSTRUCTION_TABLE[op.nib_low][op.nib_high];
+}
+
+template <typename Hooks>
+ADDRESS_MODES BasicProcessor<Hooks>::get_address_mode(unsigned char opcode) {
+	instruction op;
+	op.val = opcode;
+	return ADDRESS_MODE_TABLE[op.nib_low][op.nib_high];
+}
+
+template <typename Hooks>
+unsigned int BasicProcessor<Hooks>::get_rom_size() {
+	return rom->get_size();
+}
+
+
+template <typename Hooks>
+unsigned int BasicProcessor<Hooks>::get_ram_size() {
+	return ram->get_size();
+}
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_rom_value(unsigned char offsetHigh, unsigned char offsetLow) {
+	return rom->read(offsetHigh, offsetLow);
+}
+
+
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::get_ram_value(unsigned char offsetHigh, unsigned char offsetLow) {
+	return ram->read(offsetHigh, offsetLow);
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_ram_value(unsigned char offsetHigh, unsigned char offsetLow, unsigned char value) {
+	ram->write(offsetHigh, offsetLow, value);
+}
+
+/// <summary>
+/// Copies a block of RAM out in one go, much cheaper than get_ram_value per byte when a viewer needs a lot of it
+/// </summary>
+/// <param name="dest">buffer of at least count bytes</param>
+/// <param name="start">first address</param>
+/// <param name="count">number of bytes</param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::copy_ram(unsigned char* dest, unsigned int start, unsigned int count) {
+	ram->copy_out(dest, start, count);
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::copy_rom(unsigned char* dest, unsigned int start, unsigned int count) {
+	rom->copy_out(dest, start, count);
+}
+
+/// <summary>
+/// Copies a block into the RAM in one go, throws 5 (like a bad address) if the block runs past the end
+/// </summary>
+/// <param name="src">count bytes to write</param>
+/// <param name="start">first address</param>
+/// <param name="count">number of bytes</param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::load_ram(const unsigned char* src, unsigned int start, unsigned int count) {
+	ram->copy_in(src, start, count);
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::load_rom(const unsigned char* src, unsigned int start, unsigned int count) {
+	rom->copy_in(src, start, count);
+}
+
+/// <summary>
+/// Passes the RAM's change set through, a viewer can call this after every step and only redraw what changed
+/// </summary>
+/// <param name="ranges"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::get_ram_changes(std::vector<MemoryRange>& ranges) {
+	ram->get_changes(ranges);
+}
+
+/// <summary>
+/// Saves the registers and a copy of the memory, the vectors in the snapshot are reused if they're already the right size, so saving over the same snapshot repeatedly doesn't allocate
+/// </summary>
+/// <param name="snapshot"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::save_snapshot(ProcessorSnapshot& snapshot) {
+	const CpuState& state = get_cpu_state();
+	snapshot.pc_high = state.pc_high;
+	snapshot.pc_low = state.pc_low;
+	snapshot.a = state.a;
+	snapshot.x = state.x;
+	snapshot.y = state.y;
+	snapshot.sp = state.sp;
+	snapshot.status = get_status();
+	snapshot.jammed = state.state == JAMMED;
+	snapshot.ram.resize(ram->get_size());
+	ram->copy_out(snapshot.ram.data(), 0, ram->get_size());
+	if (rom != ram) {
+		snapshot.rom.resize(rom->get_size());
+		rom->copy_out(snapshot.rom.data(), 0, rom->get_size());
+	}
+	else {
+		snapshot.rom.clear();
+	}
+}
+
+/// <summary>
+/// Restores a snapshot, throws 6 if the snapshot was taken from a processor with different memory sizes
+/// </summary>
+/// <param name="snapshot"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::load_snapshot(const ProcessorSnapshot& snapshot) {
+	if (snapshot.ram.size() != ram->get_size() || (rom != ram && snapshot.rom.size() != rom->get_size())) {
+		throw 6; //error code for a snapshot that doesn't fit this processor
+	}
+	ram->copy_in(snapshot.ram.data(), 0, ram->get_size());
+	if (rom != ram) {
+		rom->copy_in(snapshot.rom.data(), 0, rom->get_size());
+	}
+	CpuState state = get_cpu_state(); //a snapshot doesn't hold the cycle count, that carries on from where it is
+	state.pc_high = snapshot.pc_high;
+	state.pc_low = snapshot.pc_low;
+	state.a = snapshot.a;
+	state.x = snapshot.x;
+	state.y = snapshot.y;
+	state.sp = snapshot.sp;
+	state.state = snapshot.jammed ? JAMMED : FETCH;
+	set_cpu_state(state);
+	set_status(snapshot.status); //the flags are stored in their own bit order, set_status reorders them
+}
+
+/// <summary>
+/// Maps an I/O device into the data address space, since all of the load/store instructions go through the RAM, that's where devices live
+/// </summary>
+/// <param name="page">high byte of the address range the device answers to</param>
+/// <param name="device"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::map_device(unsigned char page, IoDevice* device) {
+	ram->map_device(page, device);
+	refresh_fast_pages(); //a device over the zero page or stack has to see those accesses too
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::unmap_device(unsigned char page) {
+	ram->unmap_device(page);
+	refresh_fast_pages();
+}
+
+/// <summary>
+/// Attaches a bank controller to both memories, so code fetched from a window and data read from it come from the same bank.
+/// The controller's registers still need mapping over a page with map_device for the guest to switch banks itself
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::attach_banks(BankController& banks) {
+	banks.attach(ram);
+	banks.attach(rom); //ignored when it's the same memory
+	refresh_fast_pages(); //windows never cover pages 0 and 1, but this keeps the pointers right whatever the controller does
+}
+
+/// <summary>
+/// Picks up direct pointers to pages 0 and 1 of the RAM for the zero page and stack accesses, which are most of the data accesses in real 6502 code.
+/// A page only gets one when it's plain memory both ways, anything else (a device mapped there) leaves it nullptr and those accesses take the normal path.
+/// This has to run again whenever the mapping of either page could have changed, which is only ever through map_device, unmap_device and attach_banks
+/// (BankController doesn't allow windows over the two pages, so a guest switching banks can't change them behind the processor's back)
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::refresh_fast_pages() {
+	zero_page = ram->get_direct_page(0x00);
+	stack_page = ram->get_direct_page(0x01);
+}
+
+/// <summary>
+/// The whole architectural state in one copy (see CpuState), the memory isn't in it, for that there are the snapshots
+/// </summary>
+template <typename Hooks>
+const CpuState& BasicProcessor<Hooks>::get_cpu_state() {
+	return regs;
+}
+
+/// <summary>
+/// Puts a state from get_cpu_state back in one copy, cycle count and jam state included
+/// </summary>
+/// <param name="state"></param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::set_cpu_state(const CpuState& state) {
+	memcpy(&regs, &state, sizeof(regs));
+}
+
+template <typename Hooks>
+Hooks& BasicProcessor<Hooks>::get_hooks() {
+	return hooks;
+}
+
+/// <summary>
+/// Turns on superinstruction fusion for run and run_cycles. The processor watches the first warmup_instructions of the program, counting the sequences in
+/// FUSED_SEQUENCE_TABLE as they run and where they start, then keeps the ones that made up at least 1 in 1000 of those instructions. From then on, instructions are decoded
+/// from a predecode cache (an entry per address), and an instruction at one of those addresses runs its whole sequence in one handler (run_sequence), with a body made for
+/// those exact instructions, no decode, and no trip round the run loop between them.
+/// The results are exactly the same as without it (each instruction in a handler is the same code, see execute_as, and every opcode is still fetched and checked,
+/// so a sequence only runs as far as the program really goes, self modifying code included) and the hooks get every call they would have got.
+/// It isn't a win everywhere, so measure (bench runs each workload both ways): the core spends most of its time waiting on the registers it has just written, which a
+/// handler doesn't change, what it saves is the dispatch, which pays off most where the instructions vary (runs of loads, stores and arithmetic were about a third faster),
+/// while a tight counting loop (DEX/BNE) was about 5% slower, as was code with no sequences in it, for the cache lookups.
+/// Calling it again starts over with a new warm up, step() never fuses, and it (like disable_fusion and load_fusion_profile) mustn't be called from a hook during a run.
+/// </summary>
+/// <param name="warmup_instructions">how many instructions to watch, 0 to pick nothing (which is where load_fusion_profile starts from)</param>
+template <typename Hooks>
+void BasicProcessor<Hooks>::enable_fusion(unsigned long long warmup_instructions) {
+	predecoded entry;
+	predecode(entry, 0x00); //every entry starts out as a decoded BRK, which is put right the first time something else is fetched there
+	entry.sequence = FUSE_NONE;
+	predecode_cache.assign(65536, entry);
+	fusion_stats = FusionStats();
+	fusion_stats.warmup_instructions = warmup_instructions;
+	fusion_warmup = warmup_instructions;
+	for (int i = 0; i < 2; i++) {
+		fusion_history_pc[i] = 0;
+		fusion_history_opcode[i] = 0x00; //BRK isn't in any sequence, so nothing matches until two real instructions have run
+	}
+}
+
+template <typename Hooks>
+void BasicProcessor<Hooks>::disable_fusion() {
+	predecode_cache.clear();
+	predecode_cache.shrink_to_fit();
+	fusion_warmup = 0;
+}
+
+template <typename Hooks>
+const FusionStats& BasicProcessor<Hooks>::get_fusion_stats() {
+	return fusion_stats;
+}
+
+/// <summary>
+/// A profile file is text, a line per fused address with the sequence's name (see FUSED_SEQUENCE_TABLE) and the address in hex, lines starting with # are comments.
+/// Saving one after a warm up on a typical run and loading it next time skips the warm up, and the profile can be edited by hand
+/// </summary>
+/// <param name="path">the file</param>
+/// <returns>false if the file couldn't be opened, lines that don't parse are skipped</returns>
+template <typename Hooks>
+bool BasicProcessor<Hooks>::load_fusion_profile(const char* path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	enable_fusion(0);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::istringstream fields(line);
+		std::string name;
+		unsigned int address;
+		if (!(fields >> name >> std::hex >> address) || address > 0xFFFF) {
+			continue;
+		}
+		for (int s = FUSE_NONE + 1; s < FUSE_COUNT; s++) {
+			if (name == FUSED_SEQUENCE_TABLE[s].name) {
+				predecode_cache[address].sequence = (unsigned char)s;
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename Hooks>
+bool BasicProcessor<Hooks>::save_fusion_profile(const char* path) {
+	if (predecode_cache.empty() || fusion_warmup > 0) {
+		return false;
+	}
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	file << "# 6502Sim fusion profile: sequence address(hex)\n";
+	char address[8];
+	for (unsigned int pc = 0; pc < 65536; pc++) {
+		if (predecode_cache[pc].sequence != FUSE_NONE) {
+			snprintf(address, sizeof(address), "%04X", pc);
+			file << FUSED_SEQUENCE_TABLE[predecode_cache[pc].sequence].name << " " << address << "\n";
+		}
+	}
+	return file.good();
+}
+
+/// <summary>
+/// Fills in a predecode cache entry for an opcode, with the same tables decode() uses
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::predecode(predecoded& entry, unsigned char opcode) {
+	instruction op;
+	op.val = opcode;
+	entry.opcode = opcode;
+	entry.inst = (unsigned char)INSTRUCTION_TABLE[op.nib_low][op.nib_high];
+	entry.mode = (unsigned char)ADDRESS_MODE_TABLE[op.nib_low][op.nib_high];
+}
+
+/// <summary>
+/// Counts the sequences that end with the instruction that just ran (fetched at pc), and marks where they start in the cache, a triple wins over a pair starting at the same address
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::watch_warmup(unsigned short pc, unsigned char opcode) {
+	for (int s = FUSE_NONE + 1; s < FUSE_COUNT; s++) {
+		const FusedSequence& sequence = FUSED_SEQUENCE_TABLE[s];
+		if (sequence.length == 2) {
+			if (fusion_history_opcode[1] == sequence.opcodes[0] && opcode == sequence.opcodes[1]) {
+				fusion_stats.seen[s]++;
+				if (FUSED_SEQUENCE_TABLE[predecode_cache[fusion_history_pc[1]].sequence].length != 3) {
+					predecode_cache[fusion_history_pc[1]].sequence = (unsigned char)s;
+				}
+			}
+		}
+		else if (fusion_history_opcode[0] == sequence.opcodes[0] && fusion_history_opcode[1] == sequence.opcodes[1] && opcode == sequence.opcodes[2]) {
+			fusion_stats.seen[s]++;
+			predecode_cache[fusion_history_pc[0]].sequence = (unsigned char)s;
+		}
+	}
+	fusion_history_pc[0] = fusion_history_pc[1];
+	fusion_history_opcode[0] = fusion_history_opcode[1];
+	fusion_history_pc[1] = pc;
+	fusion_history_opcode[1] = opcode;
+
+	fusion_warmup--;
+	if (fusion_warmup == 0) {
+		finish_warmup();
+	}
+}
+
+/// <summary>
+/// Drops the sequences too rare to be worth a handler (under 1 in 1000 of the warm up's instructions), what's left in the cache is what gets fused
+/// </summary>
+template <typename Hooks>
+void BasicProcessor<Hooks>::finish_warmup() {
+	bool keep[FUSE_COUNT];
+	keep[FUSE_NONE] = false;
+	for (int s = FUSE_NONE + 1; s < FUSE_COUNT; s++) {
+		keep[s] = fusion_stats.seen[s] * 1000 >= fusion_stats.warmup_instructions;
+	}
+	for (unsigned int pc = 0; pc < 65536; pc++) {
+		if (!keep[predecode_cache[pc].sequence]) {
+			predecode_cache[pc].sequence = FUSE_NONE;
+		}
+	}
+}
+
+/// <summary>
+/// Runs an instruction of a fused handler, its opcode already fetched and checked: what decode() and execute() would do for it, with everything decode() looks up
+/// known up front, and without the trip through the processor states (it stays in FETCH, unless the instruction jams it)
+/// </summary>
+template <typename Hooks>
+template <unsigned char Opcode, INSTRUCTIONS Inst, ADDRESS_MODES Mode>
+void BasicProcessor<Hooks>::execute_fused() {
+	regs.cycles += CYCLE_TABLE[Opcode >> 4][Opcode & 15];
+	execute_as<false>(Inst, Mode);
+	hooks.on_instruction_retired(*this);
+}
+
+/// <summary>
+/// Fetches an opcode for run_fused and the fused handlers, like fetch() but without leaving the FETCH state
+/// </summary>
+template <typename Hooks>
+unsigned char BasicProcessor<Hooks>::fetch_fused() {
+	curr_instruction.val = rom->read(regs.pc_high, regs.pc_low);
+	hooks.on_fetch(regs.pc, curr_instruction.val);
+	return curr_instruction.val;
+}
+
+/// <summary>
+/// The fused handler for one sequence, entered once its first opcode has been fetched. It only starts if the run has room for the whole sequence (instructions and cycles),
+/// so nothing is checked between its instructions except what the program and the hooks can change: each opcode after the first is still fetched and compared, and if it isn't
+/// the one expected (a branch went elsewhere, the code changed) that instruction is run the ordinary way and the handler stops there.
+/// should_stop is asked here between the instructions, run_fused asks it for the last one
+/// </summary>
+/// <param name="count">instructions the caller has left to run</param>
+/// <param name="cycle_target">cycle count the caller is running up to</param>
+/// <param name="fused">count of instructions run by handlers, a local of run_fused that goes into the stats once at the end of the run</param>
+/// <param name="stopped">set if the hooks asked to stop partway through the sequence</param>
+/// <returns>number of instructions run, 0 if the handler didn't start and the instruction still has to be run</returns>
+template <typename Hooks>
+template <unsigned char Op1, INSTRUCTIONS Inst1, ADDRESS_MODES Mode1, unsigned char Op2, INSTRUCTIONS Inst2, ADDRESS_MODES Mode2, unsigned char Op3, INSTRUCTIONS Inst3, ADDRESS_MODES Mode3>
+unsigned long long BasicProcessor<Hooks>::run_sequence(unsigned long long count, unsigned long long cycle_target, unsigned long long& fused, bool& stopped) {
+	const unsigned long long length = (Inst3 == JAM) ? 2 : 3;
+	//cycles used before the last instruction starts, which has to be under the target like every instruction before it
+	const unsigned long long lead_cycles = CYCLE_TABLE[Op1 >> 4][Op1 & 15] + ((Inst3 == JAM) ? 0 : CYCLE_TABLE[Op2 >> 4][Op2 & 15]);
+	if (curr_instruction.val != Op1 || count < length || regs.cycles + lead_cycles >= cycle_target) {
+		return 0; //the code has changed since the sequence was picked, or the run ends inside it
+	}
+	execute_fused<Op1, Inst1, Mode1>();
+	fused++;
+	if (regs.state != FETCH) {
+		return 1;
+	}
+	if (hooks.should_stop()) {
+		stopped = true;
+		return 1;
+	}
+	if (fetch_fused() != Op2) {
+		regs.state = DECODE;
+		decode();
+		execute();
+		hooks.on_instruction_retired(*this);
+		return 2;
+	}
+	execute_fused<Op2, Inst2, Mode2>();
+	fused++;
+	if (Inst3 != JAM) {
+		if (regs.state != FETCH) {
+			return 2;
+		}
+		if (hooks.should_stop()) {
+			stopped = true;
+			return 2;
+		}
+		if (fetch_fused() != Op3) {
+			regs.state = DECODE;
+			decode();
+			execute();
+			hooks.on_instruction_retired(*this);
+			return 3;
+		}
+		execute_fused<Op3, Inst3, Mode3>();
+		fused++;
+	}
+	return length;
+}
+
+/// <summary>
+/// run and run_cycles with fusion on, the same loop as theirs, except that the decoding comes from the predecode cache, an instruction at an address a sequence starts at
+/// goes straight to the sequence's handler (run_sequence, the switch picks it and it's inlined there, so that's the only dispatch for the whole sequence),
+/// and the instructions of the warm up are watched
+/// </summary>
+/// <param name="count">maximum number of instructions to execute</param>
+/// <param name="cycle_target">cycle count to run up to</param>
+/// <returns>number of instructions executed</returns>
+template <typename Hooks>
+unsigned long long BasicProcessor<Hooks>::run_fused(unsigned long long count, unsigned long long cycle_target) {
+	unsigned long long executed = 0;
+	unsigned long long warmup_left = fusion_warmup;
+	while (fusion_warmup > 0 && executed < count && regs.cycles < cycle_target && regs.state == FETCH) {
+		fetch();
+		unsigned short pc = regs.pc;
+		decode();
+		execute();
+		hooks.on_instruction_retired(*this);
+		executed++;
+		watch_warmup(pc, curr_instruction.val);
+		if (hooks.should_stop()) {
+			return executed;
+		}
+	}
+	predecoded* cache = predecode_cache.data();
+	unsigned long long fused = 0;
+	while (executed < count && regs.cycles < cycle_target && regs.state == FETCH) {
+		predecoded& entry = cache[regs.pc];
+		unsigned char opcode = fetch_fused();
+		if (entry.opcode != opcode) {
+			predecode(entry, opcode); //first time here, or the code has changed
+		}
+		unsigned long long ran = 0;
+		bool stopped = false;
+		if (entry.sequence != FUSE_NONE) { //a plain branch, so the instructions that start nothing don't go through the switch's jump table
+			switch (entry.sequence) {
+			case FUSE_LDA_STA_ABS:
+				ran = run_sequence<0xAD, LDA, ABSOLUT, 0x8D, STA, ABSOLUT>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_LDA_IMM_STA_ABS:
+				ran = run_sequence<0xA9, LDA, IMMEDIATE, 0x8D, STA, ABSOLUT>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_DEX_BNE:
+				ran = run_sequence<0xCA, DEX, IMPLIED, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_DEY_BNE:
+				ran = run_sequence<0x88, DEY, IMPLIED, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_INX_BNE:
+				ran = run_sequence<0xE8, INX, IMPLIED, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_INY_BNE:
+				ran = run_sequence<0xC8, INY, IMPLIED, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_INX_CPX_BNE:
+				ran = run_sequence<0xE8, INX, IMPLIED, 0xE0, CPX, IMMEDIATE, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_INY_CPY_BNE:
+				ran = run_sequence<0xC8, INY, IMPLIED, 0xC0, CPY, IMMEDIATE, 0xD0, BNE, RELATIV>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_CLC_ADC_IMM:
+				ran = run_sequence<0x18, CLC, IMPLIED, 0x69, ADC, IMMEDIATE>(count - executed, cycle_target, fused, stopped);
+				break;
+			case FUSE_SEC_SBC_IMM:
+				ran = run_sequence<0x38, SEC, IMPLIED, 0xE9, SBC, IMMEDIATE>(count - executed, cycle_target, fused, stopped);
+				break;
+			default:
+				break;
+			}
+		}
+		if (ran == 0) {
+			//decode(), with the table lookups already done
+			inst = (INSTRUCTIONS)entry.inst;
+			addr_mode = (ADDRESS_MODES)entry.mode;
+			regs.cycles += CYCLE_TABLE[opcode >> 4][opcode & 15];
+			regs.state = EXECUTE;
+			execute();
+			hooks.on_instruction_retired(*this);
+			ran = 1;
+		}
+		executed += ran;
+		if (stopped || hooks.should_stop()) {
+			break;
+		}
+	}
+	fusion_stats.instructions += executed - (warmup_left - fusion_warmup); //the warm up's instructions aren't counted
+	fusion_stats.fused_instructions += fused;
+	return executed;
+}
@@ -20,6 +20,7 @@
 #define ID_FILE_RESETPROCESSOR          32772
 #define ID_HELP_HOWTOUSE                32773
 #define ID_STEPBUTTON                   32774
+#define ID_RUNBUTTON                    32775
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -28,7 +29,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        133
-#define _APS_NEXT_COMMAND_VALUE         32774
+#define _APS_NEXT_COMMAND_VALUE         32776
 #define _APS_NEXT_CONTROL_VALUE         1000
 #define _APS_NEXT_SYMED_VALUE           110
 #endif
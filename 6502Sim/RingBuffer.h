@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+
+/// <summary>
+/// Single producer/single consumer ring buffer of bytes, lock free so that the emulated CPU and a host thread can share it without either one ever waiting on the other.
+/// Capacity has to be a power of two, the head and tail counters are free running and get masked on access, which means a full buffer and an empty buffer can be told apart without wasting a slot.
+/// Only one thread may push and only one thread may pop, the bulk functions exist so that the host side can move a whole block per system call
+/// </summary>
+template <unsigned int Capacity>
+class RingBuffer
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+private:
+	unsigned char _data[Capacity];
+	std::atomic<unsigned int> _head; //next slot to write, only ever stored by the producer
+	std::atomic<unsigned int> _tail; //next slot to read, only ever stored by the consumer
+
+public:
+	RingBuffer() : _head(0), _tail(0) {}
+
+	/// <summary>
+	/// Push a single byte, returns false (and drops nothing) if the buffer is full
+	/// </summary>
+	bool push(unsigned char value) {
+		unsigned int head = _head.load(std::memory_order_relaxed);
+		if (head - _tail.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		_data[head & (Capacity - 1)] = value;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Pop a single byte, returns false if the buffer is empty
+	/// </summary>
+	bool pop(unsigned char& value) {
+		unsigned int tail = _tail.load(std::memory_order_relaxed);
+		if (_head.load(std::memory_order_acquire) == tail) {
+			return false;
+		}
+		value = _data[tail & (Capacity - 1)];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Push as much of the block as fits, returns how many bytes were actually pushed
+	/// </summary>
+	unsigned int push(const unsigned char* block, unsigned int count) {
+		unsigned int head = _head.load(std::memory_order_relaxed);
+		unsigned int space = Capacity - (head - _tail.load(std::memory_order_acquire));
+		if (count > space) {
+			count = space;
+		}
+		for (unsigned int i = 0; i < count; i++) {
+			_data[(head + i) & (Capacity - 1)] = block[i];
+		}
+		_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	/// <summary>
+	/// Pop up to count bytes into the block, returns how many bytes were actually popped
+	/// </summary>
+	unsigned int pop(unsigned char* block, unsigned int count) {
+		unsigned int tail = _tail.load(std::memory_order_relaxed);
+		unsigned int used = _head.load(std::memory_order_acquire) - tail;
+		if (count > used) {
+			count = used;
+		}
+		for (unsigned int i = 0; i < count; i++) {
+			block[i] = _data[(tail + i) & (Capacity - 1)];
+		}
+		_tail.store(tail + count, std::memory_order_release);
+		return count;
+	}
+
+	unsigned int size() const {
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	bool full() const {
+		return size() == Capacity;
+	}
+};
@@ -0,0 +1,327 @@
+#include "RunController.h"
+#include <cstring>
+
+/// <summary>
+/// Collects the pages whose version is newer than since_sequence into ranges, the same shape Memory::get_changes hands out
+/// </summary>
+/// <param name="since_sequence">sequence of the last publication the caller looked at, 0 for everything</param>
+/// <param name="ranges">cleared, then filled in address order</param>
+void PublishedState::get_changes(unsigned long long since_sequence, std::vector<MemoryRange>& ranges) const {
+	ranges.clear();
+	unsigned int pages = (unsigned int)((ram.size() + 255) / 256);
+	for (unsigned int page = 0; page < pages; page++) {
+		if (page_version[page] <= since_sequence) {
+			continue;
+		}
+		unsigned int start = page << 8;
+		unsigned int length = (unsigned int)ram.size() - start < 256 ? (unsigned int)ram.size() - start : 256;
+		if (!ranges.empty() && ranges.back().start + ranges.back().length == start) {
+			ranges.back().length += length;
+		}
+		else {
+			MemoryRange range;
+			range.start = start;
+			range.length = length;
+			ranges.push_back(range);
+		}
+	}
+}
+
+RunController::RunController(Processor* cpu) : _cpu(cpu), _shared(nullptr), _middle(1), _back(2), _front(0), _target_frequency(1000000.0), _quantum_us(2000), _mode(RUN_PAUSED), _quit(false), _batch(1000), _publish_interval_ms(16) {
+	for (int i = 0; i < 3; i++) {
+		_slots[i].sequence = 0;
+		_slots[i].instructions = 0;
+		_slots[i].instructions_per_second = 0.0;
+		_slots[i].cycles = 0;
+		_slots[i].cycles_per_second = 0.0;
+		_slots[i].target_frequency = 0.0;
+		_slots[i].jitter_mean_us = 0.0;
+		_slots[i].jitter_max_us = 0.0;
+		_slots[i].mode = RUN_PAUSED;
+		_slots[i].jammed = false;
+		_slots[i].pc_high = _slots[i].pc_low = 0;
+		_slots[i].a = _slots[i].x = _slots[i].y = _slots[i].sp = 0;
+		_slots[i].status = _slots[i].sflags = _slots[i].output = 0;
+		memset(_slots[i].page_version, 0, sizeof(_slots[i].page_version));
+	}
+	//every page starts out newer than "nothing seen yet", so the first reader gets the whole memory
+	for (int i = 0; i < 256; i++) {
+		_page_version[i] = 1;
+	}
+	_sequence = 0;
+	_instructions = 0;
+	_instructions_at_publish = 0;
+	_step_request = 0;
+	_step_pending = false;
+	_parked = false;
+	_cycles_at_publish = cpu->get_cycles();
+	_epoch_cycles = 0;
+	_epoch_frequency = 0.0;
+	_last_mode = RUN_PAUSED;
+	_jitter_sum_us = 0.0;
+	_jitter_max_us = 0.0;
+	_jitter_samples = 0;
+}
+
+RunController::~RunController() {
+	stop();
+}
+
+void RunController::start() {
+	if (_worker.joinable()) {
+		return;
+	}
+	_quit.store(false);
+	_mode.store(RUN_PAUSED);
+	_last_publish = std::chrono::steady_clock::now();
+	_worker = std::thread(&RunController::thread_main, this);
+}
+
+void RunController::stop() {
+	if (!_worker.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_quit.store(true);
+	}
+	_wake.notify_all();
+	_worker.join();
+}
+
+void RunController::resume() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_mode.store(RUN_FREE);
+		_parked = false; //set here rather than by the worker, so a pause() straight after this can't see the old parked state and return early
+	}
+	_wake.notify_all();
+}
+
+/// <summary>
+/// Switches to throttled running, can be called while running freely or paused, the burst timing starts over either way
+/// </summary>
+/// <param name="frequency">target clock speed in Hz</param>
+void RunController::throttle(double frequency) {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_target_frequency.store(frequency > 0.0 ? frequency : 1.0);
+		_mode.store(RUN_THROTTLED);
+		_parked = false;
+	}
+	_wake.notify_all();
+}
+
+void RunController::pause() {
+	std::unique_lock<std::mutex> guard(_lock);
+	_mode.store(RUN_PAUSED);
+	if (!_worker.joinable()) {
+		return;
+	}
+	_wake.notify_all();
+	_done.wait(guard, [this] { return _parked || _quit.load(); });
+}
+
+void RunController::step(unsigned long long count) {
+	pause();
+	std::unique_lock<std::mutex> guard(_lock);
+	if (!_worker.joinable()) {
+		return;
+	}
+	_step_request = count;
+	_step_pending = true;
+	_wake.notify_all();
+	_done.wait(guard, [this] { return !_step_pending || _quit.load(); });
+}
+
+bool RunController::is_running() {
+	return _mode.load() != RUN_PAUSED;
+}
+
+void RunController::set_batch(unsigned long long instructions) {
+	_batch.store(instructions > 0 ? instructions : 1, std::memory_order_relaxed);
+}
+
+void RunController::set_quantum(unsigned int microseconds) {
+	_quantum_us.store(microseconds > 0 ? microseconds : 1, std::memory_order_relaxed);
+}
+
+void RunController::set_publish_interval(unsigned int milliseconds) {
+	_publish_interval_ms.store(milliseconds, std::memory_order_relaxed);
+}
+
+void RunController::attach_shared(SharedState* shared) {
+	_shared = shared;
+	if (_shared != nullptr) {
+		_shared->publish(*_cpu, _instructions);
+	}
+}
+
+/// <summary>
+/// Picks up the newest publication if there is one, this is a single atomic exchange and never waits on the worker
+/// </summary>
+/// <returns>the reader's current slot, which the worker won't touch until the reader swaps it back in with a later read()</returns>
+const PublishedState& RunController::read() {
+	if (_middle.load(std::memory_order_acquire) & FRESH) {
+		_front = _middle.exchange(_front, std::memory_order_acq_rel) & 3;
+	}
+	return _slots[_front];
+}
+
+/// <summary>
+/// Fills the back slot and swaps it into the middle, only run on the worker thread (or while it's parked under the lock)
+/// the slot being filled was last filled a couple of publications ago, so it gets every page that changed since then, not just since the last publication
+/// </summary>
+void RunController::publish() {
+	_cpu->get_ram_changes(_changes);
+	_sequence++;
+	for (size_t r = 0; r < _changes.size(); r++) {
+		unsigned int last = (_changes[r].start + _changes[r].length - 1) >> 8;
+		for (unsigned int page = _changes[r].start >> 8; page <= last; page++) {
+			_page_version[page] = _sequence;
+		}
+	}
+
+	PublishedState& slot = _slots[_back];
+	unsigned int ram_size = _cpu->get_ram_size();
+	if (slot.ram.size() != ram_size) {
+		slot.ram.resize(ram_size);
+		_cpu->copy_ram(slot.ram.data(), 0, ram_size);
+	}
+	else {
+		for (unsigned int page = 0; (page << 8) < ram_size; page++) {
+			if (_page_version[page] > slot.sequence) {
+				unsigned int start = page << 8;
+				_cpu->copy_ram(&slot.ram[start], start, ram_size - start < 256 ? ram_size - start : 256);
+			}
+		}
+	}
+	memcpy(slot.page_version, _page_version, sizeof(_page_version));
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - _last_publish).count();
+	slot.instructions_per_second = seconds > 0.0 ? (double)(_instructions - _instructions_at_publish) / seconds : 0.0;
+	unsigned long long cycles = _cpu->get_cycles();
+	slot.cycles = cycles;
+	slot.cycles_per_second = seconds > 0.0 ? (double)(cycles - _cycles_at_publish) / seconds : 0.0;
+	slot.target_frequency = _mode.load(std::memory_order_relaxed) == RUN_THROTTLED ? _target_frequency.load(std::memory_order_relaxed) : 0.0;
+	slot.jitter_mean_us = _jitter_samples > 0 ? _jitter_sum_us / (double)_jitter_samples : 0.0;
+	slot.jitter_max_us = _jitter_max_us;
+	_jitter_sum_us = 0.0;
+	_jitter_max_us = 0.0;
+	_jitter_samples = 0;
+	_last_publish = now;
+	_instructions_at_publish = _instructions;
+	_cycles_at_publish = cycles;
+
+	slot.sequence = _sequence;
+	slot.instructions = _instructions;
+	slot.mode = (RUN_MODES)_mode.load(std::memory_order_relaxed);
+	slot.jammed = _cpu->is_jammed();
+	slot.pc_high = _cpu->get_pc_high();
+	slot.pc_low = _cpu->get_pc_low();
+	slot.a = _cpu->get_accumulator();
+	slot.x = _cpu->get_x();
+	slot.y = _cpu->get_y();
+	slot.sp = _cpu->get_sp();
+	slot.status = _cpu->get_status();
+	slot.sflags = _cpu->get_sflags();
+	slot.output = _cpu->get_output();
+
+	_back = _middle.exchange(_back | FRESH, std::memory_order_acq_rel) & 3;
+
+	if (_shared != nullptr) {
+		_shared->publish(*_cpu, _instructions);
+	}
+}
+
+/// <summary>
+/// Holds the worker while paused, running single step requests and publishing once on the way in so readers see where it stopped
+/// the lock is only taken when not running freely, so the running loop only ever pays for an atomic load here
+/// </summary>
+/// <returns>false once stop() has been called</returns>
+bool RunController::park() {
+	if (_mode.load(std::memory_order_acquire) != RUN_PAUSED && !_quit.load(std::memory_order_relaxed)) {
+		return true;
+	}
+	std::unique_lock<std::mutex> guard(_lock);
+	while (!_quit.load()) {
+		if (_step_pending) {
+			_instructions += _cpu->run(_step_request);
+			publish();
+			_step_pending = false;
+			_done.notify_all();
+			continue;
+		}
+		if (_mode.load() != RUN_PAUSED) {
+			return true;
+		}
+		if (!_parked) {
+			_last_mode = RUN_PAUSED;
+			publish();
+			_parked = true;
+			_done.notify_all();
+		}
+		_wake.wait(guard);
+	}
+	_done.notify_all();
+	return false;
+}
+
+/// <summary>
+/// Runs one quantum of cycles and then sleeps until the time those cycles should have taken at the target frequency
+/// the deadline is worked out from the epoch, so oversleeping on one burst just makes the next sleep shorter and the average speed stays on target,
+/// if the host falls far behind (a debugger break, the machine sleeping) the epoch is moved up instead of running flat out to catch up
+/// </summary>
+void RunController::run_burst() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double frequency = _target_frequency.load(std::memory_order_relaxed);
+	if (_last_mode != RUN_THROTTLED || frequency != _epoch_frequency) {
+		_epoch = now;
+		_epoch_cycles = _cpu->get_cycles();
+		_epoch_frequency = frequency;
+		_last_mode = RUN_THROTTLED;
+	}
+	unsigned long long budget = (unsigned long long)(frequency * (double)_quantum_us.load(std::memory_order_relaxed) / 1000000.0);
+	_instructions += _cpu->run_cycles(budget > 0 ? budget : 1);
+	if (_cpu->is_jammed()) {
+		return;
+	}
+
+	double due_seconds = (double)(_cpu->get_cycles() - _epoch_cycles) / frequency;
+	std::chrono::steady_clock::time_point deadline = _epoch + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(due_seconds));
+	now = std::chrono::steady_clock::now();
+	if (now < deadline) {
+		std::this_thread::sleep_until(deadline);
+		double late_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - deadline).count();
+		_jitter_sum_us += late_us;
+		_jitter_max_us = late_us > _jitter_max_us ? late_us : _jitter_max_us;
+		_jitter_samples++;
+	}
+	else if (now - deadline > std::chrono::milliseconds(100)) {
+		_epoch = now;
+		_epoch_cycles = _cpu->get_cycles();
+	}
+}
+
+void RunController::thread_main() {
+	while (park()) {
+		if (_mode.load(std::memory_order_relaxed) == RUN_THROTTLED) {
+			run_burst();
+		}
+		else {
+			_last_mode = RUN_FREE;
+			_instructions += _cpu->run(_batch.load(std::memory_order_relaxed));
+		}
+		if (_shared != nullptr) {
+			_shared->publish(*_cpu, _instructions); //a few stores per batch, so monitors see the program counter move far more often than publications happen
+		}
+		if (_cpu->is_jammed()) {
+			_mode.store(RUN_PAUSED); //nothing more to run, park() publishes the final state
+			continue;
+		}
+		if (std::chrono::steady_clock::now() - _last_publish >= std::chrono::milliseconds(_publish_interval_ms.load(std::memory_order_relaxed))) {
+			publish();
+		}
+	}
+}
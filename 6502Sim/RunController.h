@@ -0,0 +1,134 @@
+#pragma once
+#include "Processor.h"
+#include "SharedState.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Enum for what the run controller's worker thread is doing
+/// </summary>
+enum RUN_MODES {
+	RUN_PAUSED, RUN_FREE, RUN_THROTTLED
+};
+
+/// <summary>
+/// What the run controller publishes for readers, registers, counters and a full copy of the RAM
+/// page_version records the sequence number of the last publication each 256 byte page changed in, so a reader that remembers the last sequence it looked at
+/// can find what changed since then, even if it skipped some publications in between (see get_changes)
+/// </summary>
+struct PublishedState {
+	unsigned long long sequence; //0 until the first publication
+	unsigned long long instructions; //total run by the controller
+	double instructions_per_second; //measured over the last publication interval
+	unsigned long long cycles; //processor cycle count (base cycles, see Processor::get_cycles)
+	double cycles_per_second; //actual clock speed over the last publication interval
+	double target_frequency; //clock speed asked for in throttled mode, in Hz
+	double jitter_mean_us; //throttled mode, mean of how late each burst woke up compared to its deadline, over the last publication interval
+	double jitter_max_us; //and the worst one
+	RUN_MODES mode;
+	bool jammed;
+	unsigned char pc_high;
+	unsigned char pc_low;
+	unsigned char a;
+	unsigned char x;
+	unsigned char y;
+	unsigned char sp;
+	unsigned char status; //real 6502 bit order
+	unsigned char sflags; //the raw flag register, as get_sflags returns it
+	unsigned char output;
+	unsigned long long page_version[256];
+	std::vector<unsigned char> ram;
+
+	/// <summary>
+	/// Fills ranges with the pages that changed after publication since_sequence, adjacent pages merged
+	/// </summary>
+	void get_changes(unsigned long long since_sequence, std::vector<MemoryRange>& ranges) const;
+};
+
+/// <summary>
+/// Runs a Processor on its own thread so that continuous execution doesn't hold up whoever is driving it (the GUI's message loop).
+/// The worker runs the processor in batches and every publish interval copies registers and the RAM pages that changed into a triple buffer,
+/// readers pick up the latest complete copy with read(), which never takes a lock or waits on the worker, and the worker never waits on readers either.
+/// The triple buffer has a single reader side, so there should be one reading thread (the GUI thread).
+/// With a SharedState attached the registers also go to its mapping after every batch, for monitors in other processes (see SharedState).
+/// In throttled mode the worker runs a quantum's worth of cycles at a time and sleeps until the clock catches up, so the host does next to nothing between bursts.
+/// While the controller exists, the processor must only be touched while paused (pause() returns once the worker has actually stopped).
+/// </summary>
+class RunController
+{
+private:
+	static const unsigned int FRESH = 4; //set on _middle when it holds a publication the reader hasn't picked up yet
+
+	Processor* _cpu;
+	SharedState* _shared; //register page for out of process monitors, or nullptr
+	std::thread _worker;
+
+	//triple buffer, the worker owns _back, the reader owns _front, and they swap through _middle
+	PublishedState _slots[3];
+	std::atomic<unsigned int> _middle;
+	unsigned int _back;
+	unsigned int _front;
+
+	//worker side bookkeeping for publishing
+	unsigned long long _sequence;
+	unsigned long long _page_version[256];
+	std::vector<MemoryRange> _changes;
+	unsigned long long _instructions;
+	unsigned long long _instructions_at_publish;
+	std::chrono::steady_clock::time_point _last_publish;
+	unsigned long long _cycles_at_publish;
+
+	//throttled mode, bursts are timed against an epoch (a point in time and the cycle count at that point) rather than against the previous burst, so sleep overshoot doesn't add up
+	std::atomic<double> _target_frequency;
+	std::atomic<unsigned int> _quantum_us; //burst length, atomic like the frequency since set_quantum can be called while running
+	std::chrono::steady_clock::time_point _epoch;
+	unsigned long long _epoch_cycles;
+	double _epoch_frequency; //frequency the epoch was started at, changing the frequency restarts the epoch
+	int _last_mode; //mode the worker last ran in, a change restarts the epoch, only used by the worker
+	double _jitter_sum_us;
+	double _jitter_max_us;
+	unsigned long long _jitter_samples;
+
+	//commands, the atomics are checked by the worker between batches, the mutex and condition variable are only used to park the worker and to wait on it
+	std::atomic<int> _mode;
+	std::atomic<bool> _quit;
+	std::mutex _lock;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	unsigned long long _step_request; //steps asked for while paused, guarded by _lock
+	bool _step_pending; //guarded by _lock
+	bool _parked; //guarded by _lock
+
+	//settings, atomics since they can be changed from the controlling thread while the worker is running
+	std::atomic<unsigned long long> _batch;
+	std::atomic<unsigned int> _publish_interval_ms;
+
+	void thread_main();
+	void publish();
+	bool park(); //waits while paused, returns false once it's time to quit
+	void run_burst(); //one throttled quantum, then sleep until it's due
+
+public:
+	RunController(Processor* cpu); //the controller doesn't take ownership, the processor has to outlive it
+	~RunController();
+
+	void start(); //starts the worker thread, paused
+	void stop(); //stops and joins the worker thread
+	void resume(); //run freely
+	void throttle(double frequency); //run at a real clock speed in Hz (1000000 for a 1MHz 6502)
+	void pause(); //stop running, returns once the worker is parked and the processor is safe to touch
+	void step(unsigned long long count); //run count instructions while paused and publish, returns once done, count 0 only republishes (after loading a program and such)
+	bool is_running();
+
+	void set_batch(unsigned long long instructions); //instructions per batch between command checks, default 1000, can be changed while running and takes effect from the next batch
+	void set_publish_interval(unsigned int milliseconds); //default 16 (about 60 per second), can be changed while running
+	void set_quantum(unsigned int microseconds); //length of a throttled burst, shorter is smoother but wakes the host more often, default 2000, can be changed while running
+
+	void attach_shared(SharedState* shared); //also write the registers to a shared mapping after every batch, only while paused, nullptr detaches, not owned
+
+	const PublishedState& read(); //the latest publication, stays valid and unchanged until the next call to read
+};
@@ -0,0 +1,209 @@
+#include "SampleProfiler.h"
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#include <chrono>
+#include <thread>
+#else
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+std::atomic<bool> SampleTimer::_pending(false);
+
+#ifdef _WIN32
+static std::thread timer_thread;
+static std::atomic<bool> timer_running(false);
+#else
+static bool timer_running = false;
+
+static void on_sigprof(int) {
+	SampleTimer::request();
+}
+#endif
+
+/// <summary>
+/// Starts the host timer
+/// </summary>
+/// <param name="microseconds">time between samples, on Windows anything under a millisecond or so gets rounded up by the scheduler</param>
+bool SampleTimer::start(unsigned int microseconds) {
+	if (microseconds == 0) {
+		return false;
+	}
+#ifdef _WIN32
+	if (timer_running.exchange(true)) {
+		return false;
+	}
+	timer_thread = std::thread([microseconds] {
+		std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+		while (timer_running.load()) {
+			next += std::chrono::microseconds(microseconds);
+			std::this_thread::sleep_until(next);
+			request();
+		}
+	});
+#else
+	if (timer_running) {
+		return false;
+	}
+	struct sigaction action;
+	action.sa_handler = on_sigprof;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	if (sigaction(SIGPROF, &action, nullptr) != 0) {
+		return false;
+	}
+	struct itimerval timer;
+	timer.it_interval.tv_sec = microseconds / 1000000;
+	timer.it_interval.tv_usec = microseconds % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+		return false;
+	}
+	timer_running = true;
+#endif
+	return true;
+}
+
+void SampleTimer::stop() {
+#ifdef _WIN32
+	if (timer_running.exchange(false) && timer_thread.joinable()) {
+		timer_thread.join();
+	}
+#else
+	if (!timer_running) {
+		return;
+	}
+	struct itimerval timer = {};
+	setitimer(ITIMER_PROF, &timer, nullptr);
+	signal(SIGPROF, SIG_IGN);
+	timer_running = false;
+#endif
+	_pending.store(false);
+}
+
+SamplingHooks::SamplingHooks() : _histogram(65536, 0) {
+	_track_stacks = true;
+	_interval = 1000;
+	_next_sample = 0;
+	_samples = 0;
+}
+
+void SamplingHooks::set_interval(unsigned long long cycles) {
+	_interval = cycles;
+	_next_sample = 0;
+}
+
+void SamplingHooks::set_stacks(bool enabled) {
+	_track_stacks = enabled;
+	_stack.clear();
+}
+
+void SamplingHooks::reset() {
+	_histogram.assign(_histogram.size(), 0);
+	_stacks.clear();
+	_next_sample = 0;
+	_samples = 0;
+}
+
+unsigned long long SamplingHooks::get_samples() const {
+	return _samples;
+}
+
+const std::vector<unsigned long long>& SamplingHooks::histogram() const {
+	return _histogram;
+}
+
+/// <summary>
+/// Records weight samples for the instruction at address, and for the call stack it was reached through
+/// </summary>
+void SamplingHooks::sample(unsigned short address, unsigned long long weight) {
+	_histogram[address] += weight;
+	_samples += weight;
+	if (_track_stacks) {
+		const std::vector<CallFrame>& frames = _stack.frames();
+		std::vector<unsigned short> key(frames.size() + 1);
+		for (size_t i = 0; i < frames.size(); i++) {
+			key[i] = frames[i].entry;
+		}
+		key[frames.size()] = address;
+		_stacks[key] += weight;
+	}
+}
+
+/// <summary>
+/// Name of the routine an address is in, the bare address without symbols
+/// </summary>
+static std::string routine_name(SymbolTable& symbols, unsigned short address) {
+	const Symbol* symbol = symbols.lookup(address);
+	if (symbol != nullptr) {
+		return symbol->name;
+	}
+	char text[8];
+	snprintf(text, sizeof(text), "$%04X", address);
+	return text;
+}
+
+/// <summary>
+/// Writes the flat profile, one line per routine with its share of the samples and the address inside it that got the most
+/// </summary>
+void SamplingHooks::write_flat(FILE* output, SymbolTable& symbols) {
+	struct Routine {
+		std::string name;
+		unsigned long long samples;
+		unsigned short hottest;
+		unsigned long long hottest_samples;
+	};
+	std::map<std::string, Routine> routines;
+	for (unsigned int address = 0; address < 65536; address++) {
+		if (_histogram[address] == 0) {
+			continue;
+		}
+		std::string name = routine_name(symbols, (unsigned short)address);
+		Routine& routine = routines[name];
+		if (routine.name.empty()) {
+			routine.name = name;
+			routine.samples = 0;
+			routine.hottest_samples = 0;
+		}
+		routine.samples += _histogram[address];
+		if (_histogram[address] > routine.hottest_samples) {
+			routine.hottest = (unsigned short)address;
+			routine.hottest_samples = _histogram[address];
+		}
+	}
+	std::vector<Routine> order;
+	for (std::map<std::string, Routine>::const_iterator it = routines.begin(); it != routines.end(); ++it) {
+		order.push_back(it->second);
+	}
+	std::sort(order.begin(), order.end(), [](const Routine& left, const Routine& right) { return left.samples > right.samples; });
+
+	fprintf(output, "%12s %8s %8s  %-8s %s\n", "samples", "share", "total", "hottest", "routine");
+	unsigned long long running = 0;
+	for (size_t i = 0; i < order.size(); i++) {
+		running += order[i].samples;
+		fprintf(output, "%12llu %7.2f%% %7.2f%%  $%04X    %s\n", order[i].samples, 100.0 * (double)order[i].samples / (double)_samples,
+			100.0 * (double)running / (double)_samples, order[i].hottest, order[i].name.c_str());
+	}
+}
+
+/// <summary>
+/// Writes the samples as folded stacks, stacks that come out the same once addresses are turned into routine names are merged
+/// </summary>
+void SamplingHooks::write_folded(FILE* output, SymbolTable& symbols) {
+	std::map<std::string, unsigned long long> folded;
+	for (std::map<std::vector<unsigned short>, unsigned long long>::const_iterator it = _stacks.begin(); it != _stacks.end(); ++it) {
+		std::string line;
+		for (size_t i = 0; i < it->first.size(); i++) {
+			if (i > 0) {
+				line += ';';
+			}
+			line += routine_name(symbols, it->first[i]);
+		}
+		folded[line] += it->second;
+	}
+	for (std::map<std::string, unsigned long long>::const_iterator it = folded.begin(); it != folded.end(); ++it) {
+		fprintf(output, "%s %llu\n", it->first.c_str(), it->second);
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "ProcessorHooks.h"
+#include "CallStack.h"
+#include "Symbols.h"
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+/// <summary>
+/// A host timer that asks the profiler for a sample, as an alternative to sampling every so many guest cycles, so the profile is of where host time goes
+/// POSIX uses SIGPROF (setitimer, counting the process's CPU time), Windows a thread that wakes up every interval, the only thing either does is set a flag
+/// that the profiler picks up after the next instruction, so the sample always lands between instructions
+/// </summary>
+class SampleTimer
+{
+private:
+	static std::atomic<bool> _pending;
+
+public:
+	static bool start(unsigned int microseconds); //false if a timer is already running or it couldn't be set up
+	static void stop();
+
+	static bool take() {
+		if (!_pending.load(std::memory_order_relaxed)) {
+			return false;
+		}
+		_pending.store(false, std::memory_order_relaxed);
+		return true;
+	}
+
+	static void request() {
+		_pending.store(true, std::memory_order_relaxed); //what the timer does, safe from a signal handler since the atomic is lock free
+	}
+};
+
+/// <summary>
+/// Hooks policy for a sampling profiler: every interval cycles (or whenever the SampleTimer fires) the instruction that was running gets a sample
+/// in a 64K entry histogram, and with stacks on, the guest call stack at that point (see ShadowStack) gets one too, for flame graphs.
+/// An instruction that runs over more than one sample point gets all of them, so the histogram adds up to cycles / interval.
+/// Reports group addresses by symbol with a SymbolTable, or show bare addresses without one.
+/// </summary>
+class SamplingHooks : public NullHooks
+{
+private:
+	std::vector<unsigned long long> _histogram; //samples per instruction address
+	std::map<std::vector<unsigned short>, unsigned long long> _stacks; //routine entry addresses outermost first, then the sampled address
+	ShadowStack _stack;
+	bool _track_stacks;
+	unsigned long long _interval; //cycles between samples, 0 for timer samples only
+	unsigned long long _next_sample; //0 until the first instruction
+	unsigned long long _samples;
+
+	void sample(unsigned short address, unsigned long long weight);
+
+public:
+	SamplingHooks();
+
+	void set_interval(unsigned long long cycles); //takes effect from the next instruction, default 1000
+	void set_stacks(bool enabled); //follow the call stack for folded stack output, on by default
+	void reset(); //throw away everything sampled so far
+
+	unsigned long long get_samples() const;
+	const std::vector<unsigned long long>& histogram() const;
+
+	void write_flat(FILE* output, SymbolTable& symbols); //samples per routine, most first
+	void write_folded(FILE* output, SymbolTable& symbols); //"outer;inner;leaf count" lines, the input flamegraph.pl and speedscope take
+
+	void on_fetch(unsigned short address, unsigned char opcode) {
+		_stack.fetch(address, opcode);
+	}
+
+	template <typename Cpu>
+	void on_instruction_retired(Cpu& cpu) {
+		unsigned long long cycles = cpu.get_cycles();
+		if (_track_stacks) {
+			_stack.retire((unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low()), cpu.get_sp(), cycles);
+		}
+		unsigned long long weight = 0;
+		if (_next_sample == 0) {
+			_next_sample = cycles + _interval; //first instruction since the interval was set, count from here rather than from whatever the processor ran before
+		}
+		else if (_interval > 0 && cycles >= _next_sample) {
+			weight = (cycles - _next_sample) / _interval + 1;
+			_next_sample += weight * _interval;
+		}
+		if (SampleTimer::take()) {
+			weight++;
+		}
+		if (weight > 0) {
+			sample(_stack.current_address(), weight);
+		}
+	}
+};
@@ -0,0 +1,262 @@
+#include "SharedState.h"
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "the sequence counter has to be a plain word, another process maps it");
+static_assert(sizeof(SharedHeader) <= SharedState::HEADER_SIZE, "the header has to fit its page");
+
+SharedState::SharedState() {
+	_base = nullptr;
+	_size = 0;
+	_owner = false;
+#ifdef _WIN32
+	_mapping = nullptr;
+#endif
+}
+
+SharedState::~SharedState() {
+	close();
+}
+
+/// <summary>
+/// Creates or opens the named mapping and maps size bytes of it, on POSIX the name gets the leading slash shm_open wants
+/// </summary>
+/// <param name="size">bytes to map, when opening an existing mapping this is how much of it to map</param>
+/// <param name="create">create a new mapping of this size, failing if the name already exists</param>
+/// <param name="writable">map it read/write, monitors map read only</param>
+/// <returns>false if anything failed, nothing is left open in that case</returns>
+bool SharedState::map(size_t size, bool create, bool writable) {
+#ifdef _WIN32
+	HANDLE mapping;
+	if (create) {
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)size, _name.c_str());
+		if (mapping != nullptr && GetLastError() == ERROR_ALREADY_EXISTS) {
+			CloseHandle(mapping);
+			return false;
+		}
+	}
+	else {
+		mapping = OpenFileMappingA(writable ? FILE_MAP_WRITE : FILE_MAP_READ, FALSE, _name.c_str());
+	}
+	if (mapping == nullptr) {
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		return false;
+	}
+	_mapping = mapping;
+	_base = (unsigned char*)view;
+#else
+	std::string path = _name[0] == '/' ? _name : "/" + _name;
+	int fd = create ? shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644) : shm_open(path.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+	if (fd < 0) {
+		return false;
+	}
+	if (create && ftruncate(fd, (off_t)size) != 0) {
+		::close(fd);
+		shm_unlink(path.c_str());
+		return false;
+	}
+	if (!create) {
+		struct stat info;
+		if (fstat(fd, &info) != 0 || (size_t)info.st_size < size) {
+			::close(fd);
+			return false;
+		}
+	}
+	void* view = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd); //the mapping keeps the memory alive on its own
+	if (view == MAP_FAILED) {
+		if (create) {
+			shm_unlink(path.c_str());
+		}
+		return false;
+	}
+	_base = (unsigned char*)view;
+#endif
+	_size = size;
+	return true;
+}
+
+/// <summary>
+/// Creates the mapping and fills in the header, the memory blocks come out zeroed (the Memory constructor clears them again anyway)
+/// </summary>
+/// <param name="name">name monitors open it by, a plain word works everywhere ("sim6502")</param>
+/// <param name="ram_size">size of the RAM block</param>
+/// <param name="rom_size">size of the ROM block, 0 for one block shared by code and data</param>
+/// <returns>false if a mapping is already open here, the name is taken, or the system said no</returns>
+bool SharedState::create(const char* name, unsigned int ram_size, unsigned int rom_size) {
+	if (_base != nullptr || name == nullptr || name[0] == '\0' || ram_size == 0) {
+		return false;
+	}
+	_name = name;
+	//the blocks start on page boundaries so each one can be handed to a Memory as is
+	size_t ram_pages = ((size_t)ram_size + HEADER_SIZE - 1) / HEADER_SIZE;
+	size_t rom_pages = ((size_t)rom_size + HEADER_SIZE - 1) / HEADER_SIZE;
+	if (!map(HEADER_SIZE * (1 + ram_pages + rom_pages), true, true)) {
+		return false;
+	}
+	_owner = true;
+
+	SharedHeader* head = new (_base) SharedHeader;
+	head->magic = SharedHeader::MAGIC;
+	head->version = SharedHeader::VERSION;
+	head->header_size = HEADER_SIZE;
+	head->ram_offset = HEADER_SIZE;
+	head->ram_size = ram_size;
+	head->rom_offset = rom_size > 0 ? (uint32_t)(HEADER_SIZE * (1 + ram_pages)) : HEADER_SIZE;
+	head->rom_size = rom_size > 0 ? rom_size : ram_size;
+	head->instructions = 0;
+	head->cycles = 0;
+	head->pc = 0;
+	head->a = head->x = head->y = head->sp = head->status = head->jammed = 0;
+	head->sequence.store(0, std::memory_order_release);
+	return true;
+}
+
+/// <summary>
+/// Maps somebody else's mapping read only, checking the header before trusting any of the offsets in it
+/// </summary>
+/// <param name="name">the name it was created with</param>
+/// <returns>false if it doesn't exist, isn't ours, is from another version, or is smaller than the header says</returns>
+bool SharedState::open(const char* name) {
+	if (_base != nullptr || name == nullptr || name[0] == '\0') {
+		return false;
+	}
+	_name = name;
+	if (!map(HEADER_SIZE, false, false)) {
+		return false;
+	}
+	const SharedHeader* head = header();
+	if (head->magic != SharedHeader::MAGIC || head->version != SharedHeader::VERSION) {
+		close();
+		return false;
+	}
+	size_t ram_end = (size_t)head->ram_offset + head->ram_size;
+	size_t rom_end = (size_t)head->rom_offset + head->rom_size;
+	size_t size = ram_end > rom_end ? ram_end : rom_end;
+	close();
+
+	//map again, now that the whole size is known
+	_name = name;
+	if (!map(size, false, false)) {
+		return false;
+	}
+	return true;
+}
+
+void SharedState::close() {
+	if (_base == nullptr) {
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(_base);
+	CloseHandle((HANDLE)_mapping); //windows removes the name along with the last handle
+	_mapping = nullptr;
+#else
+	munmap(_base, _size);
+	if (_owner) {
+		shm_unlink((_name[0] == '/' ? _name : "/" + _name).c_str());
+	}
+#endif
+	_base = nullptr;
+	_size = 0;
+	_owner = false;
+}
+
+bool SharedState::is_open() const {
+	return _base != nullptr;
+}
+
+unsigned char* SharedState::ram_storage() {
+	return _owner ? _base + header()->ram_offset : nullptr;
+}
+
+unsigned char* SharedState::rom_storage() {
+	return _owner ? _base + header()->rom_offset : nullptr;
+}
+
+const unsigned char* SharedState::ram() const {
+	return _base != nullptr ? _base + header()->ram_offset : nullptr;
+}
+
+const unsigned char* SharedState::rom() const {
+	return _base != nullptr ? _base + header()->rom_offset : nullptr;
+}
+
+const SharedHeader* SharedState::header() const {
+	return (const SharedHeader*)_base;
+}
+
+/// <summary>
+/// Writes the registers and counters under the sequence lock, the release fence keeps the field stores from moving above the odd sequence value,
+/// and the release store of the even value keeps them from moving below it
+/// </summary>
+/// <param name="cpu">the processor, which has to be stopped between instructions (the run controller's worker calls this between batches)</param>
+/// <param name="instructions">instruction count to publish alongside, whatever the caller counts</param>
+void SharedState::publish(Processor& cpu, unsigned long long instructions) {
+	if (!_owner) {
+		return;
+	}
+	SharedHeader* head = (SharedHeader*)_base;
+	uint32_t sequence = head->sequence.load(std::memory_order_relaxed);
+	head->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	head->instructions = instructions;
+	head->cycles = cpu.get_cycles();
+	head->pc = (uint16_t)((cpu.get_pc_high() << 8) | cpu.get_pc_low());
+	head->a = cpu.get_accumulator();
+	head->x = cpu.get_x();
+	head->y = cpu.get_y();
+	head->sp = cpu.get_sp();
+	head->status = cpu.get_status();
+	head->jammed = cpu.is_jammed() ? 1 : 0;
+
+	head->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/// <summary>
+/// Copies the registers out, retrying while the writer is part way through, the writer never waits for readers so any number of monitors can poll this
+/// </summary>
+/// <param name="registers">filled in on success</param>
+/// <param name="max_attempts">how many times to retry before giving up</param>
+/// <returns>false if no consistent copy was had within max_attempts (or nothing is open)</returns>
+bool SharedState::read_registers(SharedRegisters& registers, unsigned int max_attempts) const {
+	if (_base == nullptr) {
+		return false;
+	}
+	const SharedHeader* head = header();
+	for (unsigned int attempt = 0; attempt < max_attempts; attempt++) {
+		uint32_t before = head->sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			continue; //being written right now
+		}
+		registers.instructions = head->instructions;
+		registers.cycles = head->cycles;
+		registers.pc = head->pc;
+		registers.a = head->a;
+		registers.x = head->x;
+		registers.y = head->y;
+		registers.sp = head->sp;
+		registers.status = head->status;
+		registers.jammed = head->jammed;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (head->sequence.load(std::memory_order_relaxed) == before) {
+			registers.sequence = before;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Processor.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// The page at the start of a shared mapping, everything a monitor needs to find the memory blocks and the last published registers
+/// the register fields are written under a sequence lock: the writer makes sequence odd, writes, then makes it even again, so a reader that sees the same even
+/// value before and after copying them got a consistent set (see SharedState::read_registers)
+/// </summary>
+struct SharedHeader {
+	static const uint32_t MAGIC = 0x4D353653; //"S65M" in memory on a little endian host
+	static const uint32_t VERSION = 1;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t header_size; //offset of the first memory block, a whole page
+	uint32_t ram_offset;
+	uint32_t ram_size;
+	uint32_t rom_offset; //same as ram_offset for a unified memory
+	uint32_t rom_size;
+	std::atomic<uint32_t> sequence;
+
+	//written under the sequence lock
+	uint64_t instructions;
+	uint64_t cycles;
+	uint16_t pc;
+	uint8_t a;
+	uint8_t x;
+	uint8_t y;
+	uint8_t sp;
+	uint8_t status; //real 6502 bit order
+	uint8_t jammed;
+};
+
+/// <summary>
+/// A consistent copy of the published registers, what read_registers hands back
+/// </summary>
+struct SharedRegisters {
+	uint32_t sequence; //changes with every publication, so a monitor can tell whether anything happened since its last sample
+	uint64_t instructions;
+	uint64_t cycles;
+	uint16_t pc;
+	uint8_t a;
+	uint8_t x;
+	uint8_t y;
+	uint8_t sp;
+	uint8_t status;
+	uint8_t jammed;
+};
+
+/// <summary>
+/// A named shared memory mapping holding a register page and the processor's memory blocks, so monitors in other processes can watch a running emulator
+/// without any calls into it and without copies: the Processor is built straight on the mapped blocks (see Processor's storage constructor), so RAM in the mapping is
+/// always live, and the registers are written to the header page whenever the owner publishes (RunController does it after every batch, which costs a handful of stores).
+/// POSIX uses shm_open (rather than memfd, which can't be opened by name from an unrelated process), the name shows up under /dev/shm.
+/// Windows uses a named file mapping backed by the page file.
+/// RAM read through the mapping is not synchronized with the processor, a monitor sees bytes as they are being written, which is the point (no impact on the run loop).
+/// </summary>
+class SharedState
+{
+private:
+	std::string _name;
+	unsigned char* _base;
+	size_t _size;
+	bool _owner; //the creator removes the name again on close
+#ifdef _WIN32
+	void* _mapping;
+#endif
+
+	bool map(size_t size, bool create, bool writable);
+
+public:
+	static const uint32_t HEADER_SIZE = 4096;
+
+	SharedState();
+	~SharedState();
+
+	//emulator side
+	bool create(const char* name, unsigned int ram_size, unsigned int rom_size); //rom_size 0 for a unified memory, fails if the name is taken or a mapping is already open
+	unsigned char* ram_storage(); //blocks to build the Processor on, only valid while the mapping is open
+	unsigned char* rom_storage();
+	void publish(Processor& cpu, unsigned long long instructions); //write the registers under the sequence lock, single writer
+
+	//monitor side
+	bool open(const char* name); //map an existing mapping read only, fails if it isn't one of ours
+	bool read_registers(SharedRegisters& registers, unsigned int max_attempts = 1000) const; //false if the writer kept getting in the way
+	const unsigned char* ram() const;
+	const unsigned char* rom() const;
+	const SharedHeader* header() const;
+
+	void close(); //unmap, and remove the name if this side created it
+	bool is_open() const;
+};
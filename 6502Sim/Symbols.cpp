@@ -0,0 +1,323 @@
+#include "Symbols.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+SymbolTable::SymbolTable() {
+	_sorted = true;
+}
+
+/// <summary>
+/// Parses a hex address with an optional $ or 0x in front
+/// </summary>
+/// <returns>false if it isn't a hex number that fits in 16 bits</returns>
+static bool parse_address(const std::string& text, unsigned short& address) {
+	size_t start = 0;
+	if (text.compare(0, 1, "$") == 0) {
+		start = 1;
+	}
+	else if (text.compare(0, 2, "0x") == 0 || text.compare(0, 2, "0X") == 0) {
+		start = 2;
+	}
+	if (start >= text.size() || text.find_first_not_of("0123456789abcdefABCDEF", start) != std::string::npos) {
+		return false;
+	}
+	unsigned long value = strtoul(text.c_str() + start, nullptr, 16);
+	if (value > 0xFFFF) {
+		return false;
+	}
+	address = (unsigned short)value;
+	return true;
+}
+
+/// <summary>
+/// Pulls a field out of a .dbg record (key=value pairs split by commas), quotes around the value are taken off
+/// </summary>
+static std::string dbg_field(const std::string& line, const char* key) {
+	std::string pattern = std::string(key) + "=";
+	size_t at = 0;
+	while ((at = line.find(pattern, at)) != std::string::npos) {
+		if (at == 0 || line[at - 1] == ',' || line[at - 1] == '\t' || line[at - 1] == ' ') {
+			break;
+		}
+		at += pattern.size();
+	}
+	if (at == std::string::npos) {
+		return std::string();
+	}
+	at += pattern.size();
+	if (at < line.size() && line[at] == '"') {
+		size_t end = line.find('"', at + 1);
+		return line.substr(at + 1, end == std::string::npos ? std::string::npos : end - at - 1);
+	}
+	size_t end = line.find(',', at);
+	return line.substr(at, end == std::string::npos ? std::string::npos : end - at);
+}
+
+/// <summary>
+/// Loads a symbol file, with SYMBOLS_AUTO the format is worked out from the first line that isn't blank
+/// </summary>
+/// <param name="path">the file</param>
+/// <param name="format">what kind of file it is</param>
+/// <returns>false if the file couldn't be opened, lines that don't parse are skipped</returns>
+bool SymbolTable::load(const char* path, SYMBOL_FORMATS format) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::string line;
+	while (std::getline(file, line)) {
+		while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+			line.pop_back();
+		}
+		if (line.empty()) {
+			continue;
+		}
+		if (format == SYMBOLS_AUTO) {
+			if (line.compare(0, 8, "version\t") == 0 || line.compare(0, 8, "version ") == 0) {
+				format = SYMBOLS_CA65_DBG;
+			}
+			else if (line.compare(0, 3, "al ") == 0) {
+				format = SYMBOLS_VICE;
+			}
+			else {
+				format = SYMBOLS_PLAIN;
+			}
+		}
+
+		unsigned short address;
+		switch (format) {
+		case SYMBOLS_CA65_DBG: {
+			if (line.compare(0, 4, "sym\t") != 0 && line.compare(0, 4, "sym ") != 0) {
+				break;
+			}
+			if (dbg_field(line, "type") != "lab") {
+				break;
+			}
+			std::string name = dbg_field(line, "name");
+			if (!name.empty() && parse_address(dbg_field(line, "val"), address)) {
+				add(address, name);
+			}
+		}
+			break;
+		case SYMBOLS_VICE: {
+			//al C:0810 .main, the C: (memory space) is optional
+			std::istringstream fields(line);
+			std::string tag, space_address, name;
+			if (!(fields >> tag >> space_address >> name) || tag != "al") {
+				break;
+			}
+			size_t colon = space_address.find(':');
+			if (parse_address(colon != std::string::npos ? space_address.substr(colon + 1) : space_address, address)) {
+				add(address, name[0] == '.' ? name.substr(1) : name);
+			}
+		}
+			break;
+		default: {
+			if (line[0] == '#' || line[0] == ';') {
+				break;
+			}
+			size_t split = line.find_first_of(" \t");
+			if (split == std::string::npos) {
+				break;
+			}
+			size_t name_start = line.find_first_not_of(" \t=", split);
+			if (name_start != std::string::npos && parse_address(line.substr(0, split), address)) {
+				add(address, line.substr(name_start));
+			}
+		}
+			break;
+		}
+	}
+	return true;
+}
+
+void SymbolTable::add(unsigned short address, const std::string& name) {
+	Symbol symbol;
+	symbol.address = address;
+	symbol.name = name;
+	_symbols.push_back(symbol);
+	_sorted = false;
+}
+
+void SymbolTable::clear() {
+	_symbols.clear();
+	_sorted = true;
+}
+
+/// <summary>
+/// Sorts by address and keeps only the first name given for each address, stable so "first" means first loaded
+/// </summary>
+void SymbolTable::sort() {
+	std::stable_sort(_symbols.begin(), _symbols.end(), [](const Symbol& left, const Symbol& right) { return left.address < right.address; });
+	_symbols.erase(std::unique(_symbols.begin(), _symbols.end(), [](const Symbol& left, const Symbol& right) { return left.address == right.address; }), _symbols.end());
+	_sorted = true;
+}
+
+/// <summary>
+/// Finds the symbol whose range covers the address, the table is sorted on the first lookup after anything was added
+/// </summary>
+const Symbol* SymbolTable::lookup(unsigned short address) {
+	if (!_sorted) {
+		sort();
+	}
+	std::vector<Symbol>::const_iterator next = std::upper_bound(_symbols.begin(), _symbols.end(), address, [](unsigned short value, const Symbol& symbol) { return value < symbol.address; });
+	if (next == _symbols.begin()) {
+		return nullptr;
+	}
+	return &*(next - 1);
+}
+
+std::string SymbolTable::describe(unsigned short address) {
+	char text[16];
+	const Symbol* symbol = lookup(address);
+	if (symbol == nullptr) {
+		snprintf(text, sizeof(text), "$%04X", address);
+		return text;
+	}
+	if (symbol->address == address) {
+		return symbol->name;
+	}
+	snprintf(text, sizeof(text), "+%X", address - symbol->address);
+	return symbol->name + text;
+}
+
+const std::vector<Symbol>& SymbolTable::symbols() {
+	if (!_sorted) {
+		sort();
+	}
+	return _symbols;
+}
+
+bool SymbolTable::empty() const {
+	return _symbols.empty();
+}
+
+/// <summary>
+/// Reads the line info out of an ld65 .dbg file: a "line" record names its file and the spans (byte ranges, "3+4" for more than one) it made,
+/// a span is an offset into a segment, and the segment has the address, so each span comes out as a SourceLine
+/// </summary>
+/// <returns>false if the file couldn't be opened or doesn't start with a .dbg version record</returns>
+bool LineTable::load(const char* path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	struct Span {
+		unsigned int segment;
+		unsigned long start;
+		unsigned long size;
+	};
+	struct Line {
+		unsigned int file;
+		unsigned int line;
+		std::string spans;
+	};
+	std::map<unsigned int, unsigned int> file_indexes; //.dbg file id to index in _files
+	std::map<unsigned int, unsigned long> segment_starts;
+	std::map<unsigned int, Span> spans;
+	std::vector<Line> lines;
+
+	std::string record;
+	bool first = true;
+	while (std::getline(file, record)) {
+		while (!record.empty() && (record.back() == '\r' || record.back() == ' ' || record.back() == '\t')) {
+			record.pop_back();
+		}
+		if (record.empty()) {
+			continue;
+		}
+		size_t split = record.find_first_of(" \t");
+		std::string kind = record.substr(0, split);
+		if (first) {
+			if (kind != "version") {
+				return false;
+			}
+			first = false;
+		}
+		unsigned int id = (unsigned int)strtoul(dbg_field(record, "id").c_str(), nullptr, 10);
+		if (kind == "file") {
+			file_indexes[id] = (unsigned int)_files.size();
+			_files.push_back(dbg_field(record, "name"));
+		}
+		else if (kind == "seg") {
+			segment_starts[id] = strtoul(dbg_field(record, "start").c_str(), nullptr, 0);
+		}
+		else if (kind == "span") {
+			Span span;
+			span.segment = (unsigned int)strtoul(dbg_field(record, "seg").c_str(), nullptr, 10);
+			span.start = strtoul(dbg_field(record, "start").c_str(), nullptr, 0);
+			span.size = strtoul(dbg_field(record, "size").c_str(), nullptr, 0);
+			spans[id] = span;
+		}
+		else if (kind == "line") {
+			std::string spans_field = dbg_field(record, "span");
+			if (spans_field.empty() || dbg_field(record, "type") == "2") {
+				continue; //no code, or inside a macro expansion
+			}
+			Line line;
+			line.file = (unsigned int)strtoul(dbg_field(record, "file").c_str(), nullptr, 10);
+			line.line = (unsigned int)strtoul(dbg_field(record, "line").c_str(), nullptr, 10);
+			line.spans = spans_field;
+			lines.push_back(line);
+		}
+	}
+
+	for (size_t i = 0; i < lines.size(); i++) {
+		std::map<unsigned int, unsigned int>::const_iterator file_index = file_indexes.find(lines[i].file);
+		if (file_index == file_indexes.end()) {
+			continue;
+		}
+		std::istringstream ids(lines[i].spans);
+		std::string span_id;
+		while (std::getline(ids, span_id, '+')) {
+			std::map<unsigned int, Span>::const_iterator span = spans.find((unsigned int)strtoul(span_id.c_str(), nullptr, 10));
+			if (span == spans.end() || span->second.size == 0) {
+				continue;
+			}
+			std::map<unsigned int, unsigned long>::const_iterator segment = segment_starts.find(span->second.segment);
+			unsigned long address = (segment != segment_starts.end() ? segment->second : 0) + span->second.start;
+			if (address > 0xFFFF) {
+				continue;
+			}
+			SourceLine source;
+			source.address = (unsigned short)address;
+			source.size = (unsigned short)std::min(std::min(span->second.size, 0x10000UL - address), 0xFFFFUL);
+			source.file = file_index->second;
+			source.line = lines[i].line;
+			_lines.push_back(source);
+		}
+	}
+	std::stable_sort(_lines.begin(), _lines.end(), [](const SourceLine& left, const SourceLine& right) { return left.address < right.address; });
+	return true;
+}
+
+void LineTable::clear() {
+	_lines.clear();
+	_files.clear();
+}
+
+const SourceLine* LineTable::lookup(unsigned short address) const {
+	std::vector<SourceLine>::const_iterator next = std::upper_bound(_lines.begin(), _lines.end(), address, [](unsigned short value, const SourceLine& line) { return value < line.address; });
+	if (next == _lines.begin()) {
+		return nullptr;
+	}
+	--next;
+	return (unsigned int)address < (unsigned int)next->address + next->size ? &*next : nullptr;
+}
+
+const std::vector<SourceLine>& LineTable::lines() const {
+	return _lines;
+}
+
+const std::vector<std::string>& LineTable::files() const {
+	return _files;
+}
+
+bool LineTable::empty() const {
+	return _lines.empty();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Enum for the symbol file formats SymbolTable understands, SYMBOLS_AUTO picks one by looking at the file
+/// </summary>
+enum SYMBOL_FORMATS {
+	SYMBOLS_AUTO, SYMBOLS_PLAIN, SYMBOLS_VICE, SYMBOLS_CA65_DBG
+};
+
+struct Symbol {
+	unsigned short address;
+	std::string name;
+};
+
+/// <summary>
+/// Guest symbols for reports (profiles, coverage and the like), each symbol is taken to cover the addresses from its own up to the next symbol's,
+/// so looking an address up is a binary search for the last symbol at or below it.
+/// Formats:
+///   plain      one "address name" pair per line, address in hex with or without a leading $ or 0x, lines starting with # or ; are skipped
+///   VICE       the label files VICE and ld65 -Ln write, "al C:0810 .main"
+///   ca65 .dbg  ld65's --dbgfile output, the "sym" records of type lab (equates are constants, not code, so they're left out)
+/// </summary>
+class SymbolTable
+{
+private:
+	std::vector<Symbol> _symbols; //sorted by address, one per address
+	bool _sorted;
+
+	void sort();
+
+public:
+	SymbolTable();
+
+	bool load(const char* path, SYMBOL_FORMATS format = SYMBOLS_AUTO); //adds to what's already loaded, false if the file couldn't be read
+	void add(unsigned short address, const std::string& name); //a second name for an address already in the table is dropped
+	void clear();
+
+	const Symbol* lookup(unsigned short address); //the symbol covering address, nullptr if it's below the first one
+	std::string describe(unsigned short address); //"name", "name+12" inside a routine (offset in hex), or "$0400" with no symbol
+	const std::vector<Symbol>& symbols(); //sorted by address
+	bool empty() const;
+};
+
+/// <summary>
+/// The bytes one source line assembled to, from a debug info file
+/// </summary>
+struct SourceLine {
+	unsigned short address;
+	unsigned short size; //bytes, at least 1
+	unsigned int file; //index into LineTable::files
+	unsigned int line;
+};
+
+/// <summary>
+/// Maps guest addresses back to source lines for coverage reports and the like, read from the "file", "line", "span" and "seg" records of an ld65 --dbgfile.
+/// A line that assembled to bytes in more than one place (a macro used several times, say) has a SourceLine for each, lines inside macro expansions
+/// (type=2) are left out, so what they assembled to is put on the line that used the macro.
+/// </summary>
+class LineTable
+{
+private:
+	std::vector<SourceLine> _lines; //sorted by address
+	std::vector<std::string> _files;
+
+public:
+	bool load(const char* path); //adds to what's already loaded, false if the file couldn't be read or isn't a .dbg file
+	void clear();
+
+	const SourceLine* lookup(unsigned short address) const; //the line whose bytes cover address, nullptr if none do
+	const std::vector<SourceLine>& lines() const; //sorted by address
+	const std::vector<std::string>& files() const;
+	bool empty() const;
+};
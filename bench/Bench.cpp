@@ -0,0 +1,550 @@
+// Bench.cpp : per-opcode and workload microbenchmarks for the Processor class
+//
+// For every opcode the processor decodes to a real instruction, a synthetic program is built that repeats that instruction (with operands
+// pointing at harmless RAM), and the time per instruction is measured over a minimum amount of wall time. A few small hand assembled workloads
+// (tight loops, JSR/RTS, a memory copy, a mix of all of them and a run of stores and arithmetic) are measured the same way.
+// Before anything is timed it is stepped through once to check it runs the instructions it was written to run. One that wanders off its path, stops
+// moving or jams is reported and left out, and the program exits with 2, so a core bug can't pass itself off as a fast instruction.
+// The results can be written as JSON and compared against a stored baseline, any entry that got slower by more than the tolerance is reported
+// and the program exits with 1, so this can gate changes to dispatch, memory and flag handling.
+// With --fusion the workloads are run a second time with superinstruction fusion on (see Processor::enable_fusion), as fused_workload_<name>,
+// followed by the time fusion saved on each one, measured against the same workload run plainly, and the share of its instructions that ran fused.
+//
+// usage: bench [--json <file|->] [--baseline <file>] [--tolerance <percent>] [--min-time <ms>] [--repeat <n>] [--filter <text>] [--fusion <warmup instructions>]
+
+#include "Processor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//names for the INSTRUCTIONS and ADDRESS_MODES enums, in enum order
+static const char* INSTRUCTION_NAMES[] = {
+	"ADC", "AND", "ASL", "BCC", "BCS", "BEQ", "BIT", "BMI", "BNE", "BPL", "BRK", "BVC", "BVS", "CLC", "CLD", "CLI", "CLV", "CMP", "CPX", "CPY", "DEC", "DEX", "DEY", "EOR", "INC", "INX", "INY", "JMP", "JSR", "LDA", "LDX", "LDY", "LSR", "NOP", "ORA", "PHA", "PHP", "PLA", "PLP", "ROL", "ROR", "RTI", "RTS", "SBC", "SEC", "SED", "SEI", "STA", "STX", "STY", "TAX", "TAY", "TSX", "TXA", "TXS", "TYA", "JAM"
+};
+static const char* MODE_NAMES[] = {
+	"ACC", "ABS", "ABX", "ABY", "IMM", "IMP", "IND", "IZX", "IZY", "REL", "ZP", "ZPX", "ZPY", "ERR"
+};
+
+static const unsigned int BLOCK = 256; //instructions per synthetic block, the program counter is put back to the start after each block
+static const unsigned int CHECK_STEPS = 4096; //instructions check_program steps through, a few times round the longest program
+
+/// <summary>
+/// one line of the report
+/// </summary>
+struct BenchResult {
+	std::string name;
+	int opcode; //-1 for workloads
+	double ns_per_instruction;
+	unsigned long long instructions;
+	unsigned long long restarts; //how many times the processor jammed and had to be restarted while measuring
+};
+
+/// <summary>
+/// a workload run with fusion on, next to the same workload run without it
+/// </summary>
+struct FusedResult {
+	std::string name;
+	double plain_ns; //-1 if the plain run was filtered out
+	double fused_ns;
+	FusionStats stats;
+};
+
+struct BenchOptions {
+	const char* json_path = nullptr;
+	const char* baseline_path = nullptr;
+	double tolerance = 10.0; //percent
+	double min_time_ms = 20.0;
+	int repeat = 3;
+	const char* filter = nullptr;
+	long long fusion_warmup = -1; //instructions of warm up before the sequences are picked, -1 leaves fusion off
+};
+
+/// <summary>
+/// number of operand bytes that follow an opcode in each addressing mode
+/// </summary>
+static unsigned int operand_length(ADDRESS_MODES mode) {
+	switch (mode) {
+	case ABSOLUT:
+	case ABSOLUTE_X:
+	case ABSOLUTE_Y:
+	case INDIRECT:
+		return 2;
+	case IMMEDIATE:
+	case INDIRECT_X:
+	case INDIRECT_Y:
+	case RELATIV:
+	case ZEROPAGE:
+	case ZEROPAGE_X:
+	case ZEROPAGE_Y:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/// <summary>
+/// A synthetic program for one opcode, with what it needs besides the code, and the addresses it's meant to run instructions from (see check_program)
+/// </summary>
+struct OpcodeProgram {
+	std::vector<unsigned char> program; //loaded at $0000
+	std::vector<unsigned char> ram; //loaded at $0000 of the RAM, the pointers JMP ($nnnn) goes through
+	unsigned int brk_vector; //what goes in $FFFE/$FFFF, for BRK, 0 leaves it alone
+	std::vector<unsigned short> path;
+};
+
+/// <summary>
+/// Builds a program repeating a single opcode BLOCK times, followed by a JMP back to the start
+/// data accesses go to $0200 (absolute) or $10 (zero page), jumps and subroutine calls go to the next copy, branches have an offset of 0 so they continue either way.
+/// The instructions that can't just be repeated are paired with the one that undoes them, so their timings are of the pair: JMP ($nnnn) goes through a table of pointers
+/// to the next copy, RTS returns from a JSR to the RTS past the closing JMP, and BRK goes through the vector to an RTI there that returns to the next copy (BRK skips the byte after it)
+/// </summary>
+static OpcodeProgram build_opcode_program(Processor& cpu, unsigned char opcode) {
+	OpcodeProgram out;
+	out.brk_vector = 0;
+	std::vector<unsigned char>& program = out.program;
+	INSTRUCTIONS inst = cpu.get_instruction(opcode);
+	ADDRESS_MODES mode = cpu.get_address_mode(opcode);
+	if (inst == RTS || inst == BRK || inst == RTI) {
+		//JSR end / ... / JMP $0000 / end: RTS, or BRK / pad / ... / JMP $0000 / end: RTI, with the vector pointing at the RTI.
+		//the return sits past the JMP so the last copy returns onto the JMP rather than into the RTS/RTI itself
+		const unsigned int copy = (inst == RTS) ? 3 : 2;
+		const unsigned int jump = BLOCK * copy;
+		const unsigned int end = jump + 3;
+		for (unsigned int i = 0; i < BLOCK; i++) {
+			out.path.push_back((unsigned short)program.size());
+			if (inst == RTS) {
+				program.push_back(0x20);
+				program.push_back(end & 0xFF);
+				program.push_back((end >> 8) & 0xFF);
+			}
+			else {
+				program.push_back(0x00);
+				program.push_back(0xEA);
+			}
+		}
+		out.path.push_back((unsigned short)jump);
+		program.push_back(0x4C); //JMP $0000, after the last return
+		program.push_back(0x00);
+		program.push_back(0x00);
+		out.path.push_back((unsigned short)end);
+		program.push_back(inst == RTS ? 0x60 : 0x40);
+		if (inst != RTS) {
+			out.brk_vector = end;
+		}
+		return out;
+	}
+	for (unsigned int i = 0; i < BLOCK; i++) {
+		unsigned int next = (unsigned int)program.size() + 1 + operand_length(mode);
+		out.path.push_back((unsigned short)program.size());
+		program.push_back(opcode);
+		switch (operand_length(mode)) {
+		case 2:
+			if (inst == JMP && mode == INDIRECT) {
+				unsigned int pointer = 0x0300 + i * 2;
+				program.push_back(pointer & 0xFF);
+				program.push_back((pointer >> 8) & 0xFF);
+				out.ram.resize(pointer + 2, 0x00);
+				out.ram[pointer] = next & 0xFF;
+				out.ram[pointer + 1] = (next >> 8) & 0xFF;
+			}
+			else if (inst == JMP || inst == JSR) {
+				program.push_back(next & 0xFF);
+				program.push_back((next >> 8) & 0xFF);
+			}
+			else {
+				program.push_back(0x00);
+				program.push_back(0x02);
+			}
+			break;
+		case 1:
+			if (mode == RELATIV) {
+				program.push_back(0x00);
+			}
+			else if (mode == IMMEDIATE) {
+				program.push_back(0x01);
+			}
+			else {
+				program.push_back(0x10);
+			}
+			break;
+		}
+	}
+	out.path.push_back((unsigned short)program.size());
+	program.push_back(0x4C); //JMP $0000
+	program.push_back(0x00);
+	program.push_back(0x00);
+	return out;
+}
+
+/// <summary>
+/// Steps through the loaded program from $0000 and checks that it really runs the way it was written before it's timed, otherwise a program that has gone
+/// somewhere else (spinning on a BRK in empty memory, say) gets timed all the same, as whatever it ended up on.
+/// It fails if an instruction is fetched from an address that isn't on the path, if an instruction leaves the program counter where it was (a branch or jump
+/// to itself), if the processor jams, or if some address on the path is never reached
+/// </summary>
+/// <param name="path">the address of every instruction the program should run</param>
+/// <returns>false, with the reason on stderr, if the program doesn't run as written</returns>
+static bool check_program(Processor& cpu, const std::string& name, const std::vector<unsigned short>& path) {
+	std::vector<bool> on_path(65536, false);
+	std::vector<bool> reached(65536, false);
+	for (size_t i = 0; i < path.size(); i++) {
+		on_path[path[i]] = true;
+	}
+	cpu.set_pc(0x00, 0x00);
+	for (unsigned int i = 0; i < CHECK_STEPS; i++) {
+		unsigned short pc = (unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low());
+		if (!on_path[pc]) {
+			fprintf(stderr, "bench: %s ran an instruction at $%04X, which isn't on its path\n", name.c_str(), pc);
+			return false;
+		}
+		reached[pc] = true;
+		cpu.step();
+		if (cpu.is_jammed()) {
+			fprintf(stderr, "bench: %s jammed at $%04X\n", name.c_str(), pc);
+			return false;
+		}
+		if (((cpu.get_pc_high() << 8) | cpu.get_pc_low()) == pc) {
+			fprintf(stderr, "bench: %s is stuck at $%04X\n", name.c_str(), pc);
+			return false;
+		}
+	}
+	for (size_t i = 0; i < path.size(); i++) {
+		if (!reached[path[i]]) {
+			fprintf(stderr, "bench: %s never got to $%04X in %u instructions\n", name.c_str(), path[i], CHECK_STEPS);
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Runs the loaded program from $0000 in batches until at least min_time_ms has passed, repeat times, and keeps the fastest run (the least disturbed by the rest of the machine)
+/// if the processor jams, it is restarted at $0000 and the restart is counted, so a jam that check_program didn't catch shows up in the report rather than hanging or skewing the numbers silently
+/// </summary>
+static BenchResult measure(Processor& cpu, const std::string& name, int opcode, unsigned long long batch, const BenchOptions& options) {
+	BenchResult result;
+	result.name = name;
+	result.opcode = opcode;
+	result.ns_per_instruction = 0.0;
+	result.instructions = 0;
+	result.restarts = 0;
+
+	cpu.set_pc(0x00, 0x00);
+	cpu.run(batch); //warm up the caches and branch predictors
+
+	const double min_ns = options.min_time_ms * 1000000.0;
+	for (int r = 0; r < options.repeat; r++) {
+		unsigned long long executed = 0;
+		unsigned long long restarts = 0;
+		double elapsed = 0.0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		do {
+			cpu.set_pc(0x00, 0x00);
+			unsigned long long n = cpu.run(batch);
+			executed += n;
+			if (n < batch) {
+				restarts++;
+			}
+			elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		} while (elapsed < min_ns);
+
+		double per_instruction = executed > 0 ? elapsed / (double)executed : 0.0;
+		if (r == 0 || (executed > 0 && per_instruction < result.ns_per_instruction)) {
+			result.ns_per_instruction = per_instruction;
+			result.instructions = executed;
+			result.restarts = restarts;
+		}
+	}
+	return result;
+}
+
+/// <summary>
+/// The hand assembled workloads, each one loops forever on its own (the JMP at the end), they're all assembled at $0000
+/// </summary>
+struct Workload {
+	const char* name;
+	std::vector<unsigned char> program;
+	std::vector<unsigned short> path; //the address of every instruction, for check_program
+};
+
+static std::vector<Workload> build_workloads() {
+	std::vector<Workload> workloads;
+
+	//LDX #$00 / loop: DEX / BNE loop / JMP $0000
+	workloads.push_back({ "loop", { 0xA2, 0x00, 0xCA, 0xD0, 0xFD, 0x4C, 0x00, 0x00 }, { 0x0000, 0x0002, 0x0003, 0x0005 } });
+
+	//JSR sub / JMP $0000 / sub: RTS
+	workloads.push_back({ "jsr_rts", { 0x20, 0x06, 0x00, 0x4C, 0x00, 0x00, 0x60 }, { 0x0000, 0x0003, 0x0006 } });
+
+	//LDX #$00 / loop: LDA $0300,X / STA $0400,X / INX / BNE loop / JMP $0000
+	workloads.push_back({ "copy", { 0xA2, 0x00, 0xBD, 0x00, 0x03, 0x9D, 0x00, 0x04, 0xE8, 0xD0, 0xF7, 0x4C, 0x00, 0x00 }, { 0x0000, 0x0002, 0x0005, 0x0008, 0x0009, 0x000B } });
+
+	//a bit of everything:
+	//0000 LDX #$00 / 0002 loop: LDA $0300,X / 0005 STA $0400,X / 0008 INX / 0009 CPX #$40 / 000B BNE loop
+	//000D JSR $0020 / 0010 LDY #$10 / 0012 dey: DEY / 0013 BNE dey / 0015 JMP $0000
+	//0020 CLC / 0021 ADC #$01 / 0023 PHA / 0024 PLA / 0025 RTS
+	std::vector<unsigned char> mixed = {
+		0xA2, 0x00, 0xBD, 0x00, 0x03, 0x9D, 0x00, 0x04, 0xE8, 0xE0, 0x40, 0xD0, 0xF5,
+		0x20, 0x20, 0x00, 0xA0, 0x10, 0x88, 0xD0, 0xFD, 0x4C, 0x00, 0x00
+	};
+	mixed.resize(0x20, 0xEA);
+	mixed.insert(mixed.end(), { 0x18, 0x69, 0x01, 0x48, 0x68, 0x60 });
+	workloads.push_back({ "mixed", mixed, { 0x0000, 0x0002, 0x0005, 0x0008, 0x0009, 0x000B, 0x000D, 0x0010, 0x0012, 0x0013, 0x0015, 0x0020, 0x0021, 0x0023, 0x0024, 0x0025 } });
+
+	//stores and arithmetic, the straight line sequences fusion looks for:
+	//LDA #$01 / STA $0400 / LDA $0400 / STA $0401 / SEC / SBC #$01 / CLC / ADC #$02 / JMP $0000
+	workloads.push_back({ "store", { 0xA9, 0x01, 0x8D, 0x00, 0x04, 0xAD, 0x00, 0x04, 0x8D, 0x01, 0x04, 0x38, 0xE9, 0x01, 0x18, 0x69, 0x02, 0x4C, 0x00, 0x00 },
+		{ 0x0000, 0x0002, 0x0005, 0x0008, 0x000B, 0x000C, 0x000E, 0x000F, 0x0011 } });
+
+	return workloads;
+}
+
+/// <summary>
+/// Writes the results in the JSON format read back by load_baseline
+/// </summary>
+static void write_json(std::ostream& out, const std::vector<BenchResult>& results, const BenchOptions& options) {
+	out << "{\n";
+	out << "  \"version\": 1,\n";
+	out << "  \"min_time_ms\": " << options.min_time_ms << ",\n";
+	out << "  \"repeat\": " << options.repeat << ",\n";
+	out << "  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		char opcode[16];
+		if (r.opcode >= 0) {
+			snprintf(opcode, sizeof(opcode), "\"%02X\"", r.opcode);
+		}
+		else {
+			snprintf(opcode, sizeof(opcode), "null");
+		}
+		char ns[32];
+		snprintf(ns, sizeof(ns), "%.3f", r.ns_per_instruction);
+		out << "    { \"name\": \"" << r.name << "\", \"opcode\": " << opcode << ", \"ns_per_instruction\": " << ns
+			<< ", \"instructions\": " << r.instructions << ", \"restarts\": " << r.restarts << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n";
+	out << "}\n";
+}
+
+/// <summary>
+/// Reads a report written by write_json, only the name and ns_per_instruction of each result are needed, so this just scans for those keys rather than parsing the whole thing
+/// </summary>
+static bool load_baseline(const char* path, std::vector<std::pair<std::string, double>>& baseline) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	std::string text = buffer.str();
+
+	const std::string name_key = "\"name\": \"";
+	const std::string ns_key = "\"ns_per_instruction\": ";
+	size_t pos = 0;
+	while ((pos = text.find(name_key, pos)) != std::string::npos) {
+		pos += name_key.size();
+		size_t end = text.find('"', pos);
+		size_t ns = text.find(ns_key, end);
+		if (end == std::string::npos || ns == std::string::npos) {
+			break;
+		}
+		baseline.push_back(std::make_pair(text.substr(pos, end - pos), atof(text.c_str() + ns + ns_key.size())));
+		pos = ns;
+	}
+	return true;
+}
+
+static bool parse_options(int argc, char** argv, BenchOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+		if (value == nullptr) {
+			return false;
+		}
+		if (strcmp(arg, "--json") == 0) {
+			options.json_path = value;
+		}
+		else if (strcmp(arg, "--baseline") == 0) {
+			options.baseline_path = value;
+		}
+		else if (strcmp(arg, "--tolerance") == 0) {
+			options.tolerance = atof(value);
+		}
+		else if (strcmp(arg, "--min-time") == 0) {
+			options.min_time_ms = atof(value);
+		}
+		else if (strcmp(arg, "--repeat") == 0) {
+			options.repeat = atoi(value);
+		}
+		else if (strcmp(arg, "--filter") == 0) {
+			options.filter = value;
+		}
+		else if (strcmp(arg, "--fusion") == 0) {
+			options.fusion_warmup = atoll(value);
+			if (options.fusion_warmup < 0) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+		i++;
+	}
+	return options.repeat > 0 && options.min_time_ms > 0.0 && options.tolerance >= 0.0;
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if (!parse_options(argc, argv, options)) {
+		fprintf(stderr, "usage: bench [--json <file|->] [--baseline <file>] [--tolerance <percent>] [--min-time <ms>] [--repeat <n>] [--filter <text>] [--fusion <warmup instructions>]\n");
+		return 2;
+	}
+
+	Processor cpu(65536, 65536); //full address space for both, so the synthetic operands are always in range
+	std::vector<BenchResult> results;
+	int broken = 0; //programs that didn't run as written (see check_program), they aren't timed
+
+	for (int opcode = 0; opcode < 256; opcode++) {
+		INSTRUCTIONS inst = cpu.get_instruction((unsigned char)opcode);
+		if (inst == JAM) {
+			continue; //illegal opcodes aren't implemented, nothing to measure
+		}
+		std::string name = std::string(INSTRUCTION_NAMES[inst]) + "_" + MODE_NAMES[cpu.get_address_mode((unsigned char)opcode)];
+		if (options.filter != nullptr && name.find(options.filter) == std::string::npos) {
+			continue;
+		}
+		OpcodeProgram program = build_opcode_program(cpu, (unsigned char)opcode);
+		cpu.load_program(program.program.data(), (unsigned int)program.program.size());
+		if (!program.ram.empty()) {
+			cpu.load_ram(program.ram.data(), 0x0000, (unsigned int)program.ram.size());
+		}
+		if (program.brk_vector != 0) {
+			const unsigned char vector[2] = { (unsigned char)(program.brk_vector & 0xFF), (unsigned char)((program.brk_vector >> 8) & 0xFF) };
+			cpu.load_program(vector, 2, 0xFFFE);
+		}
+		if (!check_program(cpu, name, program.path)) {
+			broken++;
+			continue;
+		}
+		results.push_back(measure(cpu, name, opcode, BLOCK, options));
+	}
+
+	std::vector<Workload> workloads = build_workloads();
+	for (size_t i = 0; i < workloads.size(); i++) {
+		std::string name = std::string("workload_") + workloads[i].name;
+		if (options.filter != nullptr && name.find(options.filter) == std::string::npos) {
+			continue;
+		}
+		cpu.load_program(workloads[i].program.data(), (unsigned int)workloads[i].program.size());
+		if (!check_program(cpu, name, workloads[i].path)) {
+			broken++;
+			continue;
+		}
+		results.push_back(measure(cpu, name, -1, 4096, options));
+	}
+
+	//the workloads again with fusion on, the warm up is run through first so the timing is of the fused program only
+	std::vector<FusedResult> fused_results;
+	for (size_t i = 0; options.fusion_warmup >= 0 && i < workloads.size(); i++) {
+		std::string name = std::string("fused_workload_") + workloads[i].name;
+		if (options.filter != nullptr && name.find(options.filter) == std::string::npos) {
+			continue;
+		}
+		cpu.load_program(workloads[i].program.data(), (unsigned int)workloads[i].program.size());
+		if (!check_program(cpu, name, workloads[i].path)) {
+			broken++;
+			continue;
+		}
+		cpu.enable_fusion((unsigned long long)options.fusion_warmup);
+		cpu.set_pc(0x00, 0x00);
+		cpu.run((unsigned long long)options.fusion_warmup);
+		results.push_back(measure(cpu, name, -1, 4096, options));
+		FusedResult fused;
+		fused.name = name;
+		fused.plain_ns = -1.0;
+		for (size_t r = 0; r < results.size(); r++) {
+			if (results[r].name == name.substr(strlen("fused_"))) {
+				fused.plain_ns = results[r].ns_per_instruction;
+			}
+		}
+		fused.fused_ns = results.back().ns_per_instruction;
+		fused.stats = cpu.get_fusion_stats();
+		fused_results.push_back(fused);
+		cpu.disable_fusion();
+	}
+
+	//human readable report, it goes to stderr when the JSON is going to stdout so the two don't get mixed
+	FILE* report = (options.json_path != nullptr && strcmp(options.json_path, "-") == 0) ? stderr : stdout;
+	fprintf(report, "%-16s %6s %12s %14s %9s\n", "name", "opcode", "ns/inst", "instructions", "restarts");
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		char opcode[16] = "-";
+		if (r.opcode >= 0) {
+			snprintf(opcode, sizeof(opcode), "%02X", r.opcode);
+		}
+		fprintf(report, "%-16s %6s %12.3f %14llu %9llu\n", r.name.c_str(), opcode, r.ns_per_instruction, r.instructions, r.restarts);
+	}
+	if (!fused_results.empty()) {
+		//saved is measured, the fused time against the plain one, negative when fusion made the workload slower
+		fprintf(report, "\n%-22s %12s %12s %8s %8s\n", "fused workload", "plain ns", "fused ns", "saved", "fused");
+		for (size_t i = 0; i < fused_results.size(); i++) {
+			const FusedResult& f = fused_results[i];
+			double share = f.stats.instructions > 0 ? 100.0 * (double)f.stats.fused_instructions / (double)f.stats.instructions : 0.0;
+			if (f.plain_ns > 0.0) {
+				fprintf(report, "%-22s %12.3f %12.3f %7.1f%% %7.1f%%\n", f.name.c_str(), f.plain_ns, f.fused_ns, 100.0 * (f.plain_ns - f.fused_ns) / f.plain_ns, share);
+			}
+			else {
+				fprintf(report, "%-22s %12s %12.3f %8s %7.1f%%\n", f.name.c_str(), "-", f.fused_ns, "-", share); //the plain run was filtered out
+			}
+		}
+	}
+
+	if (options.json_path != nullptr) {
+		if (strcmp(options.json_path, "-") == 0) {
+			write_json(std::cout, results, options);
+		}
+		else {
+			std::ofstream out(options.json_path);
+			if (!out.is_open()) {
+				fprintf(stderr, "bench: could not write %s\n", options.json_path);
+				return 2;
+			}
+			write_json(out, results, options);
+		}
+	}
+
+	int regressions = 0;
+	if (options.baseline_path != nullptr) {
+		std::vector<std::pair<std::string, double>> baseline;
+		if (!load_baseline(options.baseline_path, baseline)) {
+			fprintf(stderr, "bench: could not read baseline %s\n", options.baseline_path);
+			return 2;
+		}
+		for (size_t i = 0; i < results.size(); i++) {
+			for (size_t j = 0; j < baseline.size(); j++) {
+				if (baseline[j].first != results[i].name || baseline[j].second <= 0.0) {
+					continue;
+				}
+				double change = (results[i].ns_per_instruction - baseline[j].second) / baseline[j].second * 100.0;
+				if (change > options.tolerance) {
+					fprintf(report, "REGRESSION %-16s %10.3f -> %10.3f ns/inst (%+.1f%%, tolerance %.1f%%)\n", results[i].name.c_str(), baseline[j].second, results[i].ns_per_instruction, change, options.tolerance);
+					regressions++;
+				}
+				break;
+			}
+		}
+		fprintf(report, "%d regression(s) against %s\n", regressions, options.baseline_path);
+	}
+
+	if (broken > 0) {
+		fprintf(report, "%d program(s) didn't run as written and weren't timed, see above\n", broken);
+		return 2;
+	}
+	return regressions > 0 ? 1 : 0;
+}
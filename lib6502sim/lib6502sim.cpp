@@ -0,0 +1,267 @@
+// lib6502sim.cpp : the C interface from lib6502sim.h, a thin layer over Processor
+//
+// The core reports errors by throwing ints, which must never cross a C boundary, so every entry point that calls into the core catches everything
+// and turns it into a result code.
+
+#include "lib6502sim.h"
+#include "Processor.h"
+#include <new>
+#include <vector>
+
+struct sim6502 {
+	Processor* cpu;
+	std::vector<unsigned char> breakpoints; //one bit per address
+	unsigned int breakpoint_count;
+};
+
+struct sim6502_snapshot {
+	ProcessorSnapshot state;
+};
+
+/// <summary>
+/// Maps the core's thrown error codes onto result codes, 5 is a bad address and 6 a snapshot that doesn't fit
+/// </summary>
+static int translate_error(int code) {
+	switch (code) {
+	case 5:
+		return SIM6502_ERROR_RANGE;
+	case 6:
+		return SIM6502_ERROR_MISMATCH;
+	default:
+		return SIM6502_ERROR_INTERNAL;
+	}
+}
+
+static bool is_breakpoint(const sim6502* sim, unsigned short address) {
+	return (sim->breakpoints[address >> 3] >> (address & 7)) & 1;
+}
+
+static sim6502* wrap(Processor* cpu) {
+	sim6502* sim = new (std::nothrow) sim6502;
+	if (sim == nullptr) {
+		delete cpu;
+		return nullptr;
+	}
+	sim->cpu = cpu;
+	sim->breakpoints.assign(65536 / 8, 0);
+	sim->breakpoint_count = 0;
+	return sim;
+}
+
+extern "C" {
+
+int sim6502_abi_version(void) {
+	return SIM6502_ABI_VERSION;
+}
+
+sim6502* sim6502_create(uint32_t memory_size) {
+	try {
+		return wrap(new Processor((unsigned int)memory_size));
+	}
+	catch (...) {
+		return nullptr; //bad size (the Memory constructor throws 4) or out of memory
+	}
+}
+
+sim6502* sim6502_create_split(uint32_t ram_size, uint32_t rom_size) {
+	try {
+		return wrap(new Processor((unsigned int)ram_size, (unsigned int)rom_size));
+	}
+	catch (...) {
+		return nullptr;
+	}
+}
+
+void sim6502_destroy(sim6502* sim) {
+	if (sim != nullptr) {
+		delete sim->cpu;
+		delete sim;
+	}
+}
+
+uint32_t sim6502_memory_size(sim6502* sim, int space) {
+	if (sim == nullptr) {
+		return 0;
+	}
+	return space == SIM6502_ROM ? sim->cpu->get_rom_size() : sim->cpu->get_ram_size();
+}
+
+int sim6502_load(sim6502* sim, int space, uint32_t address, const uint8_t* data, uint32_t size) {
+	if (sim == nullptr || (data == nullptr && size > 0) || (space != SIM6502_RAM && space != SIM6502_ROM)) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	try {
+		if (space == SIM6502_RAM) {
+			sim->cpu->load_ram(data, address, size);
+		}
+		else {
+			sim->cpu->load_rom(data, address, size);
+		}
+	}
+	catch (int code) {
+		return translate_error(code);
+	}
+	catch (...) {
+		return SIM6502_ERROR_INTERNAL;
+	}
+	return SIM6502_OK;
+}
+
+int sim6502_peek(sim6502* sim, int space, uint32_t address, uint8_t* out, uint32_t size) {
+	if (sim == nullptr || (out == nullptr && size > 0) || (space != SIM6502_RAM && space != SIM6502_ROM)) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	try {
+		if (space == SIM6502_RAM) {
+			sim->cpu->copy_ram(out, address, size);
+		}
+		else {
+			sim->cpu->copy_rom(out, address, size);
+		}
+	}
+	catch (int code) {
+		return translate_error(code);
+	}
+	catch (...) {
+		return SIM6502_ERROR_INTERNAL;
+	}
+	return SIM6502_OK;
+}
+
+int sim6502_get_registers(sim6502* sim, sim6502_registers* registers) {
+	if (sim == nullptr || registers == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	Processor* cpu = sim->cpu;
+	const CpuState& state = cpu->get_cpu_state(); //everything but the status comes straight out of the one block
+	registers->pc = state.pc;
+	registers->a = state.a;
+	registers->x = state.x;
+	registers->y = state.y;
+	registers->sp = state.sp;
+	registers->status = cpu->get_status(); //the core stores the flags in its own bit order
+	registers->jammed = state.state == JAMMED ? 1 : 0;
+	registers->cycles = state.cycles;
+	return SIM6502_OK;
+}
+
+int sim6502_set_registers(sim6502* sim, const sim6502_registers* registers) {
+	if (sim == nullptr || registers == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	sim->cpu->set_registers(registers->a, registers->x, registers->y, registers->sp);
+	sim->cpu->set_status(registers->status);
+	sim->cpu->set_pc((registers->pc >> 8) & 0xFF, registers->pc & 0xFF);
+	return SIM6502_OK;
+}
+
+/// <summary>
+/// Without breakpoints the whole run is a single Processor::run call, with breakpoints the program counter is checked before every instruction
+/// except the first, so a run started on a breakpoint gets past it
+/// </summary>
+int sim6502_run(sim6502* sim, uint64_t max_instructions, sim6502_run_result* result) {
+	if (sim == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	Processor* cpu = sim->cpu;
+	unsigned long long start_cycles = cpu->get_cycles();
+	unsigned long long executed = 0;
+	int stop_reason = SIM6502_STOP_COUNT;
+	try {
+		if (sim->breakpoint_count == 0) {
+			executed = cpu->run(max_instructions);
+		}
+		else {
+			while (executed < max_instructions) {
+				if (executed > 0 && is_breakpoint(sim, (unsigned short)((cpu->get_pc_high() << 8) | cpu->get_pc_low()))) {
+					stop_reason = SIM6502_STOP_BREAKPOINT;
+					break;
+				}
+				if (cpu->run(1) == 0) {
+					break;
+				}
+				executed++;
+			}
+		}
+	}
+	catch (int code) {
+		return translate_error(code);
+	}
+	catch (...) {
+		return SIM6502_ERROR_INTERNAL;
+	}
+	if (stop_reason == SIM6502_STOP_COUNT && cpu->is_jammed()) {
+		stop_reason = SIM6502_STOP_JAMMED;
+	}
+	if (result != nullptr) {
+		result->instructions = executed;
+		result->cycles = cpu->get_cycles() - start_cycles;
+		result->stop_reason = stop_reason;
+	}
+	return SIM6502_OK;
+}
+
+int sim6502_set_breakpoint(sim6502* sim, uint16_t address, int enabled) {
+	if (sim == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	bool was_set = is_breakpoint(sim, address);
+	if (enabled && !was_set) {
+		sim->breakpoints[address >> 3] |= (unsigned char)(1 << (address & 7));
+		sim->breakpoint_count++;
+	}
+	else if (!enabled && was_set) {
+		sim->breakpoints[address >> 3] &= (unsigned char)~(1 << (address & 7));
+		sim->breakpoint_count--;
+	}
+	return SIM6502_OK;
+}
+
+int sim6502_clear_breakpoints(sim6502* sim) {
+	if (sim == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	sim->breakpoints.assign(sim->breakpoints.size(), 0);
+	sim->breakpoint_count = 0;
+	return SIM6502_OK;
+}
+
+sim6502_snapshot* sim6502_snapshot_save(sim6502* sim) {
+	if (sim == nullptr) {
+		return nullptr;
+	}
+	sim6502_snapshot* snapshot = new (std::nothrow) sim6502_snapshot;
+	if (snapshot == nullptr) {
+		return nullptr;
+	}
+	try {
+		sim->cpu->save_snapshot(snapshot->state);
+	}
+	catch (...) {
+		delete snapshot;
+		return nullptr;
+	}
+	return snapshot;
+}
+
+int sim6502_snapshot_restore(sim6502* sim, const sim6502_snapshot* snapshot) {
+	if (sim == nullptr || snapshot == nullptr) {
+		return SIM6502_ERROR_ARGUMENT;
+	}
+	try {
+		sim->cpu->load_snapshot(snapshot->state);
+	}
+	catch (int code) {
+		return translate_error(code);
+	}
+	catch (...) {
+		return SIM6502_ERROR_INTERNAL;
+	}
+	return SIM6502_OK;
+}
+
+void sim6502_snapshot_free(sim6502_snapshot* snapshot) {
+	delete snapshot;
+}
+
+}
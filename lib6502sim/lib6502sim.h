@@ -0,0 +1,102 @@
+/*
+ * lib6502sim.h : C interface to the 6502 core, for embedding it in other processes and language runtimes (ctypes, cffi, P/Invoke and so on)
+ *
+ * Everything goes through an opaque handle, nothing C++ crosses the boundary, and the calls work on whole blocks (load and peek ranges of memory,
+ * all registers in one struct, runs of many instructions) so the cost of a call across the boundary is spread over a lot of work.
+ * A handle is not thread safe, but separate handles can be used from separate threads.
+ * Functions that can fail return one of the SIM6502_RESULT codes, SIM6502_OK (0) on success.
+ *
+ * Windows: built as a DLL by lib6502sim.vcxproj.
+ * Linux: g++ -O2 -shared -fPIC -I6502Sim lib6502sim/lib6502sim.cpp 6502Sim/Processor.cpp 6502Sim/Memory.cpp 6502Sim/AluTables.cpp 6502Sim/BankController.cpp -o lib6502sim.so
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifdef LIB6502SIM_EXPORTS
+#define SIM6502_API __declspec(dllexport)
+#else
+#define SIM6502_API __declspec(dllimport)
+#endif
+#else
+#define SIM6502_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM6502_ABI_VERSION 1 /* bumped whenever a struct or signature below changes */
+
+typedef struct sim6502 sim6502;
+typedef struct sim6502_snapshot sim6502_snapshot;
+
+/* Result codes */
+enum SIM6502_RESULT {
+	SIM6502_OK = 0,
+	SIM6502_ERROR_ARGUMENT = -1, /* null handle or pointer, unknown memory space */
+	SIM6502_ERROR_RANGE = -2, /* address range runs past the end of the memory */
+	SIM6502_ERROR_MISMATCH = -3, /* snapshot taken from a processor with different memory sizes */
+	SIM6502_ERROR_INTERNAL = -4 /* the core threw something unexpected */
+};
+
+/* Memory spaces, the core fetches code from the ROM and data from the RAM, which are the same memory for a handle made with sim6502_create */
+enum SIM6502_SPACE {
+	SIM6502_RAM = 0,
+	SIM6502_ROM = 1
+};
+
+/* Why a run stopped */
+enum SIM6502_STOP_REASON {
+	SIM6502_STOP_COUNT = 0, /* ran the number of instructions asked for */
+	SIM6502_STOP_JAMMED = 1, /* the processor hit an opcode it can't execute */
+	SIM6502_STOP_BREAKPOINT = 2 /* the program counter reached a breakpoint (the instruction there has not run yet) */
+};
+
+typedef struct sim6502_registers {
+	uint16_t pc;
+	uint8_t a;
+	uint8_t x;
+	uint8_t y;
+	uint8_t sp;
+	uint8_t status; /* real 6502 bit order, N V - B D I Z C */
+	uint8_t jammed; /* read only, ignored by sim6502_set_registers */
+	uint64_t cycles; /* read only, base cycles run since the handle was created */
+} sim6502_registers;
+
+typedef struct sim6502_run_result {
+	uint64_t instructions; /* instructions executed by this run */
+	uint64_t cycles; /* base cycles used by this run */
+	int32_t stop_reason; /* SIM6502_STOP_REASON */
+} sim6502_run_result;
+
+SIM6502_API int sim6502_abi_version(void);
+
+/* create a processor with one memory block shared by code and data, size between 2048 and 65536 bytes, returns NULL on a bad size */
+SIM6502_API sim6502* sim6502_create(uint32_t memory_size);
+/* create a processor with separate RAM and ROM */
+SIM6502_API sim6502* sim6502_create_split(uint32_t ram_size, uint32_t rom_size);
+SIM6502_API void sim6502_destroy(sim6502* sim);
+SIM6502_API uint32_t sim6502_memory_size(sim6502* sim, int space);
+
+/* bulk memory access, mapped I/O devices are bypassed */
+SIM6502_API int sim6502_load(sim6502* sim, int space, uint32_t address, const uint8_t* data, uint32_t size);
+SIM6502_API int sim6502_peek(sim6502* sim, int space, uint32_t address, uint8_t* out, uint32_t size);
+
+SIM6502_API int sim6502_get_registers(sim6502* sim, sim6502_registers* registers);
+SIM6502_API int sim6502_set_registers(sim6502* sim, const sim6502_registers* registers); /* also clears a jam, like setting the program counter does */
+
+/* runs up to max_instructions, stopping early on a jam or a breakpoint, result may be NULL */
+SIM6502_API int sim6502_run(sim6502* sim, uint64_t max_instructions, sim6502_run_result* result);
+SIM6502_API int sim6502_set_breakpoint(sim6502* sim, uint16_t address, int enabled);
+SIM6502_API int sim6502_clear_breakpoints(sim6502* sim);
+
+/* snapshots hold the registers and all of the memory, restoring one needs a processor with the same memory sizes */
+SIM6502_API sim6502_snapshot* sim6502_snapshot_save(sim6502* sim);
+SIM6502_API int sim6502_snapshot_restore(sim6502* sim, const sim6502_snapshot* snapshot);
+SIM6502_API void sim6502_snapshot_free(sim6502_snapshot* snapshot);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,114 @@
+// CovMerge.cpp : merges coverage maps from test runs and turns them into reports
+//
+// Every map given is ORed into one (romrunner --coverage writes them, one per CI job, or per shard of a suite list run in parallel), which can be saved
+// back out with -o, and written as an lcov tracefile with --lcov for genhtml or a CI coverage viewer. lcov needs source lines, so it also needs the ld65
+// --dbgfile of the program (--debug, repeatable for programs linked in pieces). With --image the program's binary is read too, so branches that never ran
+// still show up as branches.
+//
+// usage: covmerge [-o <file>] [--lcov <file>] [--debug <file>]... [--image <path>[:<load>]] [--test <name>] <coverage file>...
+//   load is in hex and defaults to 0000
+
+#include "Coverage.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+	const char* output_path = nullptr;
+	const char* lcov_path = nullptr;
+	const char* test_name = nullptr;
+	std::vector<const char*> debug_files;
+	std::string image_spec;
+	std::vector<const char*> inputs;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--lcov") == 0 && i + 1 < argc) {
+			lcov_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--debug") == 0 && i + 1 < argc) {
+			debug_files.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc) {
+			image_spec = argv[++i];
+		}
+		else if (strcmp(argv[i], "--test") == 0 && i + 1 < argc) {
+			test_name = argv[++i];
+		}
+		else if (argv[i][0] == '-') {
+			inputs.clear();
+			break;
+		}
+		else {
+			inputs.push_back(argv[i]);
+		}
+	}
+	if (inputs.empty() || (lcov_path != nullptr && debug_files.empty())) {
+		fprintf(stderr, "usage: covmerge [-o <file>] [--lcov <file>] [--debug <file>]... [--image <path>[:<load>]] [--test <name>] <coverage file>...\n");
+		return 2;
+	}
+
+	CoverageMap merged;
+	CoverageMap input;
+	for (size_t i = 0; i < inputs.size(); i++) {
+		if (!input.load(inputs[i])) {
+			fprintf(stderr, "covmerge: %s is not a coverage file\n", inputs[i]);
+			return 1;
+		}
+		merged.merge(input);
+	}
+	printf("%u instruction addresses executed in %d run%s\n", merged.count_executed(), (int)inputs.size(), inputs.size() == 1 ? "" : "s");
+
+	if (output_path != nullptr && !merged.save(output_path)) {
+		fprintf(stderr, "covmerge: could not write %s\n", output_path);
+		return 1;
+	}
+
+	if (lcov_path != nullptr) {
+		LineTable lines;
+		for (size_t i = 0; i < debug_files.size(); i++) {
+			if (!lines.load(debug_files[i])) {
+				fprintf(stderr, "covmerge: %s is not an ld65 debug file\n", debug_files[i]);
+				return 1;
+			}
+		}
+
+		std::vector<unsigned char> memory;
+		if (!image_spec.empty()) {
+			//path[:load], the load field is only taken if it's hex, so a drive letter stays part of the path
+			unsigned short load = 0x0000;
+			size_t colon = image_spec.rfind(':');
+			if (colon != std::string::npos) {
+				std::string field = image_spec.substr(colon + 1);
+				if (!field.empty() && field.size() <= 4 && field.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos) {
+					load = (unsigned short)strtoul(field.c_str(), nullptr, 16);
+					image_spec = image_spec.substr(0, colon);
+				}
+			}
+			std::ifstream file(image_spec, std::ios::binary);
+			if (!file.is_open()) {
+				fprintf(stderr, "covmerge: could not read %s\n", image_spec.c_str());
+				return 1;
+			}
+			std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			memory.assign(65536, 0);
+			for (size_t i = 0; i < image.size() && load + i < memory.size(); i++) {
+				memory[load + i] = image[i];
+			}
+		}
+
+		FILE* lcov = fopen(lcov_path, "w");
+		if (lcov == nullptr) {
+			fprintf(stderr, "covmerge: could not write %s\n", lcov_path);
+			return 1;
+		}
+		merged.write_lcov(lcov, lines, memory.empty() ? nullptr : memory.data(), test_name);
+		fclose(lcov);
+	}
+	return 0;
+}
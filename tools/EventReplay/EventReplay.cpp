@@ -0,0 +1,163 @@
+// EventReplay.cpp : records the input of a run and replays it bit for bit
+//
+// record: loads an image into a unified 64K Processor with an ACIA at --acia, attached to the input file (or stdin) and the output file (or stdout), and runs it,
+// with the ACIA behind a RecordingDevice, so every register read the guest makes is logged with its cycle count. The host thread feeds the ACIA at whatever
+// pace the input comes in, which is the timing a failure can depend on.
+// replay: runs the same image with a ReplayDevice in the ACIA's place, answering the guest's reads from the log, flat out, output still goes to the output file or stdout.
+// Both print the instruction and cycle counts and a hash of the final state (registers and memory), a replay with the same --max that ends on the same hash
+// went exactly the way the recording did. A replay that strays from the log says at which cycle.
+//
+// usage: eventreplay record|replay <log> [--acia <page>] [--max <instructions>] [--input <file>] [--output <file>] <image>[:<load>[:<start>]]
+//   page in hex, default D0, load and start in hex, default 0000 and 0400, --input is only for recording
+
+#include "Processor.h"
+#include "Acia.h"
+#include "EventLog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const unsigned long long BATCH = 100000; //instructions per run call, between checks for a jam
+
+/// <summary>
+/// FNV-1a over everything in the snapshot, registers first, as Lockstep hashes it
+/// </summary>
+static unsigned long long hash_state(Processor& cpu) {
+	ProcessorSnapshot snapshot;
+	cpu.save_snapshot(snapshot);
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned char registers[8] = { snapshot.pc_high, snapshot.pc_low, snapshot.a, snapshot.x, snapshot.y, snapshot.sp, snapshot.status, (unsigned char)(snapshot.jammed ? 1 : 0) };
+	for (size_t i = 0; i < sizeof(registers); i++) {
+		hash = (hash ^ registers[i]) * 1099511628211ULL;
+	}
+	for (size_t i = 0; i < snapshot.ram.size(); i++) {
+		hash = (hash ^ snapshot.ram[i]) * 1099511628211ULL;
+	}
+	for (size_t i = 0; i < snapshot.rom.size(); i++) {
+		hash = (hash ^ snapshot.rom[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+static unsigned long long run(Processor& cpu, unsigned long long max_instructions) {
+	unsigned long long instructions = 0;
+	while (instructions < max_instructions && !cpu.is_jammed()) {
+		instructions += cpu.run(max_instructions - instructions < BATCH ? max_instructions - instructions : BATCH);
+	}
+	return instructions;
+}
+
+int main(int argc, char** argv) {
+	unsigned char page = 0xD0;
+	unsigned long long max_instructions = 100000000ULL;
+	const char* input_path = nullptr;
+	const char* output_path = nullptr;
+	std::string spec;
+
+	bool recording = argc > 1 && strcmp(argv[1], "record") == 0;
+	bool replaying = argc > 1 && strcmp(argv[1], "replay") == 0;
+	const char* log_path = argc > 2 ? argv[2] : nullptr;
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "--acia") == 0 && i + 1 < argc) {
+			page = (unsigned char)strtoul(argv[++i], nullptr, 16);
+		}
+		else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			max_instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+			input_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			output_path = argv[++i];
+		}
+		else if (argv[i][0] != '-' && spec.empty()) {
+			spec = argv[i];
+		}
+		else {
+			spec.clear();
+			break;
+		}
+	}
+	if ((!recording && !replaying) || log_path == nullptr || spec.empty()) {
+		fprintf(stderr, "usage: eventreplay record|replay <log> [--acia <page>] [--max <instructions>] [--input <file>] [--output <file>] <image>[:<load>[:<start>]]\n");
+		return 2;
+	}
+
+	//image[:load[:start]], fields taken from the right so a drive letter in the path stays put
+	unsigned short addresses[2] = { 0x0000, 0x0400 };
+	std::vector<std::string> fields;
+	while (fields.size() < 2) {
+		size_t colon = spec.rfind(':');
+		if (colon == std::string::npos) {
+			break;
+		}
+		std::string field = spec.substr(colon + 1);
+		if (field.empty() || field.size() > 4 || field.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+			break;
+		}
+		fields.insert(fields.begin(), field);
+		spec = spec.substr(0, colon);
+	}
+	for (size_t i = 0; i < fields.size(); i++) {
+		addresses[i] = (unsigned short)strtoul(fields[i].c_str(), nullptr, 16);
+	}
+
+	std::ifstream file(spec, std::ios::binary);
+	if (!file.is_open()) {
+		fprintf(stderr, "eventreplay: could not read %s\n", spec.c_str());
+		return 1;
+	}
+	std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	Processor cpu((unsigned int)65536);
+	cpu.load_program(image.data(), (unsigned int)image.size(), addresses[0]);
+	cpu.set_pc((addresses[1] >> 8) & 0xFF, addresses[1] & 0xFF);
+
+	EventLog log;
+	Acia acia;
+	unsigned long long instructions = 0;
+	if (recording) {
+		if (!log.create(log_path)) {
+			fprintf(stderr, "eventreplay: could not write %s\n", log_path);
+			return 1;
+		}
+		bool attached = (input_path != nullptr || output_path != nullptr) ? acia.attach_files(input_path, output_path) : acia.attach(0, 1);
+		if (!attached) {
+			fprintf(stderr, "eventreplay: could not attach the ACIA\n");
+			return 1;
+		}
+		RecordingDevice<Processor> recorder(cpu, log, page, &acia);
+		cpu.map_device(page, &recorder);
+		instructions = run(cpu, max_instructions);
+		cpu.unmap_device(page);
+		acia.detach();
+		log.close();
+		fprintf(stderr, "recorded %llu events\n", log.get_events());
+	}
+	else {
+		if (!log.open(log_path)) {
+			fprintf(stderr, "eventreplay: %s is not an event log\n", log_path);
+			return 1;
+		}
+		bool attached = output_path != nullptr ? acia.attach_files(nullptr, output_path) : acia.attach(-1, 1);
+		if (!attached) {
+			fprintf(stderr, "eventreplay: could not attach the ACIA\n");
+			return 1;
+		}
+		ReplayDevice<Processor> replayer(cpu, log, page, &acia);
+		cpu.map_device(page, &replayer);
+		instructions = run(cpu, max_instructions);
+		cpu.unmap_device(page);
+		acia.detach();
+		InputEvent left;
+		fprintf(stderr, "replayed %llu events%s\n", log.get_events(), log.peek(left) ? ", the run ended before the log did" : "");
+		if (replayer.has_diverged()) {
+			fprintf(stderr, "the replay left the log at cycle %llu\n", replayer.get_divergence());
+		}
+	}
+	fprintf(stderr, "%llu instructions, %llu cycles%s, state hash %016llx\n", instructions, cpu.get_cycles(), cpu.is_jammed() ? ", jammed" : "", hash_state(cpu));
+	return 0;
+}
@@ -0,0 +1,161 @@
+// GuestProf.cpp : sampling profiler for guest programs, shows which routines of a 6502 program the cycles go to
+//
+// Loads an image into a unified 64K processor built with SamplingHooks, runs it, and prints a flat profile by routine. Samples are taken every
+// --interval guest cycles (the default), or off a host timer with --timer, which shows where host time goes instead (mostly the same thing, unless
+// I/O devices are slow, and on Linux the timer can't fire faster than the kernel tick). With --folded the samples are also written out as folded stacks for flamegraph.pl, speedscope and the like.
+// A call graph profiler runs alongside the sampler and counts every cycle exactly: --calls prints routines by inclusive and exclusive cycles, --callgrind writes
+// the call graph for KCachegrind or QCachegrind.
+//
+// usage: guestprof [--symbols <file>]... [--interval <cycles>] [--timer <microseconds>] [--max <instructions>] [--folded <file>] [--no-stacks] [--calls] [--callgrind <file>] <image>[:<load>[:<start>]]
+//   symbol files can be ld65 .dbg files, VICE label files or plain "address name" lists, addresses in hex, load and start default to 0000 and 0400
+
+#include "ProcessorImpl.h"
+#include "SampleProfiler.h"
+#include "CallGraph.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+typedef HookPair<SamplingHooks, CallGraphHooks> ProfilerHooks;
+template class BasicProcessor<ProfilerHooks>;
+
+static const unsigned long long BATCH = 100000; //instructions per run call, between checks for a jam
+
+int main(int argc, char** argv) {
+	std::vector<const char*> symbol_files;
+	unsigned long long interval = 1000;
+	unsigned int timer_us = 0;
+	unsigned long long max_instructions = 100000000ULL;
+	const char* folded_path = nullptr;
+	const char* callgrind_path = nullptr;
+	bool stacks = true;
+	bool calls = false;
+	std::string spec;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+			symbol_files.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+			interval = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--timer") == 0 && i + 1 < argc) {
+			timer_us = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			interval = 0;
+		}
+		else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			max_instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--folded") == 0 && i + 1 < argc) {
+			folded_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--no-stacks") == 0) {
+			stacks = false;
+		}
+		else if (strcmp(argv[i], "--calls") == 0) {
+			calls = true;
+		}
+		else if (strcmp(argv[i], "--callgrind") == 0 && i + 1 < argc) {
+			callgrind_path = argv[++i];
+		}
+		else if (argv[i][0] != '-' && spec.empty()) {
+			spec = argv[i];
+		}
+		else {
+			spec.clear();
+			break;
+		}
+	}
+	if (spec.empty() || (interval == 0 && timer_us == 0)) {
+		fprintf(stderr, "usage: guestprof [--symbols <file>]... [--interval <cycles>] [--timer <microseconds>] [--max <instructions>] [--folded <file>] [--no-stacks] [--calls] [--callgrind <file>] <image>[:<load>[:<start>]]\n");
+		return 2;
+	}
+
+	//image[:load[:start]], fields taken from the right so a drive letter in the path stays put
+	unsigned short addresses[2] = { 0x0000, 0x0400 };
+	std::vector<std::string> fields;
+	while (fields.size() < 2) {
+		size_t colon = spec.rfind(':');
+		if (colon == std::string::npos) {
+			break;
+		}
+		std::string field = spec.substr(colon + 1);
+		if (field.empty() || field.size() > 4 || field.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+			break;
+		}
+		fields.insert(fields.begin(), field);
+		spec = spec.substr(0, colon);
+	}
+	for (size_t i = 0; i < fields.size(); i++) {
+		addresses[i] = (unsigned short)strtoul(fields[i].c_str(), nullptr, 16);
+	}
+
+	std::ifstream file(spec, std::ios::binary);
+	if (!file.is_open()) {
+		fprintf(stderr, "guestprof: could not read %s\n", spec.c_str());
+		return 1;
+	}
+	std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	SymbolTable symbols;
+	for (size_t i = 0; i < symbol_files.size(); i++) {
+		if (!symbols.load(symbol_files[i])) {
+			fprintf(stderr, "guestprof: could not read %s\n", symbol_files[i]);
+			return 1;
+		}
+	}
+
+	BasicProcessor<ProfilerHooks> cpu((unsigned int)65536);
+	cpu.load_program(image.data(), (unsigned int)image.size(), addresses[0]);
+	cpu.set_pc((addresses[1] >> 8) & 0xFF, addresses[1] & 0xFF);
+	SamplingHooks& profiler = cpu.get_hooks().first;
+	CallGraphHooks& call_graph = cpu.get_hooks().second;
+	profiler.set_interval(interval);
+	profiler.set_stacks(stacks);
+	if (timer_us > 0 && !SampleTimer::start(timer_us)) {
+		fprintf(stderr, "guestprof: could not start the sample timer\n");
+		return 1;
+	}
+
+	unsigned long long instructions = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (instructions < max_instructions && !cpu.is_jammed()) {
+		instructions += cpu.run(max_instructions - instructions < BATCH ? max_instructions - instructions : BATCH);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	SampleTimer::stop();
+
+	fprintf(stdout, "%llu instructions, %llu cycles, %.3f s, %llu samples%s\n\n", instructions, cpu.get_cycles(), seconds, profiler.get_samples(),
+		cpu.is_jammed() ? ", stopped on a jam" : "");
+	if (profiler.get_samples() > 0) {
+		profiler.write_flat(stdout, symbols);
+	}
+	if (calls) {
+		fprintf(stdout, "\n");
+		call_graph.write_report(stdout, symbols);
+	}
+	if (folded_path != nullptr) {
+		FILE* folded = fopen(folded_path, "w");
+		if (folded == nullptr) {
+			fprintf(stderr, "guestprof: could not write %s\n", folded_path);
+			return 1;
+		}
+		profiler.write_folded(folded, symbols);
+		fclose(folded);
+	}
+	if (callgrind_path != nullptr) {
+		FILE* callgrind = fopen(callgrind_path, "w");
+		if (callgrind == nullptr) {
+			fprintf(stderr, "guestprof: could not write %s\n", callgrind_path);
+			return 1;
+		}
+		std::string command = "guestprof " + spec;
+		call_graph.write_callgrind(callgrind, symbols, command.c_str());
+		fclose(callgrind);
+	}
+	return 0;
+}
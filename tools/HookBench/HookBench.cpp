@@ -0,0 +1,215 @@
+// HookBench.cpp : measures what each hooks policy costs (see ProcessorHooks.h)
+//
+// Runs the same loop of loads, stores and jumps on a processor built with each stock policy and reports the best of several runs in MIPS,
+// along with the speed relative to NullHooks. NullHooks should come out the same as a core without hooks at all, since every hook in it is an empty inline function,
+// to check that, the same loop is also timed on BareLoop, a plain (non-templated) copy of the processor's run loop and of the six instructions the loop uses,
+// with no hook calls in it at all, and every policy's time is reported against it. BareLoop only knows those six instructions, so NullHooks also pays for
+// the rest of the core's dispatch (the full instruction switch) on top of it, which has been 15-40% of the bare time here, a hook that didn't inline
+// away shows up as NullHooks moving from there towards CountingHooks.
+// TraceHooks is run with its output off, so what it measures is the cost of the hook calls themselves rather than of printing.
+//
+// usage: hookbench [--instructions <count>] [--repeat <runs>]
+
+#include "Processor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//INX, TXA, STA $0300, LDA $0300, STA $1234, JMP $0400
+static const unsigned char BENCH_PROGRAM[] = { 0xE8, 0x8A, 0x8D, 0x00, 0x03, 0xAD, 0x00, 0x03, 0x8D, 0x34, 0x12, 0x4C, 0x00, 0x04 };
+
+/// <summary>
+/// The hook-free baseline: BasicProcessor's run loop, fetch, decode and the bodies of INX, TXA, STA abs, LDA abs and JMP abs copied out as they are in ProcessorImpl.h,
+/// on the same Memory and CpuState, with the hook calls left out. Anything else jams it.
+/// </summary>
+class BareLoop {
+private:
+	CpuState regs;
+	Memory memory;
+	unsigned char opcode = 0x00;
+	INSTRUCTIONS inst = JAM;
+	ADDRESS_MODES addr_mode = ERR;
+
+	void set_nz_flags(unsigned char value) {
+		regs.flags.n_flag = (value & 0x80) ? 0b1 : 0b0;
+		regs.flags.z_flag = (value == 0x00) ? 0b1 : 0b0;
+	}
+	void fetch() {
+		if (regs.state == FETCH) {
+			opcode = memory.read(regs.pc_high, regs.pc_low);
+			regs.state = DECODE;
+		}
+	}
+	void decode() {
+		if (regs.state == DECODE) {
+			inst = INSTRUCTION_TABLE[opcode >> 4][opcode & 0x0F];
+			addr_mode = ADDRESS_MODE_TABLE[opcode >> 4][opcode & 0x0F];
+			regs.cycles += CYCLE_TABLE[opcode >> 4][opcode & 0x0F];
+			regs.state = EXECUTE;
+		}
+	}
+	void execute() {
+		if (regs.state != EXECUTE) {
+			return;
+		}
+		if (addr_mode != IMPLIED && addr_mode != ABSOLUT) {
+			regs.state = JAMMED;
+			return;
+		}
+		switch (inst) {
+		case INX:
+			regs.x++;
+			set_nz_flags(regs.x);
+			regs.pc++;
+			break;
+		case TXA:
+			regs.a = regs.x;
+			set_nz_flags(regs.a);
+			regs.pc++;
+			break;
+		case LDA:
+		case STA: {
+			regs.pc++;
+			unsigned char addr_low = memory.read(regs.pc_high, regs.pc_low);
+			regs.pc++;
+			unsigned char addr_high = memory.read(regs.pc_high, regs.pc_low);
+			unsigned char operand = memory.read(addr_high, addr_low); //STA reads its target first in the core too
+			regs.pc++;
+			if (inst == LDA) {
+				regs.a = operand;
+				set_nz_flags(regs.a);
+			}
+			else {
+				memory.write(addr_high, addr_low, regs.a);
+			}
+		}
+			break;
+		case JMP: {
+			regs.pc++;
+			unsigned char addr_low = memory.read(regs.pc_high, regs.pc_low);
+			regs.pc++;
+			regs.pc = (unsigned short)(addr_low | (memory.read(regs.pc_high, regs.pc_low) << 8));
+		}
+			break;
+		default:
+			regs.state = JAMMED;
+			return;
+		}
+		regs.state = FETCH;
+	}
+
+public:
+	BareLoop() : memory(65536) {
+		memset(&regs, 0, sizeof(regs));
+		regs.sp = 0xFF;
+		regs.state = FETCH;
+	}
+	void load_program(const unsigned char* program, unsigned int size, unsigned short start) {
+		memory.copy_in(program, start, size);
+		regs.pc = start;
+	}
+	unsigned long long run(unsigned long long count) {
+		unsigned long long executed = 0;
+		while (executed < count && regs.state == FETCH) {
+			fetch();
+			decode();
+			execute();
+			executed++;
+		}
+		return executed;
+	}
+};
+
+/// <summary>
+/// Wall time of one run of instructions instructions, exits if the processor stops short
+/// </summary>
+template <typename Cpu>
+static double time_run(Cpu& cpu, unsigned long long instructions) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long long executed = cpu.run(instructions);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (executed != instructions) {
+		fprintf(stderr, "hookbench: the processor stopped after %llu instructions\n", executed);
+		exit(1);
+	}
+	return seconds;
+}
+
+/// <summary>
+/// Best wall time of repeat runs of instructions instructions on a fresh processor with the given policy
+/// </summary>
+template <typename Hooks>
+static double bench(unsigned long long instructions, int repeat) {
+	double best = 0.0;
+	for (int run = 0; run < repeat; run++) {
+		BasicProcessor<Hooks> cpu((unsigned int)65536);
+		cpu.load_program(BENCH_PROGRAM, sizeof(BENCH_PROGRAM), 0x0400);
+		cpu.set_pc(0x04, 0x00);
+		double seconds = time_run(cpu, instructions);
+		if (run == 0 || seconds < best) {
+			best = seconds;
+		}
+	}
+	return best;
+}
+
+/// <summary>
+/// The same for BareLoop
+/// </summary>
+static double bench_bare(unsigned long long instructions, int repeat) {
+	double best = 0.0;
+	for (int run = 0; run < repeat; run++) {
+		BareLoop cpu;
+		cpu.load_program(BENCH_PROGRAM, sizeof(BENCH_PROGRAM), 0x0400);
+		double seconds = time_run(cpu, instructions);
+		if (run == 0 || seconds < best) {
+			best = seconds;
+		}
+	}
+	return best;
+}
+
+
+int main(int argc, char** argv) {
+	unsigned long long instructions = 50000000ULL;
+	int repeat = 5;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--instructions") == 0 && i + 1 < argc) {
+			instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+			repeat = atoi(argv[++i]);
+		}
+		else {
+			fprintf(stderr, "usage: hookbench [--instructions <count>] [--repeat <runs>]\n");
+			return 2;
+		}
+	}
+	if (instructions == 0 || repeat < 1) {
+		fprintf(stderr, "hookbench: nothing to run\n");
+		return 2;
+	}
+
+	struct Result {
+		const char* name;
+		double seconds;
+	};
+	double bare = bench_bare(instructions, repeat);
+	Result results[] = {
+		{ "NullHooks", bench<NullHooks>(instructions, repeat) },
+		{ "CountingHooks", bench<CountingHooks>(instructions, repeat) },
+		{ "BreakpointHooks", bench<BreakpointHooks>(instructions, repeat) },
+		{ "TraceHooks", bench<TraceHooks>(instructions, repeat) }
+	};
+
+	//vs null is speed relative to NullHooks, vs bare is the extra time taken over BareLoop
+	printf("%-16s %10s %8s %10s %10s\n", "policy", "seconds", "MIPS", "vs null", "vs bare");
+	printf("%-16s %10.3f %8.2f %10s %10s\n", "(bare loop)", bare, (double)instructions / bare / 1000000.0, "", "");
+	for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+		double mips = (double)instructions / results[i].seconds / 1000000.0;
+		printf("%-16s %10.3f %8.2f %9.1f%% %+9.1f%%\n", results[i].name, results[i].seconds, mips, 100.0 * results[0].seconds / results[i].seconds,
+			100.0 * (results[i].seconds - bare) / bare);
+	}
+	return 0;
+}
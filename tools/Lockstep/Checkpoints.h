@@ -0,0 +1,215 @@
+#pragma once
+#include "Processor.h"
+#include <fstream>
+#include <string>
+
+/// <summary>
+/// A state hash taken every so many instructions of a recorded run, with the registers so a comparison can show where the runs were
+/// </summary>
+struct Checkpoint {
+	unsigned long long instructions; //run since the program was loaded
+	unsigned long long hash;
+	unsigned char registers[8]; //pc high, pc low, a, x, y, sp, status, jammed
+};
+
+/// <summary>
+/// Checkpoint files, written by lockstep --record and read by --compare and --resume, so runs of two different builds (or configurations) of the emulator
+/// can be compared without having both in one process. Everything is little endian.
+///   header  "6502CKP" and a version byte, the chunk (u64), the instruction the recording started at (u64), an FNV-1a hash of the image (u64)
+///   'C'     a checkpoint: instructions (u64), hash (u64), the 8 register bytes
+///   'S'     a snapshot: instructions (u64), the 8 register bytes, RAM size (u32) and RAM, ROM size (u32) and ROM (0 for a unified memory)
+/// A snapshot follows the checkpoint it was taken at, every so many checkpoints, so a later run can start from the nearest one instead of from the beginning.
+/// </summary>
+class CheckpointFile
+{
+private:
+	std::ofstream _output;
+	std::ifstream _input;
+	std::streamoff _first_record; //just after the header
+
+	void put(unsigned long long value, unsigned int bytes) {
+		for (unsigned int i = 0; i < bytes; i++) {
+			_output.put((char)(value >> (i * 8)));
+		}
+	}
+
+	bool get(unsigned long long& value, unsigned int bytes) {
+		char data[8];
+		if (!_input.read(data, bytes)) {
+			return false;
+		}
+		value = 0;
+		for (unsigned int i = 0; i < bytes; i++) {
+			value |= (unsigned long long)(unsigned char)data[i] << (i * 8);
+		}
+		return true;
+	}
+
+	static void pack_registers(const ProcessorSnapshot& snapshot, unsigned char* registers) {
+		registers[0] = snapshot.pc_high;
+		registers[1] = snapshot.pc_low;
+		registers[2] = snapshot.a;
+		registers[3] = snapshot.x;
+		registers[4] = snapshot.y;
+		registers[5] = snapshot.sp;
+		registers[6] = snapshot.status;
+		registers[7] = snapshot.jammed ? 1 : 0;
+	}
+
+	/// <summary>
+	/// Reads a snapshot record after its tag, or skips over the memory when snapshot is nullptr
+	/// </summary>
+	bool read_snapshot(unsigned long long& instructions, ProcessorSnapshot* snapshot) {
+		unsigned char registers[8];
+		unsigned long long size;
+		if (!get(instructions, 8) || !_input.read((char*)registers, sizeof(registers))) {
+			return false;
+		}
+		for (int part = 0; part < 2; part++) {
+			if (!get(size, 4)) {
+				return false;
+			}
+			if (snapshot == nullptr) {
+				_input.ignore((std::streamsize)size);
+				continue;
+			}
+			std::vector<unsigned char>& memory = part == 0 ? snapshot->ram : snapshot->rom;
+			memory.resize((size_t)size);
+			if (size > 0 && !_input.read((char*)memory.data(), (std::streamsize)size)) {
+				return false;
+			}
+		}
+		if (snapshot != nullptr) {
+			snapshot->pc_high = registers[0];
+			snapshot->pc_low = registers[1];
+			snapshot->a = registers[2];
+			snapshot->x = registers[3];
+			snapshot->y = registers[4];
+			snapshot->sp = registers[5];
+			snapshot->status = registers[6];
+			snapshot->jammed = registers[7] != 0;
+		}
+		return _input.good();
+	}
+
+public:
+	unsigned long long chunk = 0;
+	unsigned long long start_instruction = 0;
+	unsigned long long image_hash = 0;
+
+	/// <summary>
+	/// Starts a new file for recording, with chunk, start_instruction and image_hash as they're set now, false if it couldn't be written
+	/// </summary>
+	bool create(const std::string& path) {
+		_output.open(path, std::ios::binary | std::ios::trunc);
+		if (!_output.is_open()) {
+			return false;
+		}
+		_output.write("6502CKP\x01", 8);
+		put(chunk, 8);
+		put(start_instruction, 8);
+		put(image_hash, 8);
+		return _output.good();
+	}
+
+	void write_checkpoint(unsigned long long instructions, unsigned long long hash, const ProcessorSnapshot& snapshot) {
+		unsigned char registers[8];
+		pack_registers(snapshot, registers);
+		_output.put('C');
+		put(instructions, 8);
+		put(hash, 8);
+		_output.write((const char*)registers, sizeof(registers));
+	}
+
+	void write_snapshot(unsigned long long instructions, const ProcessorSnapshot& snapshot) {
+		unsigned char registers[8];
+		pack_registers(snapshot, registers);
+		_output.put('S');
+		put(instructions, 8);
+		_output.write((const char*)registers, sizeof(registers));
+		put(snapshot.ram.size(), 4);
+		_output.write((const char*)snapshot.ram.data(), (std::streamsize)snapshot.ram.size());
+		put(snapshot.rom.size(), 4);
+		_output.write((const char*)snapshot.rom.data(), (std::streamsize)snapshot.rom.size());
+	}
+
+	/// <summary>
+	/// Closes the file being recorded, false if anything on the way failed to write
+	/// </summary>
+	bool finish() {
+		_output.close();
+		return !_output.fail();
+	}
+
+	/// <summary>
+	/// Opens a recorded file and reads its header, false if it couldn't be read or isn't a checkpoint file
+	/// </summary>
+	bool open(const std::string& path) {
+		_input.open(path, std::ios::binary);
+		char magic[8];
+		if (!_input.is_open() || !_input.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != std::string("6502CKP\x01", 8)) {
+			return false;
+		}
+		if (!get(chunk, 8) || !get(start_instruction, 8) || !get(image_hash, 8)) {
+			return false;
+		}
+		_first_record = _input.tellg();
+		return true;
+	}
+
+	/// <summary>
+	/// Reads the next checkpoint in the file, snapshots on the way are skipped
+	/// </summary>
+	/// <returns>false at the end of the file, or where it's cut off</returns>
+	bool next(Checkpoint& checkpoint) {
+		int tag;
+		unsigned long long instructions;
+		while ((tag = _input.get()) == 'S') {
+			if (!read_snapshot(instructions, nullptr)) {
+				return false;
+			}
+		}
+		if (tag != 'C') {
+			return false;
+		}
+		return get(checkpoint.instructions, 8) && get(checkpoint.hash, 8) && _input.read((char*)checkpoint.registers, sizeof(checkpoint.registers));
+	}
+
+	/// <summary>
+	/// Finds the latest snapshot taken at or before an instruction count, the file is scanned from the start with only the memory of the one wanted read in,
+	/// next carries on from the beginning of the file afterwards
+	/// </summary>
+	/// <returns>false if there's no snapshot that early</returns>
+	bool find_snapshot(unsigned long long at, ProcessorSnapshot& snapshot, unsigned long long& instructions) {
+		std::streamoff best = -1;
+		int tag;
+		unsigned long long taken;
+		_input.clear();
+		_input.seekg(_first_record);
+		for (;;) {
+			std::streamoff position = _input.tellg();
+			tag = _input.get();
+			if (tag == 'C') {
+				_input.ignore(8 + 8 + 8);
+			}
+			else if (tag == 'S' && read_snapshot(taken, nullptr)) {
+				if (taken > at) {
+					break; //they're in order, the rest are all later
+				}
+				best = position;
+			}
+			else {
+				break;
+			}
+		}
+		_input.clear();
+		bool found = false;
+		if (best >= 0) {
+			_input.seekg(best + 1);
+			found = read_snapshot(instructions, &snapshot);
+		}
+		_input.clear();
+		_input.seekg(_first_record);
+		return found;
+	}
+};
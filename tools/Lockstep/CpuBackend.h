@@ -0,0 +1,135 @@
+#pragma once
+#include "Processor.h"
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Interface the lockstep harness drives, one implementation per CPU core being compared (the reference interpreter, its fused run path, and whatever optimized cores get added later)
+/// the harness compares the register block (CpuState, with same_cpu_state, so the cycle counts have to agree too) and the memory (through ProcessorSnapshot),
+/// so a backend only has to be able to save and restore those
+/// </summary>
+class CpuBackend
+{
+public:
+	virtual ~CpuBackend() {}
+	virtual const char* name() = 0;
+	virtual void load(const std::vector<unsigned char>& image, unsigned short load_address, unsigned short start_address) = 0; //load a flat 64K image and set the program counter
+	virtual unsigned long long run(unsigned long long count) = 0; //run up to count instructions, returns how many ran (fewer only if the core jammed)
+	virtual void save(ProcessorSnapshot& snapshot) = 0;
+	virtual void restore(const ProcessorSnapshot& snapshot) = 0;
+	virtual const CpuState& cpu_state() = 0; //registers, jam state and cycle count
+	virtual void restore_cpu_state(const CpuState& state) = 0; //after restore, which leaves the cycle count alone
+};
+
+/// <summary>
+/// The reference backend, the Processor class as it is, with a unified 64K memory
+/// </summary>
+class ProcessorBackend : public CpuBackend
+{
+protected:
+	Processor _cpu;
+
+public:
+	ProcessorBackend() : _cpu((unsigned int)65536) {}
+
+	const char* name() override {
+		return "reference";
+	}
+
+	void load(const std::vector<unsigned char>& image, unsigned short load_address, unsigned short start_address) override {
+		_cpu.load_program(image.data(), (unsigned int)image.size(), load_address);
+		_cpu.set_pc((start_address >> 8) & 0xFF, start_address & 0xFF);
+	}
+
+	unsigned long long run(unsigned long long count) override {
+		return _cpu.run(count);
+	}
+
+	void save(ProcessorSnapshot& snapshot) override {
+		_cpu.save_snapshot(snapshot);
+	}
+
+	void restore(const ProcessorSnapshot& snapshot) override {
+		_cpu.load_snapshot(snapshot);
+	}
+
+	const CpuState& cpu_state() override {
+		return _cpu.get_cpu_state();
+	}
+
+	void restore_cpu_state(const CpuState& state) override {
+		_cpu.set_cpu_state(state);
+	}
+};
+
+/// <summary>
+/// The fused run path (see Processor::enable_fusion), the same core but with common instruction sequences run as one handler out of the predecode cache
+/// the warm up is kept short so the sequences get picked within the first chunk or two, it carries on across restores, since the cache checks every opcode it fetches
+/// </summary>
+class FusedBackend : public ProcessorBackend
+{
+public:
+	static const unsigned long long WARMUP = 10000;
+
+	FusedBackend() {
+		_cpu.enable_fusion(WARMUP);
+	}
+
+	const char* name() override {
+		return "fused";
+	}
+
+	const FusionStats& fusion_stats() {
+		return _cpu.get_fusion_stats();
+	}
+};
+
+/// <summary>
+/// The reference core with a bug planted in it on purpose, for --self-test to check that a difference really gets reported (and pinned to the right instruction)
+/// INX wraps from $FF to $01 instead of $00, so X stays one ahead of the reference from the first wrap on, and whatever gets stored from it differs too.
+/// It only depends on the state, not on how many instructions have run, so restoring a snapshot and running again plants it at the same place every time
+/// </summary>
+class PlantedBackend : public ProcessorBackend
+{
+public:
+	const char* name() override {
+		return "planted";
+	}
+
+	unsigned long long run(unsigned long long count) override {
+		unsigned long long executed = 0;
+		while (executed < count) {
+			unsigned char opcode = _cpu.get_rom_value(_cpu.get_pc_high(), _cpu.get_pc_low());
+			if (_cpu.run(1) == 0) {
+				break;
+			}
+			executed++;
+			if (opcode == 0xE8 && _cpu.get_x() == 0x00) {
+				CpuState state = _cpu.get_cpu_state();
+				state.x = 0x01;
+				_cpu.set_cpu_state(state);
+			}
+		}
+		return executed;
+	}
+};
+
+/// <summary>
+/// Creates a backend by name, returns nullptr for an unknown name, new cores get added here
+/// </summary>
+inline CpuBackend* create_backend(const std::string& name) {
+	if (name == "reference") {
+		return new ProcessorBackend();
+	}
+	if (name == "fused") {
+		return new FusedBackend();
+	}
+	if (name == "planted") {
+		return new PlantedBackend();
+	}
+	return nullptr;
+}
+
+inline const char* backend_names() {
+	return "reference, fused, planted (a deliberately broken reference, for --self-test)";
+}
@@ -0,0 +1,632 @@
+// Lockstep.cpp : differential execution of two CPU backends, to check that an optimized core still does exactly what the reference core does
+//
+// Both backends run the same ROM in chunks of N instructions (N = 1 is plain instruction by instruction lockstep), and after every chunk the
+// full state (registers and memory) of each is hashed and compared. When the hashes differ, both are put back to the snapshot taken at the end of the
+// last matching chunk and the chunk is bisected to find the exact instruction where they split, then both states are dumped around that instruction.
+// A run also ends when both cores jam, when a whole chunk leaves the state unchanged (a trap loop), or at the instruction limit.
+// Multiple ROMs are spread across one worker thread per core. By default the reference core is run against its own fused run path.
+// --self-test checks the harness itself on a small built in program: the fused path has to match the reference, and a backend with a bug planted
+// in it on purpose (see PlantedBackend) has to be reported as diverging at the instruction the bug is in.
+//
+// Two builds of the emulator (or two configurations that can't share a process) are compared through checkpoint files instead (see Checkpoints.h):
+// --record runs backend a alone and writes the state hash every chunk instructions, with a full snapshot every --snapshots checkpoints, and
+// --compare reads two of those and finds the first checkpoint where they differ. Only that interval then needs looking at closer: each build runs
+// --record again with --resume on its own file and --from the last matching checkpoint, which starts from the nearest snapshot instead of from the
+// beginning, with a smaller chunk (1 for every instruction) and --max the length of the interval, and --compare on those two gives the exact instruction.
+//
+// usage: lockstep [--a <backend>] [--b <backend>] [--chunk <n>] [--max <instructions>] [--threads <n>] <rom>[:<load>[:<start>]]...
+//        lockstep --record <file> [--a <backend>] [--chunk <n>] [--max <instructions>] [--snapshots <n>] [--resume <file> --from <instruction>] <rom>[:<load>[:<start>]]
+//        lockstep --compare <file> <file>
+//        lockstep --self-test
+
+#include "CpuBackend.h"
+#include "Checkpoints.h"
+#include "Disassembler.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LockstepOptions {
+	std::string backend_a = "reference";
+	std::string backend_b = "fused";
+	unsigned long long chunk = 1000;
+	unsigned long long max_instructions = 100000000ULL;
+	unsigned int threads = 0;
+
+	//checkpoint files
+	std::string record_path;
+	unsigned long long snapshot_every = 1024; //checkpoints between snapshots
+	std::string resume_path;
+	unsigned long long from = 0;
+	bool from_set = false;
+};
+
+struct RomJob {
+	std::string spec;
+	std::string path;
+	unsigned short load_address;
+	unsigned short start_address;
+	bool diverged;
+	std::string report; //filled in by the worker, printed in order at the end
+};
+
+/// <summary>
+/// Everything the harness keeps of a backend between chunks, the memory (and registers) in the snapshot and the whole register block, cycle count included
+/// </summary>
+struct SavedState {
+	ProcessorSnapshot snapshot;
+	CpuState cpu;
+};
+
+static void save_state(CpuBackend& backend, SavedState& saved) {
+	backend.save(saved.snapshot);
+	saved.cpu = backend.cpu_state();
+}
+
+static void restore_state(CpuBackend& backend, const SavedState& saved) {
+	backend.restore(saved.snapshot);
+	backend.restore_cpu_state(saved.cpu);
+}
+
+/// <summary>
+/// FNV-1a over everything in the snapshot, registers first
+/// </summary>
+static unsigned long long hash_snapshot(const ProcessorSnapshot& snapshot) {
+	unsigned long long hash = 14695981039346656037ULL;
+	const unsigned char registers[] = { snapshot.pc_high, snapshot.pc_low, snapshot.a, snapshot.x, snapshot.y, snapshot.sp, snapshot.status, (unsigned char)snapshot.jammed };
+	for (size_t i = 0; i < sizeof(registers); i++) {
+		hash = (hash ^ registers[i]) * 1099511628211ULL;
+	}
+	for (size_t i = 0; i < snapshot.ram.size(); i++) {
+		hash = (hash ^ snapshot.ram[i]) * 1099511628211ULL;
+	}
+	for (size_t i = 0; i < snapshot.rom.size(); i++) {
+		hash = (hash ^ snapshot.rom[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/// <summary>
+/// printf into the end of a report, reports are built up per ROM and only printed once all workers are done
+/// </summary>
+static void append(std::string& out, const char* format, ...) {
+	char line[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	out += line;
+}
+
+static void dump_registers(std::string& out, const char* label, const SavedState& saved) {
+	const ProcessorSnapshot& s = saved.snapshot;
+	append(out, "    %-10s PC=$%02X%02X A=$%02X X=$%02X Y=$%02X SP=$%02X P=$%02X cycles=%llu%s\n", label, s.pc_high, s.pc_low, s.a, s.x, s.y, s.sp, s.status, saved.cpu.cycles, s.jammed ? " JAMMED" : "");
+}
+
+/// <summary>
+/// Whether two backends are in the same state, the register blocks are compared whole and the memory by hash
+/// </summary>
+/// <param name="hash_a">set to the hash of a's snapshot, for the trap check</param>
+static bool same_state(const SavedState& a, const SavedState& b, unsigned long long& hash_a) {
+	hash_a = hash_snapshot(a.snapshot);
+	return same_cpu_state(a.cpu, b.cpu) && hash_a == hash_snapshot(b.snapshot);
+}
+
+/// <summary>
+/// Disassembles the instruction a snapshot is about to run, from the ROM, or the RAM for a unified memory
+/// </summary>
+static void disassemble_next(const ProcessorSnapshot& s, char* text) {
+	const std::vector<unsigned char>& code = s.rom.empty() ? s.ram : s.rom;
+	unsigned short pc = (unsigned short)((s.pc_high << 8) | s.pc_low);
+	unsigned char bytes[3];
+	for (unsigned int i = 0; i < 3; i++) {
+		bytes[i] = code.empty() ? 0 : code[(pc + i) % code.size()];
+	}
+	Disassembler<char>::disassemble(pc, bytes, text);
+}
+
+/// <summary>
+/// Lists the memory addresses where two snapshots differ, up to a limit
+/// </summary>
+static void dump_memory_diff(std::string& out, const ProcessorSnapshot& a, const ProcessorSnapshot& b) {
+	const size_t limit = 16;
+	size_t shown = 0;
+	size_t total = 0;
+	for (size_t i = 0; i < a.ram.size() && i < b.ram.size(); i++) {
+		if (a.ram[i] != b.ram[i]) {
+			if (shown < limit) {
+				append(out, "    [$%04X] a=$%02X b=$%02X\n", (unsigned int)i, a.ram[i], b.ram[i]);
+				shown++;
+			}
+			total++;
+		}
+	}
+	if (total > shown) {
+		append(out, "    ... %zu more differing bytes\n", total - shown);
+	}
+}
+
+/// <summary>
+/// Finds the first instruction inside a chunk where the two backends diverge, both start from their snapshot at the start of the chunk (which matched)
+/// and the chunk is known to end in a mismatch after chunk_length instructions, so a binary search on the instruction count finds the split point
+/// </summary>
+static void bisect(CpuBackend& a, CpuBackend& b, const SavedState& good_a, const SavedState& good_b, unsigned long long chunk_length, unsigned long long chunk_start, std::string& report) {
+	SavedState saved_a;
+	SavedState saved_b;
+	unsigned long long hash;
+	unsigned long long low = 0; //instruction count known to still match
+	unsigned long long high = chunk_length; //instruction count known to mismatch
+	while (high - low > 1) {
+		unsigned long long mid = low + (high - low) / 2;
+		restore_state(a, good_a);
+		restore_state(b, good_b);
+		unsigned long long ran_a = a.run(mid);
+		unsigned long long ran_b = b.run(mid);
+		save_state(a, saved_a);
+		save_state(b, saved_b);
+		if (ran_a == ran_b && same_state(saved_a, saved_b, hash)) {
+			low = mid;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	//the last matching state, then one more instruction
+	restore_state(a, good_a);
+	restore_state(b, good_b);
+	a.run(low);
+	b.run(low);
+	save_state(a, saved_a);
+	char text[Disassembler<char>::MAX_TEXT];
+	disassemble_next(saved_a.snapshot, text);
+	append(report, "  diverged at instruction %llu, %s\n", chunk_start + low + 1, text);
+	dump_registers(report, "before", saved_a);
+	a.run(1);
+	b.run(1);
+	save_state(a, saved_a);
+	save_state(b, saved_b);
+	dump_registers(report, a.name(), saved_a);
+	dump_registers(report, b.name(), saved_b);
+	dump_memory_diff(report, saved_a.snapshot, saved_b.snapshot);
+}
+
+static bool parse_rom(RomJob& job) {
+	job.path = job.spec;
+	job.load_address = 0x0000;
+	job.start_address = 0x0400;
+	std::vector<std::string> fields;
+	std::string rest = job.spec;
+	while (fields.size() < 2) {
+		size_t colon = rest.rfind(':');
+		if (colon == std::string::npos) {
+			break;
+		}
+		std::string field = rest.substr(colon + 1);
+		if (field.empty() || field.size() > 4 || field.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+			break;
+		}
+		fields.insert(fields.begin(), field);
+		rest = rest.substr(0, colon);
+	}
+	job.path = rest;
+	if (fields.size() > 0) {
+		job.load_address = (unsigned short)strtoul(fields[0].c_str(), nullptr, 16);
+	}
+	if (fields.size() > 1) {
+		job.start_address = (unsigned short)strtoul(fields[1].c_str(), nullptr, 16);
+	}
+	return !job.path.empty();
+}
+
+/// <summary>
+/// Runs backends a and b side by side on one image in chunks until they diverge, both jam or trap, or the instruction limit, and writes the outcome to the job's report
+/// </summary>
+/// <returns>instructions run while they still matched</returns>
+static unsigned long long run_image(RomJob& job, const std::vector<unsigned char>& image, const LockstepOptions& options) {
+	job.diverged = false;
+	std::unique_ptr<CpuBackend> a(create_backend(options.backend_a));
+	std::unique_ptr<CpuBackend> b(create_backend(options.backend_b));
+	a->load(image, job.load_address, job.start_address);
+	b->load(image, job.load_address, job.start_address);
+
+	SavedState good_a;
+	SavedState good_b;
+	SavedState next_a;
+	SavedState next_b;
+	save_state(*a, good_a);
+	save_state(*b, good_b);
+	unsigned long long good_hash = hash_snapshot(good_a.snapshot);
+
+	unsigned long long executed = 0;
+	const char* outcome = "instruction limit reached";
+	while (executed < options.max_instructions) {
+		unsigned long long ran_a = a->run(options.chunk);
+		unsigned long long ran_b = b->run(options.chunk);
+		save_state(*a, next_a);
+		save_state(*b, next_b);
+		unsigned long long hash_a;
+		if (ran_a != ran_b || !same_state(next_a, next_b, hash_a)) {
+			append(job.report, "%s: MISMATCH between %s and %s\n", job.path.c_str(), a->name(), b->name());
+			bisect(*a, *b, good_a, good_b, ran_a > ran_b ? ran_a : ran_b, executed, job.report);
+			job.diverged = true;
+			return executed;
+		}
+		executed += ran_a;
+		if (ran_a < options.chunk) {
+			outcome = "both jammed";
+			break;
+		}
+		if (hash_a == good_hash) {
+			outcome = "both trapped"; //the cycle count moves on in a trap loop, so only the snapshot is compared for this
+			break;
+		}
+		std::swap(good_a, next_a);
+		std::swap(good_b, next_b);
+		good_hash = hash_a;
+	}
+	append(job.report, "%s: match, %llu instructions (%s)\n", job.path.c_str(), executed, outcome);
+	return executed;
+}
+
+static void run_job(RomJob& job, const LockstepOptions& options) {
+	std::ifstream file(job.path, std::ios::binary);
+	if (!file.is_open()) {
+		append(job.report, "%s: could not read file\n", job.path.c_str());
+		job.diverged = true;
+		return;
+	}
+	std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	run_image(job, image, options);
+}
+
+/// <summary>
+/// Checks the harness on a built in program, a loop that counts X up (and stores it through A), and has a CLC ADC and an LDA STA in it for the fused path to pick up.
+/// The fused backend has to match the reference over the whole run with its sequences firing, and the planted backend (INX wraps to 1) has to diverge exactly
+/// at the 256th INX, with the chunks both large (bisection) and 1 (plain lockstep)
+/// </summary>
+/// <returns>0 if every check passed, 1 otherwise</returns>
+static int self_test() {
+	static const unsigned char program[] = {
+		0xA2, 0x00,			//$0400 LDX #$00
+		0xE8,				//$0402 INX
+		0x8A,				//$0403 TXA (the core has no STX yet)
+		0x8D, 0x00, 0x02,	//$0404 STA $0200
+		0x18,				//$0407 CLC
+		0x69, 0x03,			//$0408 ADC #$03
+		0x8D, 0x01, 0x02,	//$040A STA $0201
+		0xA9, 0x55,			//$040D LDA #$55
+		0x8D, 0x02, 0x02,	//$040F STA $0202
+		0x4C, 0x02, 0x04	//$0412 JMP $0402
+	};
+	const unsigned long long loop_length = 9;
+	const unsigned long long planted_at = 2 + 255 * loop_length; //the LDX, then 255 turns of the loop, then the INX that wraps
+
+	std::vector<unsigned char> image(65536, 0x00);
+	memcpy(image.data() + 0x0400, program, sizeof(program));
+	LockstepOptions options;
+	options.max_instructions = 200000;
+	int failures = 0;
+
+	RomJob job;
+	job.path = "self-test (reference against fused)";
+	job.load_address = 0x0000;
+	job.start_address = 0x0400;
+	options.backend_a = "reference";
+	options.backend_b = "fused";
+	unsigned long long matched = run_image(job, image, options);
+	fputs(job.report.c_str(), stdout);
+	FusedBackend fused;
+	fused.load(image, 0x0000, 0x0400);
+	fused.run(options.max_instructions);
+	unsigned long long fused_instructions = fused.fusion_stats().fused_instructions;
+	if (job.diverged || matched != options.max_instructions || fused_instructions == 0) {
+		printf("FAILED: the fused path should match the reference for %llu instructions with some of them run fused (%llu were)\n", options.max_instructions, fused_instructions);
+		failures++;
+	}
+
+	const unsigned long long chunks[] = { options.chunk, 1 };
+	for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+		RomJob planted = job;
+		planted.path = "self-test (reference against planted)";
+		planted.report.clear();
+		options.backend_b = "planted";
+		options.chunk = chunks[i];
+		run_image(planted, image, options);
+		fputs(planted.report.c_str(), stdout);
+		char expected[64];
+		snprintf(expected, sizeof(expected), "diverged at instruction %llu,", planted_at);
+		if (!planted.diverged || planted.report.find(expected) == std::string::npos) {
+			printf("FAILED: with --chunk %llu the planted bug should be reported at instruction %llu\n", chunks[i], planted_at);
+			failures++;
+		}
+	}
+	printf("self test %s\n", failures == 0 ? "passed" : "FAILED");
+	return failures == 0 ? 0 : 1;
+}
+
+/// <summary>
+/// Runs backend a alone and writes its checkpoints, started from the beginning, or with --resume from the nearest snapshot in an earlier recording
+/// of the same build and run on to --from before the first checkpoint
+/// </summary>
+static int record_run(RomJob& job, const LockstepOptions& options) {
+	std::ifstream file(job.path, std::ios::binary);
+	if (!file.is_open()) {
+		fprintf(stderr, "lockstep: could not read %s\n", job.path.c_str());
+		return 1;
+	}
+	std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	unsigned long long image_hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < image.size(); i++) {
+		image_hash = (image_hash ^ image[i]) * 1099511628211ULL;
+	}
+
+	std::unique_ptr<CpuBackend> cpu(create_backend(options.backend_a));
+	cpu->load(image, job.load_address, job.start_address);
+	ProcessorSnapshot snapshot;
+	unsigned long long executed = 0;
+	if (!options.resume_path.empty()) {
+		CheckpointFile earlier;
+		if (!earlier.open(options.resume_path)) {
+			fprintf(stderr, "lockstep: %s is not a checkpoint file\n", options.resume_path.c_str());
+			return 1;
+		}
+		if (earlier.image_hash != image_hash) {
+			fprintf(stderr, "lockstep: %s was recorded from a different image\n", options.resume_path.c_str());
+			return 1;
+		}
+		if (!earlier.find_snapshot(options.from, snapshot, executed)) {
+			fprintf(stderr, "lockstep: %s has no snapshot at or before instruction %llu\n", options.resume_path.c_str(), options.from);
+			return 1;
+		}
+		cpu->restore(snapshot);
+		executed += cpu->run(options.from - executed);
+		if (executed < options.from) {
+			fprintf(stderr, "lockstep: the run jammed at instruction %llu, before %llu\n", executed, options.from);
+			return 1;
+		}
+	}
+
+	CheckpointFile out;
+	out.chunk = options.chunk;
+	out.start_instruction = executed;
+	out.image_hash = image_hash;
+	if (!out.create(options.record_path)) {
+		fprintf(stderr, "lockstep: could not write %s\n", options.record_path.c_str());
+		return 1;
+	}
+	cpu->save(snapshot);
+	unsigned long long last_hash = hash_snapshot(snapshot);
+	out.write_checkpoint(executed, last_hash, snapshot);
+	out.write_snapshot(executed, snapshot);
+	unsigned long long checkpoints = 1;
+	unsigned long long snapshots = 1;
+
+	unsigned long long end = out.start_instruction + options.max_instructions;
+	const char* outcome = "instruction limit reached";
+	while (executed < end) {
+		unsigned long long step = end - executed < options.chunk ? end - executed : options.chunk;
+		unsigned long long ran = cpu->run(step);
+		executed += ran;
+		cpu->save(snapshot);
+		unsigned long long hash = hash_snapshot(snapshot);
+		out.write_checkpoint(executed, hash, snapshot);
+		checkpoints++;
+		if (options.snapshot_every > 0 && checkpoints % options.snapshot_every == 0) {
+			out.write_snapshot(executed, snapshot);
+			snapshots++;
+		}
+		if (ran < step) {
+			outcome = "jammed";
+			break;
+		}
+		if (hash == last_hash) {
+			outcome = "trapped";
+			break;
+		}
+		last_hash = hash;
+	}
+	if (!out.finish()) {
+		fprintf(stderr, "lockstep: could not write %s\n", options.record_path.c_str());
+		return 1;
+	}
+	printf("%s: %llu checkpoints and %llu snapshots of %s from instruction %llu to %llu (%s)\n", options.record_path.c_str(), checkpoints, snapshots, cpu->name(), out.start_instruction, executed, outcome);
+	return 0;
+}
+
+static void print_checkpoint(const char* label, const Checkpoint& c) {
+	printf("    %-10s PC=$%02X%02X A=$%02X X=$%02X Y=$%02X SP=$%02X P=$%02X%s\n", label, c.registers[0], c.registers[1], c.registers[2], c.registers[3], c.registers[4], c.registers[5], c.registers[6], c.registers[7] ? " JAMMED" : "");
+}
+
+/// <summary>
+/// Walks two checkpoint files side by side to the first checkpoint where the hashes (or instruction counts) differ. The walk only reads hashes, the
+/// emulation it saves is everything outside the interval it reports, which is what gets recorded again in detail.
+/// </summary>
+static int compare_files(const char* path_a, const char* path_b) {
+	CheckpointFile a;
+	CheckpointFile b;
+	if (!a.open(path_a) || !b.open(path_b)) {
+		fprintf(stderr, "lockstep: %s is not a checkpoint file\n", a.chunk == 0 ? path_a : path_b);
+		return 2;
+	}
+	if (a.chunk != b.chunk || a.start_instruction != b.start_instruction) {
+		fprintf(stderr, "lockstep: %s and %s weren't recorded with the same --chunk and --from\n", path_a, path_b);
+		return 2;
+	}
+	if (a.image_hash != b.image_hash) {
+		printf("warning: %s and %s were recorded from different images\n", path_a, path_b);
+	}
+
+	Checkpoint last;
+	Checkpoint next_a;
+	Checkpoint next_b;
+	bool has_a;
+	bool has_b;
+	unsigned long long matched = 0;
+	for (;;) {
+		has_a = a.next(next_a);
+		has_b = b.next(next_b);
+		if (!has_a && !has_b) {
+			printf("match, %llu checkpoints from instruction %llu to %llu\n", matched, a.start_instruction, matched > 0 ? last.instructions : a.start_instruction);
+			return 0;
+		}
+		if (!has_a || !has_b || next_a.instructions != next_b.instructions || next_a.hash != next_b.hash) {
+			break;
+		}
+		last = next_a;
+		matched++;
+	}
+
+	printf("MISMATCH between %s and %s\n", path_a, path_b);
+	if (matched == 0) {
+		printf("  they differ from the first checkpoint, at instruction %llu\n", a.start_instruction);
+		return 1;
+	}
+	unsigned long long end = last.instructions + a.chunk;
+	if (a.chunk == 1) {
+		printf("  diverged at instruction %llu\n", last.instructions + 1);
+	}
+	else {
+		printf("  first difference within instructions %llu to %llu\n", last.instructions + 1, end);
+	}
+	print_checkpoint("before", last);
+	if (has_a) {
+		print_checkpoint("a", next_a);
+	}
+	else {
+		printf("    a          recording ends here\n");
+	}
+	if (has_b) {
+		print_checkpoint("b", next_b);
+	}
+	else {
+		printf("    b          recording ends here\n");
+	}
+
+	ProcessorSnapshot snapshot;
+	unsigned long long snapshot_at;
+	if (a.chunk > 1 && a.find_snapshot(last.instructions, snapshot, snapshot_at)) {
+		printf("  nearest snapshot at instruction %llu, record the interval in detail with each build:\n", snapshot_at);
+		printf("    lockstep --record <file> --resume <its checkpoints> --from %llu --chunk 1 --max %llu <rom>\n", last.instructions, end - last.instructions);
+	}
+	return 1;
+}
+
+struct LockstepShared {
+	std::vector<RomJob> jobs;
+	std::atomic<size_t> next_job;
+	LockstepOptions options;
+};
+
+static void worker(LockstepShared* shared) {
+	size_t index;
+	while ((index = shared->next_job.fetch_add(1)) < shared->jobs.size()) {
+		run_job(shared->jobs[index], shared->options);
+	}
+}
+
+int main(int argc, char** argv) {
+	LockstepShared shared;
+	LockstepOptions& options = shared.options;
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--a") == 0 && has_value) {
+			options.backend_a = argv[++i];
+		}
+		else if (strcmp(argv[i], "--b") == 0 && has_value) {
+			options.backend_b = argv[++i];
+		}
+		else if (strcmp(argv[i], "--chunk") == 0 && has_value) {
+			options.chunk = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--max") == 0 && has_value) {
+			options.max_instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+			options.threads = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--record") == 0 && has_value) {
+			options.record_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--snapshots") == 0 && has_value) {
+			options.snapshot_every = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--resume") == 0 && has_value) {
+			options.resume_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--from") == 0 && has_value) {
+			options.from = strtoull(argv[++i], nullptr, 10);
+			options.from_set = true;
+		}
+		else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc && argc == 4) {
+			return compare_files(argv[i + 1], argv[i + 2]);
+		}
+		else if (strcmp(argv[i], "--self-test") == 0 && argc == 2) {
+			return self_test();
+		}
+		else if (argv[i][0] == '-') {
+			shared.jobs.clear();
+			break;
+		}
+		else {
+			RomJob job;
+			job.spec = argv[i];
+			if (!parse_rom(job)) {
+				shared.jobs.clear();
+				break;
+			}
+			shared.jobs.push_back(job);
+		}
+	}
+	bool recording = !options.record_path.empty();
+	if (shared.jobs.empty() || options.chunk == 0 || (recording && shared.jobs.size() != 1) || options.resume_path.empty() != !options.from_set) {
+		fprintf(stderr, "usage: lockstep [--a <backend>] [--b <backend>] [--chunk <n>] [--max <instructions>] [--threads <n>] <rom>[:<load>[:<start>]]...\n");
+		fprintf(stderr, "       lockstep --record <file> [--a <backend>] [--chunk <n>] [--max <instructions>] [--snapshots <n>] [--resume <file> --from <instruction>] <rom>[:<load>[:<start>]]\n");
+		fprintf(stderr, "       lockstep --compare <file> <file>\n");
+		fprintf(stderr, "       lockstep --self-test\n");
+		fprintf(stderr, "backends: %s\n", backend_names());
+		return 2;
+	}
+	std::unique_ptr<CpuBackend> check_a(create_backend(options.backend_a));
+	std::unique_ptr<CpuBackend> check_b(create_backend(options.backend_b));
+	if (!check_a || !check_b) {
+		fprintf(stderr, "lockstep: unknown backend, available: %s\n", backend_names());
+		return 2;
+	}
+	if (recording) {
+		return record_run(shared.jobs[0], options);
+	}
+
+	unsigned int threads = options.threads;
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	}
+	if (threads > shared.jobs.size()) {
+		threads = (unsigned int)shared.jobs.size();
+	}
+	shared.next_job.store(0);
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < threads; i++) {
+		pool.push_back(std::thread(worker, &shared));
+	}
+	for (size_t i = 0; i < pool.size(); i++) {
+		pool[i].join();
+	}
+
+	int diverged = 0;
+	for (size_t i = 0; i < shared.jobs.size(); i++) {
+		fputs(shared.jobs[i].report.c_str(), stdout);
+		if (shared.jobs[i].diverged) {
+			diverged++;
+		}
+	}
+	printf("%d of %zu ROMs diverged\n", diverged, shared.jobs.size());
+	return diverged > 0 ? 1 : 0;
+}
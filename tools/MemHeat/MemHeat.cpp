@@ -0,0 +1,125 @@
+// MemHeat.cpp : memory access heatmap for guest programs, for sizing RAM and the stack of a target and picking what goes in the zero page
+//
+// Loads an image into a unified 64K processor built with HeatmapHooks, runs it, and prints the stack's high water mark and the busiest zero page locations,
+// along with the busiest variables outside the zero page, the candidates for moving in. --csv writes the read and write count of every address touched,
+// --bmp a 256x256 picture of the address space (one row per page, reads green, writes red).
+//
+// usage: memheat [--symbols <file>]... [--max <instructions>] [--top <count>] [--csv <file>] [--bmp <file>] <image>[:<load>[:<start>]]
+//   symbol files can be ld65 .dbg files, VICE label files or plain "address name" lists, addresses in hex, load and start default to 0000 and 0400
+
+#include "ProcessorImpl.h"
+#include "MemoryHeatmap.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+template class BasicProcessor<HeatmapHooks>;
+
+static const unsigned long long BATCH = 100000; //instructions per run call, between checks for a jam
+
+int main(int argc, char** argv) {
+	std::vector<const char*> symbol_files;
+	unsigned long long max_instructions = 100000000ULL;
+	unsigned int top = 16;
+	const char* csv_path = nullptr;
+	const char* bmp_path = nullptr;
+	std::string spec;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+			symbol_files.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			max_instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+			top = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+			csv_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--bmp") == 0 && i + 1 < argc) {
+			bmp_path = argv[++i];
+		}
+		else if (argv[i][0] != '-' && spec.empty()) {
+			spec = argv[i];
+		}
+		else {
+			spec.clear();
+			break;
+		}
+	}
+	if (spec.empty()) {
+		fprintf(stderr, "usage: memheat [--symbols <file>]... [--max <instructions>] [--top <count>] [--csv <file>] [--bmp <file>] <image>[:<load>[:<start>]]\n");
+		return 2;
+	}
+
+	//image[:load[:start]], fields taken from the right so a drive letter in the path stays put
+	unsigned short addresses[2] = { 0x0000, 0x0400 };
+	std::vector<std::string> fields;
+	while (fields.size() < 2) {
+		size_t colon = spec.rfind(':');
+		if (colon == std::string::npos) {
+			break;
+		}
+		std::string field = spec.substr(colon + 1);
+		if (field.empty() || field.size() > 4 || field.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+			break;
+		}
+		fields.insert(fields.begin(), field);
+		spec = spec.substr(0, colon);
+	}
+	for (size_t i = 0; i < fields.size(); i++) {
+		addresses[i] = (unsigned short)strtoul(fields[i].c_str(), nullptr, 16);
+	}
+
+	std::ifstream file(spec, std::ios::binary);
+	if (!file.is_open()) {
+		fprintf(stderr, "memheat: could not read %s\n", spec.c_str());
+		return 1;
+	}
+	std::vector<unsigned char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	SymbolTable symbols;
+	for (size_t i = 0; i < symbol_files.size(); i++) {
+		if (!symbols.load(symbol_files[i])) {
+			fprintf(stderr, "memheat: could not read %s\n", symbol_files[i]);
+			return 1;
+		}
+	}
+
+	BasicProcessor<HeatmapHooks>* cpu = new BasicProcessor<HeatmapHooks>((unsigned int)65536); //the counters are 512K, kept off the stack
+	cpu->load_program(image.data(), (unsigned int)image.size(), addresses[0]);
+	cpu->set_pc((addresses[1] >> 8) & 0xFF, addresses[1] & 0xFF);
+
+	unsigned long long instructions = 0;
+	while (instructions < max_instructions && !cpu->is_jammed()) {
+		instructions += cpu->run(max_instructions - instructions < BATCH ? max_instructions - instructions : BATCH);
+	}
+
+	HeatmapHooks& heatmap = cpu->get_hooks();
+	fprintf(stdout, "%llu instructions, %llu cycles%s\n", instructions, cpu->get_cycles(), cpu->is_jammed() ? ", stopped on a jam" : "");
+	heatmap.write_zero_page_summary(stdout, symbols, top);
+
+	int status = 0;
+	if (csv_path != nullptr) {
+		FILE* csv = fopen(csv_path, "w");
+		if (csv == nullptr) {
+			fprintf(stderr, "memheat: could not write %s\n", csv_path);
+			status = 1;
+		}
+		else {
+			heatmap.write_csv(csv, symbols);
+			fclose(csv);
+		}
+	}
+	if (bmp_path != nullptr && !heatmap.write_bmp(bmp_path)) {
+		fprintf(stderr, "memheat: could not write %s\n", bmp_path);
+		status = 1;
+	}
+	delete cpu;
+	return status;
+}
@@ -0,0 +1,549 @@
+// RomRunner.cpp : headless runner for self checking 6502 test ROMs (Klaus Dormann's functional test and similar suites)
+//
+// Each suite is a binary image that gets loaded into a unified 64K Processor and run from its start address until it gets stuck in a trap,
+// which is how these suites report their result: a JMP * or a branch to itself at the success address means pass, anywhere else is the failing test.
+// Trap detection is done every few instructions by stepping once and checking whether the program counter moved, so the check costs almost nothing
+// and the instruction count, wall time and MIPS double as the standard throughput benchmark for the core.
+//
+// Suites run in parallel, one worker thread per core (--threads to change that), and are printed in the order given once all are done.
+// A suite can come with an input script, a file of bytes fed to the guest through an ACIA mapped at page --acia, as fast as the guest takes them.
+//
+// With --cache, every result is stored in a directory keyed by a hash of everything that decides it: the image, the load, start and success addresses,
+// the instruction limit, the ACIA page, the input script and the build of the emulator (a hash of the executable). A suite whose key is already there isn't run at all,
+// its verdict is read back, so a CI job only pays for the suites that changed. The entry also holds the final registers and RAM, for looking into a failure.
+// Entries are written to a temporary file and renamed into place, so jobs sharing a cache directory never see half an entry.
+//
+// With --coverage the suites run on a processor built with CoverageHooks and what they executed, all suites together, is saved as a coverage map
+// (see CoverageMap), for covmerge to merge with other runs and turn into an lcov report. Cached results have no coverage, so --coverage runs every suite
+// (and still fills the cache).
+//
+// usage: romrunner [--max <instructions>] [--list <file>] [--threads <n>] [--cache <directory>] [--acia <page>] [--coverage <file>] <suite>...
+//   suite: <path>[:<load>[:<start>[:<success>]]][@<input>], addresses in hex, defaults 0000:0400:3469 (the standard build of 6502_functional_test.bin)
+//   a list file has one suite per line, blank lines and lines starting with # are skipped
+
+#include "ProcessorImpl.h"
+#include "Acia.h"
+#include "Coverage.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+template class BasicProcessor<CoverageHooks>;
+
+static const unsigned long long TRAP_CHECK_INTERVAL = 16; //instructions run between trap checks, so a trap is found at most this many instructions after it is entered
+
+//the build of the emulator is part of every cache key, so results from another build are never reused. By default that's a hash of the running executable,
+//which changes with any source file that goes into it (the core's .cpp files as much as this one), a release build can pass a version of its own instead
+//(/D ROMRUNNER_BUILD_ID="\"1.2.3\"")
+
+static const char CACHE_MAGIC[8] = { '6', '5', '0', '2', 'R', 'E', 'S', 1 };
+
+/// <summary>
+/// Enum for how a suite ended
+/// </summary>
+enum SUITE_RESULT {
+	SUITE_PASS, SUITE_FAIL, SUITE_JAMMED, SUITE_TIMEOUT, SUITE_LOAD_ERROR
+};
+
+struct Suite {
+	std::string path;
+	unsigned short load_address;
+	unsigned short start_address;
+	unsigned short success_address;
+	std::string input_path; //empty for no input script
+};
+
+struct SuiteReport {
+	SUITE_RESULT result;
+	unsigned short final_pc; //where the trap (or jam) happened
+	unsigned long long instructions;
+	double seconds;
+	bool cached;
+};
+
+struct RunOptions {
+	unsigned long long max_instructions;
+	int acia_page; //-1 when there's no ACIA
+	std::string cache_directory; //empty for no cache
+	unsigned long long build_hash; //identifies this build of the emulator in cache keys, see build_hash
+	bool coverage;
+};
+
+/// <summary>
+/// Parses a suite spec of the form path[:load[:start[:success]]][@input], the path itself may contain a drive letter on Windows (C:\...) so the fields are taken from the right
+/// </summary>
+static bool parse_suite(const std::string& spec, Suite& suite) {
+	suite.path = spec;
+	suite.load_address = 0x0000;
+	suite.start_address = 0x0400;
+	suite.success_address = 0x3469;
+	suite.input_path.clear();
+
+	std::string rest = spec;
+	size_t at = rest.rfind('@');
+	if (at != std::string::npos) {
+		suite.input_path = rest.substr(at + 1);
+		rest = rest.substr(0, at);
+		if (suite.input_path.empty()) {
+			return false;
+		}
+	}
+
+	std::vector<std::string> fields;
+	while (fields.size() < 3) {
+		size_t colon = rest.rfind(':');
+		if (colon == std::string::npos) {
+			break;
+		}
+		std::string field = rest.substr(colon + 1);
+		if (field.empty() || field.size() > 4 || field.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+			break; //not an address, so this colon belongs to the path
+		}
+		fields.insert(fields.begin(), field);
+		rest = rest.substr(0, colon);
+	}
+	suite.path = rest;
+	if (fields.size() > 0) {
+		suite.load_address = (unsigned short)strtoul(fields[0].c_str(), nullptr, 16);
+	}
+	if (fields.size() > 1) {
+		suite.start_address = (unsigned short)strtoul(fields[1].c_str(), nullptr, 16);
+	}
+	if (fields.size() > 2) {
+		suite.success_address = (unsigned short)strtoul(fields[2].c_str(), nullptr, 16);
+	}
+	return !suite.path.empty();
+}
+
+static bool read_file(const std::string& path, std::vector<unsigned char>& contents) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+template <typename Cpu>
+static unsigned short get_pc(Cpu& cpu) {
+	return (unsigned short)((cpu.get_pc_high() << 8) | cpu.get_pc_low());
+}
+
+/// <summary>
+/// FNV-1a, the same hash Lockstep compares states with, fed piece by piece
+/// </summary>
+static void hash_bytes(unsigned long long& hash, const void* data, size_t count) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < count; i++) {
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+}
+
+/// <summary>
+/// The cache key of a suite, everything that can change its outcome goes in, each piece with its length in front so two inputs can't run together into the same bytes
+/// </summary>
+static unsigned long long suite_key(const Suite& suite, const std::vector<unsigned char>& image, const std::vector<unsigned char>& input, const RunOptions& options) {
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned long long sizes[2] = { image.size(), input.size() };
+	//whether there's an ACIA gets a byte of its own, so no ACIA and an ACIA at page 0 don't share a key
+	unsigned char fields[8] = { (unsigned char)(suite.load_address >> 8), (unsigned char)suite.load_address, (unsigned char)(suite.start_address >> 8), (unsigned char)suite.start_address,
+		(unsigned char)(suite.success_address >> 8), (unsigned char)suite.success_address, (unsigned char)(options.acia_page >= 0 ? 1 : 0), (unsigned char)(options.acia_page >= 0 ? options.acia_page : 0) };
+	hash_bytes(hash, &options.build_hash, sizeof(options.build_hash));
+	hash_bytes(hash, &sizes[0], sizeof(sizes[0]));
+	hash_bytes(hash, image.data(), image.size());
+	hash_bytes(hash, &sizes[1], sizeof(sizes[1]));
+	hash_bytes(hash, input.data(), input.size());
+	hash_bytes(hash, fields, sizeof(fields));
+	hash_bytes(hash, &options.max_instructions, sizeof(options.max_instructions));
+	return hash;
+}
+
+/// <summary>
+/// Works out what identifies this build in cache keys, the hash of ROMRUNNER_BUILD_ID when a build passes one, the hash of the executable's own file otherwise
+/// </summary>
+/// <param name="argv0">the program's argv[0], the path used where the system can't say where the executable is</param>
+/// <returns>false if the executable couldn't be read</returns>
+static bool build_hash(const char* argv0, unsigned long long& hash) {
+	hash = 14695981039346656037ULL;
+#ifdef ROMRUNNER_BUILD_ID
+	hash_bytes(hash, ROMRUNNER_BUILD_ID, strlen(ROMRUNNER_BUILD_ID));
+	return true;
+#else
+	std::string path = argv0;
+#ifdef _WIN32
+	char module[MAX_PATH];
+	DWORD length = GetModuleFileNameA(nullptr, module, MAX_PATH);
+	if (length > 0 && length < MAX_PATH) {
+		path.assign(module, length);
+	}
+#else
+	std::error_code error;
+	if (std::filesystem::exists("/proc/self/exe", error)) {
+		path = "/proc/self/exe";
+	}
+#endif
+	std::vector<unsigned char> executable;
+	if (!read_file(path, executable) || executable.empty()) {
+		return false;
+	}
+	hash_bytes(hash, executable.data(), executable.size());
+	return true;
+#endif
+}
+
+static std::filesystem::path cache_entry(const RunOptions& options, unsigned long long key) {
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.result", key);
+	return std::filesystem::path(options.cache_directory) / name;
+}
+
+/// <summary>
+/// Reads the verdict back out of a cache entry, the final state after it is left alone
+/// </summary>
+/// <returns>false if there's no entry or it isn't one</returns>
+static bool read_cache(const std::filesystem::path& path, SuiteReport& report) {
+	std::ifstream file(path, std::ios::binary);
+	unsigned char header[19];
+	if (!file.is_open() || !file.read((char*)header, sizeof(header)) || !std::equal(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC), (const char*)header)) {
+		return false;
+	}
+	if (header[8] > SUITE_TIMEOUT) {
+		return false;
+	}
+	report.result = (SUITE_RESULT)header[8];
+	report.final_pc = (unsigned short)(header[9] | (header[10] << 8));
+	report.instructions = 0;
+	for (int i = 0; i < 8; i++) {
+		report.instructions |= (unsigned long long)header[11 + i] << (i * 8);
+	}
+	report.seconds = 0.0;
+	report.cached = true;
+	return true;
+}
+
+/// <summary>
+/// Writes a cache entry: the magic, the verdict, final pc and instruction count, then the final registers and the RAM (little endian throughout).
+/// It goes to a file of its own first and is renamed into place, a rename within a directory replaces the name in one go, so readers see all of an entry or none of it
+/// </summary>
+static void write_cache(const std::filesystem::path& path, const SuiteReport& report, const ProcessorSnapshot& state) {
+	std::vector<unsigned char> entry(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC));
+	entry.push_back((unsigned char)report.result);
+	entry.push_back((unsigned char)report.final_pc);
+	entry.push_back((unsigned char)(report.final_pc >> 8));
+	for (int i = 0; i < 8; i++) {
+		entry.push_back((unsigned char)(report.instructions >> (i * 8)));
+	}
+	unsigned char registers[12] = { state.pc_high, state.pc_low, state.a, state.x, state.y, state.sp, state.status, (unsigned char)(state.jammed ? 1 : 0),
+		(unsigned char)state.ram.size(), (unsigned char)(state.ram.size() >> 8), (unsigned char)(state.ram.size() >> 16), (unsigned char)(state.ram.size() >> 24) };
+	entry.insert(entry.end(), registers, registers + sizeof(registers));
+	entry.insert(entry.end(), state.ram.begin(), state.ram.end());
+
+	std::error_code error;
+	std::filesystem::path temporary = path;
+	temporary += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary);
+		if (!file.is_open() || !file.write((const char*)entry.data(), entry.size())) {
+			std::filesystem::remove(temporary, error);
+			return; //no cache entry is fine, the suite just runs again next time
+		}
+	}
+	std::filesystem::rename(temporary, path, error);
+	if (error) {
+		std::filesystem::remove(temporary, error);
+	}
+}
+
+/// <summary>
+/// Runs a loaded suite until it traps, jams, or runs out of instructions, on a processor with the given hooks policy, and copies out the final state
+/// </summary>
+template <typename Hooks>
+static SuiteReport run_suite(const Suite& suite, const std::vector<unsigned char>& image, const std::vector<unsigned char>& input, const RunOptions& options,
+	BasicProcessor<Hooks>& cpu, ProcessorSnapshot& final_state) {
+	SuiteReport report;
+	report.result = SUITE_TIMEOUT;
+	report.final_pc = 0x0000;
+	report.instructions = 0;
+	report.seconds = 0.0;
+	report.cached = false;
+
+	cpu.load_program(image.data(), (unsigned int)image.size(), suite.load_address);
+	cpu.set_pc((suite.start_address >> 8) & 0xFF, suite.start_address & 0xFF);
+
+	//the input script goes in a receive buffer's worth at a time, topped up between batches, and whatever the guest transmits is thrown away so it never blocks on a full buffer
+	Acia acia;
+	size_t input_sent = 0;
+	unsigned char transmitted[Acia::BUFFER_SIZE];
+	if (options.acia_page >= 0) {
+		cpu.map_device((unsigned char)options.acia_page, &acia);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (report.instructions < options.max_instructions) {
+		if (input_sent < input.size()) {
+			input_sent += acia.send(input.data() + input_sent, (unsigned int)(input.size() - input_sent));
+		}
+		report.instructions += cpu.run(TRAP_CHECK_INTERVAL);
+		acia.receive(transmitted, sizeof(transmitted));
+		if (cpu.is_jammed()) {
+			report.result = SUITE_JAMMED;
+			break;
+		}
+
+		//a trap is an instruction that leaves the program counter where it was
+		unsigned short pc = get_pc(cpu);
+		cpu.step();
+		report.instructions++;
+		if (cpu.is_jammed()) {
+			report.result = SUITE_JAMMED;
+			break;
+		}
+		if (get_pc(cpu) == pc) {
+			report.result = (pc == suite.success_address) ? SUITE_PASS : SUITE_FAIL;
+			break;
+		}
+	}
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	report.final_pc = get_pc(cpu);
+	if (options.acia_page >= 0) {
+		cpu.unmap_device((unsigned char)options.acia_page);
+	}
+	cpu.save_snapshot(final_state);
+	return report;
+}
+
+/// <summary>
+/// Loads a suite and gets its result, from the cache when it's there, otherwise by running it (and then storing it in the cache)
+/// </summary>
+static SuiteReport run_suite(const Suite& suite, const RunOptions& options, CoverageMap* coverage) {
+	SuiteReport report;
+	report.result = SUITE_LOAD_ERROR;
+	report.final_pc = 0x0000;
+	report.instructions = 0;
+	report.seconds = 0.0;
+	report.cached = false;
+
+	std::vector<unsigned char> image;
+	std::vector<unsigned char> input;
+	if (!read_file(suite.path, image) || (!suite.input_path.empty() && !read_file(suite.input_path, input))) {
+		return report;
+	}
+	if (!input.empty() && options.acia_page < 0) {
+		return report; //nowhere to send it
+	}
+
+	std::filesystem::path entry;
+	if (!options.cache_directory.empty()) {
+		entry = cache_entry(options, suite_key(suite, image, input, options));
+		if (coverage == nullptr && read_cache(entry, report)) {
+			return report;
+		}
+	}
+
+	ProcessorSnapshot final_state;
+	if (coverage == nullptr) {
+		Processor cpu((unsigned int)65536);
+		report = run_suite(suite, image, input, options, cpu, final_state);
+	}
+	else {
+		BasicProcessor<CoverageHooks> cpu((unsigned int)65536); //the coverage bitmaps live in the map's vectors, so this is no bigger on the stack than a plain Processor
+		report = run_suite(suite, image, input, options, cpu, final_state);
+		coverage->merge(cpu.get_hooks().coverage());
+	}
+	if (!entry.empty()) {
+		write_cache(entry, report, final_state);
+	}
+	return report;
+}
+
+/// <summary>
+/// Shared state between the worker threads, suites are claimed through next_suite so the threads balance themselves, each thread keeps its own coverage
+/// and ORs it into the shared map when it runs out of suites
+/// </summary>
+struct RunnerShared {
+	std::vector<Suite> suites;
+	std::vector<SuiteReport> reports;
+	std::atomic<size_t> next_suite;
+	RunOptions options;
+	CoverageMap coverage;
+	std::mutex coverage_lock;
+};
+
+static void worker(RunnerShared* shared) {
+	CoverageMap coverage;
+	size_t index;
+	while ((index = shared->next_suite.fetch_add(1)) < shared->suites.size()) {
+		shared->reports[index] = run_suite(shared->suites[index], shared->options, shared->options.coverage ? &coverage : nullptr);
+	}
+	if (shared->options.coverage) {
+		std::lock_guard<std::mutex> guard(shared->coverage_lock);
+		shared->coverage.merge(coverage);
+	}
+}
+
+static const char* result_name(SUITE_RESULT result) {
+	switch (result) {
+	case SUITE_PASS:
+		return "PASS";
+	case SUITE_FAIL:
+		return "FAIL";
+	case SUITE_JAMMED:
+		return "JAMMED";
+	case SUITE_TIMEOUT:
+		return "TIMEOUT";
+	default:
+		return "LOAD ERROR";
+	}
+}
+
+int main(int argc, char** argv) {
+	RunnerShared shared;
+	shared.options.max_instructions = 200000000ULL; //the functional test needs roughly 30 million, so this leaves plenty of room
+	shared.options.acia_page = -1;
+	shared.options.coverage = false;
+	shared.options.build_hash = 0;
+	std::vector<std::string> specs;
+	const char* coverage_path = nullptr;
+	unsigned int threads = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			shared.options.max_instructions = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+			std::ifstream list(argv[++i]);
+			if (!list.is_open()) {
+				fprintf(stderr, "romrunner: could not read %s\n", argv[i]);
+				return 2;
+			}
+			std::string line;
+			while (std::getline(list, line)) {
+				while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+					line.pop_back();
+				}
+				if (!line.empty() && line[0] != '#') {
+					specs.push_back(line);
+				}
+			}
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threads = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+			shared.options.cache_directory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--acia") == 0 && i + 1 < argc) {
+			shared.options.acia_page = (int)(strtoul(argv[++i], nullptr, 16) & 0xFF);
+		}
+		else if (strcmp(argv[i], "--coverage") == 0 && i + 1 < argc) {
+			coverage_path = argv[++i];
+			shared.options.coverage = true;
+		}
+		else if (argv[i][0] == '-') {
+			specs.clear();
+			break;
+		}
+		else {
+			specs.push_back(argv[i]);
+		}
+	}
+	if (specs.empty()) {
+		fprintf(stderr, "usage: romrunner [--max <instructions>] [--list <file>] [--threads <n>] [--cache <directory>] [--acia <page>] [--coverage <file>] <path>[:<load>[:<start>[:<success>]]][@<input>]...\n");
+		return 2;
+	}
+
+	for (size_t i = 0; i < specs.size(); i++) {
+		Suite suite;
+		if (!parse_suite(specs[i], suite)) {
+			fprintf(stderr, "romrunner: bad suite spec %s\n", specs[i].c_str());
+			return 2;
+		}
+		if (!suite.input_path.empty() && shared.options.acia_page < 0) {
+			fprintf(stderr, "romrunner: %s has an input script but there's no --acia page to send it through\n", specs[i].c_str());
+			return 2;
+		}
+		shared.suites.push_back(suite);
+	}
+	if (!shared.options.cache_directory.empty()) {
+		std::error_code error;
+		std::filesystem::create_directories(shared.options.cache_directory, error);
+		if (!std::filesystem::is_directory(shared.options.cache_directory, error)) {
+			fprintf(stderr, "romrunner: could not create the cache directory %s\n", shared.options.cache_directory.c_str());
+			return 2;
+		}
+		if (!build_hash(argv[0], shared.options.build_hash)) {
+			fprintf(stderr, "romrunner: could not read the executable to tell this build's cache entries apart\n");
+			return 2;
+		}
+	}
+
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+		if (threads == 0) {
+			threads = 1;
+		}
+	}
+	if (threads > shared.suites.size()) {
+		threads = (unsigned int)shared.suites.size();
+	}
+	shared.reports.resize(shared.suites.size());
+	shared.next_suite.store(0);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < threads; i++) {
+		pool.push_back(std::thread(worker, &shared));
+	}
+	for (size_t i = 0; i < pool.size(); i++) {
+		pool[i].join();
+	}
+	double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int failures = 0;
+	int cached = 0;
+	unsigned long long total_instructions = 0;
+	double total_seconds = 0.0;
+	printf("%-40s %-10s %6s %14s %10s %8s\n", "suite", "result", "pc", "instructions", "seconds", "MIPS");
+	for (size_t i = 0; i < shared.suites.size(); i++) {
+		const Suite& suite = shared.suites[i];
+		const SuiteReport& report = shared.reports[i];
+		if (report.cached) {
+			printf("%-40s %-10s  $%04X %14llu %10s %8s\n", suite.path.c_str(), result_name(report.result), report.final_pc, report.instructions, "cached", "-");
+			cached++;
+		}
+		else {
+			double mips = report.seconds > 0.0 ? (double)report.instructions / report.seconds / 1000000.0 : 0.0;
+			printf("%-40s %-10s  $%04X %14llu %10.3f %8.2f\n", suite.path.c_str(), result_name(report.result), report.final_pc, report.instructions, report.seconds, mips);
+			total_instructions += report.instructions;
+			total_seconds += report.seconds;
+		}
+		if (report.result != SUITE_PASS) {
+			failures++;
+		}
+	}
+	if (shared.suites.size() > 1) {
+		//MIPS is per thread, from the time spent running, the wall time is what the whole run took on all threads
+		printf("%d of %d suites passed (%d from the cache), %llu instructions in %.3f s (%.2f MIPS per thread), %.3f s on %u thread%s\n", (int)shared.suites.size() - failures,
+			(int)shared.suites.size(), cached, total_instructions, total_seconds, total_seconds > 0.0 ? (double)total_instructions / total_seconds / 1000000.0 : 0.0, wall_seconds, threads, threads == 1 ? "" : "s");
+	}
+	if (coverage_path != nullptr) {
+		if (!shared.coverage.save(coverage_path)) {
+			fprintf(stderr, "romrunner: could not write %s\n", coverage_path);
+			return 2;
+		}
+		printf("%u instruction addresses executed, coverage saved to %s\n", shared.coverage.count_executed(), coverage_path);
+	}
+	return failures > 0 ? 1 : 0;
+}
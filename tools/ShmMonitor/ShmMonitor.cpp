@@ -0,0 +1,143 @@
+// ShmMonitor.cpp : watches a running emulator through its shared mapping (see SharedState), without any calls into the emulator process
+//
+// Samples the published registers at a fixed rate and prints one line per sample (only when something changed) with the instruction at the program counter,
+// and optionally a window of RAM.
+// With --histogram it only samples, quietly, and prints the program counters seen most often at the end, a cheap profile of whatever the emulator is running.
+// The emulator publishes between batches of instructions, so the program counter seen is where the last batch ended, which is coarse for a tight loop.
+//
+// usage: shmmonitor [--name <name>] [--hz <samples per second>] [--count <samples>] [--ram <address> <length>] [--histogram <top>]
+//   name defaults to 6502Sim (what the GUI creates), address and length in hex, count 0 (the default) samples until interrupted
+
+#include "SharedState.h"
+#include "MemoryDump.h"
+#include "Disassembler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Disassembles the instruction at an address in the mapped ROM (which is the RAM for a unified memory), read straight out of the mapping
+/// </summary>
+static void disassemble_at(const SharedState& shared, unsigned short address, char* text) {
+	unsigned int rom_size = shared.header()->rom_size;
+	unsigned char bytes[3] = { 0, 0, 0 };
+	for (unsigned int i = 0; i < 3 && rom_size > 0; i++) {
+		bytes[i] = shared.rom()[(address + i) % rom_size];
+	}
+	Disassembler<char>::disassemble(address, bytes, text);
+}
+
+int main(int argc, char** argv) {
+	const char* name = "6502Sim";
+	double hz = 10.0;
+	unsigned long long count = 0;
+	unsigned int ram_address = 0;
+	unsigned int ram_length = 0;
+	unsigned int histogram_top = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		}
+		else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+			hz = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+			count = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--ram") == 0 && i + 2 < argc) {
+			ram_address = (unsigned int)strtoul(argv[++i], nullptr, 16);
+			ram_length = (unsigned int)strtoul(argv[++i], nullptr, 16);
+		}
+		else if (strcmp(argv[i], "--histogram") == 0 && i + 1 < argc) {
+			histogram_top = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			fprintf(stderr, "usage: shmmonitor [--name <name>] [--hz <samples per second>] [--count <samples>] [--ram <address> <length>] [--histogram <top>]\n");
+			return 2;
+		}
+	}
+	if (hz <= 0.0) {
+		hz = 1.0;
+	}
+
+	SharedState shared;
+	if (!shared.open(name)) {
+		fprintf(stderr, "shmmonitor: no emulator mapping named %s\n", name);
+		return 1;
+	}
+	unsigned int ram_size = shared.header()->ram_size;
+	if (ram_address >= ram_size) {
+		ram_length = 0;
+	}
+	else if (ram_length > ram_size - ram_address) {
+		ram_length = ram_size - ram_address;
+	}
+
+	DumpLayout layout;
+	layout.format = DUMP_HEX;
+	layout.bytes_per_row = 16;
+	layout.show_address = true;
+	layout.crlf = false;
+	std::vector<unsigned char> snapshot(ram_size);
+	std::vector<char> text;
+	char text_line[Disassembler<char>::MAX_TEXT];
+
+	std::vector<unsigned long long> pc_hits(histogram_top > 0 ? 65536 : 0, 0);
+	std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / hz));
+	std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+	uint32_t last_sequence = 0xFFFFFFFF;
+	unsigned long long samples = 0;
+	unsigned long long missed = 0;
+	while (count == 0 || samples < count) {
+		SharedRegisters registers;
+		if (!shared.read_registers(registers)) {
+			missed++;
+		}
+		else if (histogram_top > 0) {
+			pc_hits[registers.pc]++;
+		}
+		else if (registers.sequence != last_sequence) {
+			disassemble_at(shared, registers.pc, text_line);
+			printf("pc $%04X  %-12s a $%02X  x $%02X  y $%02X  sp $%02X  p $%02X  instructions %llu  cycles %llu%s\n", registers.pc, text_line, registers.a, registers.x, registers.y,
+				registers.sp, registers.status, (unsigned long long)registers.instructions, (unsigned long long)registers.cycles, registers.jammed ? "  JAMMED" : "");
+			if (ram_length > 0) {
+				//copy first so the dump is of one moment (or close to it, the emulator keeps writing while this copies), then render the rows covering the window
+				memcpy(snapshot.data(), shared.ram(), ram_size);
+				unsigned int first_row = ram_address / layout.bytes_per_row;
+				unsigned int rows = MemoryDump<char>::row_count(layout, ram_address + ram_length) - first_row;
+				text.resize(rows * MemoryDump<char>::row_length(layout) + 1);
+				MemoryDump<char>::render_rows(snapshot.data(), ram_size, layout, first_row, rows, text.data());
+				fputs(text.data(), stdout);
+			}
+			fflush(stdout);
+			last_sequence = registers.sequence;
+		}
+		samples++;
+		next += period;
+		std::this_thread::sleep_until(next);
+	}
+
+	if (histogram_top > 0) {
+		std::vector<unsigned int> order;
+		for (unsigned int pc = 0; pc < 65536; pc++) {
+			if (pc_hits[pc] > 0) {
+				order.push_back(pc);
+			}
+		}
+		std::sort(order.begin(), order.end(), [&pc_hits](unsigned int left, unsigned int right) { return pc_hits[left] > pc_hits[right]; });
+		printf("%-8s %12s %8s  %s\n", "pc", "samples", "share", "instruction");
+		for (size_t i = 0; i < order.size() && i < histogram_top; i++) {
+			disassemble_at(shared, (unsigned short)order[i], text_line);
+			printf("$%04X    %12llu %7.2f%%  %s\n", order[i], pc_hits[order[i]], 100.0 * (double)pc_hits[order[i]] / (double)(samples - missed), text_line);
+		}
+	}
+	if (missed > 0) {
+		fprintf(stderr, "shmmonitor: %llu samples missed (the writer kept the page busy)\n", missed);
+	}
+	return 0;
+}
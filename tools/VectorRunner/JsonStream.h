@@ -0,0 +1,225 @@
+#pragma once
+#include <cstdio>
+#include <string>
+
+/// <summary>
+/// A small pull style JSON reader that works straight off a file in fixed size chunks, the caller walks the structure it expects
+/// (begin_object/next_key/read_int and so on) and skips anything else with skip_value, so nothing is ever built up in memory besides the current chunk
+/// it only understands as much JSON as the test vector files use: objects, arrays, strings with simple escapes, integers, true/false/null
+/// </summary>
+class JsonStream
+{
+private:
+	static const size_t CHUNK_SIZE = 1 << 16;
+
+	FILE* _file;
+	char _buffer[CHUNK_SIZE];
+	size_t _pos;
+	size_t _len;
+	bool _error;
+
+	bool fill() {
+		if (_file == nullptr) {
+			return false;
+		}
+		_len = fread(_buffer, 1, CHUNK_SIZE, _file);
+		_pos = 0;
+		return _len > 0;
+	}
+
+	int peek() {
+		if (_pos == _len && !fill()) {
+			return -1;
+		}
+		return (unsigned char)_buffer[_pos];
+	}
+
+	int get() {
+		int c = peek();
+		if (c >= 0) {
+			_pos++;
+		}
+		return c;
+	}
+
+	void skip_whitespace() {
+		int c;
+		while ((c = peek()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+			_pos++;
+		}
+	}
+
+	bool expect(char c) {
+		skip_whitespace();
+		if (get() != c) {
+			_error = true;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	explicit JsonStream(const char* path) : _pos(0), _len(0), _error(false) {
+		_file = fopen(path, "rb");
+		_error = _file == nullptr;
+	}
+
+	~JsonStream() {
+		if (_file != nullptr) {
+			fclose(_file);
+		}
+	}
+
+	bool ok() const {
+		return !_error;
+	}
+
+	bool begin_array() {
+		return expect('[');
+	}
+
+	bool begin_object() {
+		return expect('{');
+	}
+
+	/// <summary>
+	/// Moves to the next element of the array being read, returns false at the closing bracket (which gets consumed)
+	/// call it before every element, including the first
+	/// </summary>
+	bool next_element() {
+		skip_whitespace();
+		int c = peek();
+		if (c == ']') {
+			_pos++;
+			return false;
+		}
+		if (c == ',') {
+			_pos++;
+		}
+		if (c < 0) {
+			_error = true;
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Reads the next key of the object being read into key (and the colon after it), returns false at the closing brace (which gets consumed)
+	/// </summary>
+	bool next_key(std::string& key) {
+		skip_whitespace();
+		int c = peek();
+		if (c == '}') {
+			_pos++;
+			return false;
+		}
+		if (c == ',') {
+			_pos++;
+		}
+		if (!read_string(key)) {
+			return false;
+		}
+		return expect(':');
+	}
+
+	bool read_string(std::string& out) {
+		out.clear();
+		if (!expect('"')) {
+			return false;
+		}
+		int c;
+		while ((c = get()) != '"') {
+			if (c < 0) {
+				_error = true;
+				return false;
+			}
+			if (c == '\\') {
+				c = get();
+				switch (c) {
+				case 'n':
+					c = '\n';
+					break;
+				case 't':
+					c = '\t';
+					break;
+				case 'r':
+					c = '\r';
+					break;
+				case 'u':
+					//\uXXXX never shows up in the test files, keep it as a placeholder rather than decoding it
+					for (int i = 0; i < 4; i++) {
+						get();
+					}
+					c = '?';
+					break;
+				default:
+					break; //\" \\ \/ are just the character itself
+				}
+			}
+			out.push_back((char)c);
+		}
+		return true;
+	}
+
+	bool read_int(long long& out) {
+		skip_whitespace();
+		bool negative = false;
+		if (peek() == '-') {
+			negative = true;
+			_pos++;
+		}
+		int c = peek();
+		if (c < '0' || c > '9') {
+			_error = true;
+			return false;
+		}
+		long long value = 0;
+		while ((c = peek()) >= '0' && c <= '9') {
+			value = value * 10 + (c - '0');
+			_pos++;
+		}
+		out = negative ? -value : value;
+		return true;
+	}
+
+	/// <summary>
+	/// Skips over whatever value comes next, however deeply nested
+	/// </summary>
+	bool skip_value() {
+		skip_whitespace();
+		int c = peek();
+		if (c == '"') {
+			std::string dummy;
+			return read_string(dummy);
+		}
+		if (c == '{' || c == '[') {
+			int depth = 0;
+			do {
+				c = get();
+				if (c < 0) {
+					_error = true;
+					return false;
+				}
+				if (c == '"') {
+					_pos--;
+					std::string dummy;
+					if (!read_string(dummy)) {
+						return false;
+					}
+				}
+				else if (c == '{' || c == '[') {
+					depth++;
+				}
+				else if (c == '}' || c == ']') {
+					depth--;
+				}
+			} while (depth > 0);
+			return true;
+		}
+		//number or literal, runs until the next delimiter
+		while ((c = peek()) >= 0 && c != ',' && c != '}' && c != ']' && c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+			_pos++;
+		}
+		return true;
+	}
+};
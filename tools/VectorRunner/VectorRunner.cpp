@@ -0,0 +1,335 @@
+// VectorRunner.cpp : single step test vector runner for the ProcessorTests JSON format (https://github.com/SingleStepTests/ProcessorTests, 6502 directory)
+//
+// Every file is an array of tests, each with an initial state, the expected final state and the bus cycles. The runner streams each file through
+// JsonStream (nothing is kept besides the test being run), puts the Processor into the initial state, steps once, and diffs registers and the listed RAM.
+// Files are handed out to one worker thread per core. The Processor doesn't model bus cycles, so the cycle lists are skipped, only their length is reported on a diff.
+//
+// usage: vectorrunner [--threads <n>] [--max-failures <n>] [--include-illegal] <file or directory>...
+
+#include "JsonStream.h"
+#include "Processor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// CPU state as given in the test files
+/// </summary>
+struct VectorState {
+	long long pc, s, a, x, y, p;
+	std::vector<std::pair<unsigned short, unsigned char>> ram;
+};
+
+struct VectorTest {
+	std::string name;
+	VectorState initial;
+	VectorState final;
+	long long cycles;
+};
+
+struct FileResult {
+	std::string path;
+	unsigned long long passed;
+	unsigned long long failed;
+	bool parse_error;
+};
+
+struct RunnerOptions {
+	unsigned int threads = 0;
+	unsigned int max_failures = 10; //number of failing tests to print in detail, across all files
+	bool include_illegal = false;
+};
+
+static bool read_state(JsonStream& json, VectorState& state) {
+	state.ram.clear();
+	if (!json.begin_object()) {
+		return false;
+	}
+	std::string key;
+	while (json.next_key(key)) {
+		bool ok;
+		if (key == "pc") {
+			ok = json.read_int(state.pc);
+		}
+		else if (key == "s") {
+			ok = json.read_int(state.s);
+		}
+		else if (key == "a") {
+			ok = json.read_int(state.a);
+		}
+		else if (key == "x") {
+			ok = json.read_int(state.x);
+		}
+		else if (key == "y") {
+			ok = json.read_int(state.y);
+		}
+		else if (key == "p") {
+			ok = json.read_int(state.p);
+		}
+		else if (key == "ram") {
+			ok = json.begin_array();
+			while (ok && json.next_element()) {
+				long long addr, value;
+				ok = json.begin_array() && json.next_element() && json.read_int(addr) && json.next_element() && json.read_int(value);
+				ok = ok && !json.next_element(); //closing bracket of the pair
+				state.ram.push_back(std::make_pair((unsigned short)addr, (unsigned char)value));
+			}
+		}
+		else {
+			ok = json.skip_value();
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+	return json.ok();
+}
+
+/// <summary>
+/// Reads the next test from the array, returns false at the end of the array or on a parse error (check json.ok() to tell them apart)
+/// </summary>
+static bool read_test(JsonStream& json, VectorTest& test) {
+	if (!json.next_element()) {
+		return false;
+	}
+	if (!json.begin_object()) {
+		return false;
+	}
+	test.cycles = 0;
+	std::string key;
+	while (json.next_key(key)) {
+		bool ok;
+		if (key == "name") {
+			ok = json.read_string(test.name);
+		}
+		else if (key == "initial") {
+			ok = read_state(json, test.initial);
+		}
+		else if (key == "final") {
+			ok = read_state(json, test.final);
+		}
+		else if (key == "cycles") {
+			//count the entries without looking inside them
+			ok = json.begin_array();
+			while (ok && json.next_element()) {
+				ok = json.skip_value();
+				test.cycles++;
+			}
+		}
+		else {
+			ok = json.skip_value();
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+	return json.ok();
+}
+
+static void apply_state(Processor& cpu, const VectorState& state) {
+	for (size_t i = 0; i < state.ram.size(); i++) {
+		cpu.set_ram_value((state.ram[i].first >> 8) & 0xFF, state.ram[i].first & 0xFF, state.ram[i].second);
+	}
+	cpu.set_registers((unsigned char)state.a, (unsigned char)state.x, (unsigned char)state.y, (unsigned char)state.s);
+	cpu.set_status((unsigned char)state.p);
+	cpu.set_pc((unsigned char)((state.pc >> 8) & 0xFF), (unsigned char)(state.pc & 0xFF));
+}
+
+/// <summary>
+/// Compares the processor against the expected final state, describing every difference in diff, returns true if they match
+/// </summary>
+static bool compare_state(Processor& cpu, const VectorState& expected, std::string& diff) {
+	char line[96];
+	diff.clear();
+	long long pc = (cpu.get_pc_high() << 8) | cpu.get_pc_low();
+	struct {
+		const char* name;
+		long long actual;
+		long long expected;
+		int width;
+	} registers[] = {
+		{ "pc", pc, expected.pc, 4 },
+		{ "s", cpu.get_sp(), expected.s, 2 },
+		{ "a", cpu.get_accumulator(), expected.a, 2 },
+		{ "x", cpu.get_x(), expected.x, 2 },
+		{ "y", cpu.get_y(), expected.y, 2 },
+		{ "p", cpu.get_status(), expected.p, 2 },
+	};
+	for (size_t i = 0; i < sizeof(registers) / sizeof(registers[0]); i++) {
+		if (registers[i].actual != registers[i].expected) {
+			snprintf(line, sizeof(line), "    %-2s expected $%0*llX got $%0*llX\n", registers[i].name, registers[i].width, registers[i].expected, registers[i].width, registers[i].actual);
+			diff += line;
+		}
+	}
+	for (size_t i = 0; i < expected.ram.size(); i++) {
+		unsigned short addr = expected.ram[i].first;
+		unsigned char actual = cpu.get_ram_value((addr >> 8) & 0xFF, addr & 0xFF);
+		if (actual != expected.ram[i].second) {
+			snprintf(line, sizeof(line), "    [$%04X] expected $%02X got $%02X\n", addr, expected.ram[i].second, actual);
+			diff += line;
+		}
+	}
+	return diff.empty();
+}
+
+/// <summary>
+/// Shared state between the worker threads, files are claimed through next_file so the threads balance themselves
+/// </summary>
+struct RunnerShared {
+	std::vector<std::string> files;
+	std::vector<FileResult> results;
+	std::atomic<size_t> next_file;
+	std::atomic<unsigned int> failures_printed;
+	std::mutex print_lock;
+	RunnerOptions options;
+};
+
+static void run_file(Processor& cpu, RunnerShared& shared, size_t index) {
+	FileResult& result = shared.results[index];
+	result.path = shared.files[index];
+	result.passed = 0;
+	result.failed = 0;
+	result.parse_error = false;
+
+	JsonStream json(result.path.c_str());
+	if (!json.begin_array()) {
+		result.parse_error = true;
+		return;
+	}
+	VectorTest test;
+	std::string diff;
+	while (read_test(json, test)) {
+		apply_state(cpu, test.initial);
+		cpu.step();
+		if (compare_state(cpu, test.final, diff)) {
+			result.passed++;
+			continue;
+		}
+		result.failed++;
+		if (shared.failures_printed.fetch_add(1) < shared.options.max_failures) {
+			std::lock_guard<std::mutex> guard(shared.print_lock);
+			printf("FAIL %s: \"%s\" (%lld bus cycles)\n%s", result.path.c_str(), test.name.c_str(), test.cycles, diff.c_str());
+		}
+	}
+	result.parse_error = !json.ok();
+}
+
+static void worker(RunnerShared* shared) {
+	Processor cpu((unsigned int)65536); //one per thread, the tests assume a flat 64K where code and data are the same memory
+	size_t index;
+	while ((index = shared->next_file.fetch_add(1)) < shared->files.size()) {
+		run_file(cpu, *shared, index);
+	}
+}
+
+/// <summary>
+/// Files in the ProcessorTests repository are named after the opcode they test ("a9.json"), so the opcode can be checked against the instruction table
+/// </summary>
+static bool is_illegal_opcode_file(Processor& cpu, const std::filesystem::path& path) {
+	std::string stem = path.stem().string();
+	if (stem.size() != 2 || stem.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+		return false; //not named after an opcode, so run it regardless
+	}
+	return cpu.get_instruction((unsigned char)strtoul(stem.c_str(), nullptr, 16)) == JAM;
+}
+
+int main(int argc, char** argv) {
+	RunnerShared shared;
+	std::vector<std::filesystem::path> inputs;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			shared.options.threads = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-failures") == 0 && i + 1 < argc) {
+			shared.options.max_failures = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--include-illegal") == 0) {
+			shared.options.include_illegal = true;
+		}
+		else if (argv[i][0] == '-') {
+			inputs.clear();
+			break;
+		}
+		else {
+			inputs.push_back(argv[i]);
+		}
+	}
+	if (inputs.empty()) {
+		fprintf(stderr, "usage: vectorrunner [--threads <n>] [--max-failures <n>] [--include-illegal] <file or directory>...\n");
+		return 2;
+	}
+
+	Processor decoder(65536, 65536); //only used to look up opcodes for the illegal opcode check
+	std::vector<std::filesystem::path> files;
+	for (size_t i = 0; i < inputs.size(); i++) {
+		std::error_code error;
+		if (std::filesystem::is_directory(inputs[i], error)) {
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(inputs[i], error)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".json") {
+					files.push_back(entry.path());
+				}
+			}
+		}
+		else {
+			files.push_back(inputs[i]);
+		}
+	}
+	std::sort(files.begin(), files.end());
+	for (size_t i = 0; i < files.size(); i++) {
+		if (shared.options.include_illegal || !is_illegal_opcode_file(decoder, files[i])) {
+			shared.files.push_back(files[i].string());
+		}
+	}
+	if (shared.files.empty()) {
+		fprintf(stderr, "vectorrunner: no test files found\n");
+		return 2;
+	}
+
+	unsigned int threads = shared.options.threads;
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+		if (threads == 0) {
+			threads = 1;
+		}
+	}
+	if (threads > shared.files.size()) {
+		threads = (unsigned int)shared.files.size();
+	}
+	shared.results.resize(shared.files.size());
+	shared.next_file.store(0);
+	shared.failures_printed.store(0);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < threads; i++) {
+		pool.push_back(std::thread(worker, &shared));
+	}
+	for (size_t i = 0; i < pool.size(); i++) {
+		pool[i].join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned long long passed = 0;
+	unsigned long long failed = 0;
+	int bad_files = 0;
+	for (size_t i = 0; i < shared.results.size(); i++) {
+		const FileResult& r = shared.results[i];
+		passed += r.passed;
+		failed += r.failed;
+		if (r.failed > 0 || r.parse_error) {
+			bad_files++;
+			printf("%-40s %8llu passed %8llu failed%s\n", r.path.c_str(), r.passed, r.failed, r.parse_error ? " (parse error)" : "");
+		}
+	}
+	printf("%llu of %llu vectors passed in %zu files (%d with failures), %.3f s on %u threads (%.0f vectors/s)\n", passed, passed + failed, shared.results.size(), bad_files, seconds, threads,
+		seconds > 0.0 ? (double)(passed + failed) / seconds : 0.0);
+	return bad_files > 0 ? 1 : 0;
+}